@@ -0,0 +1,62 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#ifndef GMATH_BENCH_H_
+#define GMATH_BENCH_H_
+
+#include <stdlib.h>
+
+/* number of times each measurement is repeated, keeping the fastest */
+#define BENCH_REPEAT	5
+
+/* results are added here, so that the compiler can't discard the work */
+extern volatile float bench_sink;
+
+// time in seconds, from an arbitrary starting point
+double get_time();
+
+/* runs func reps times, and returns the time of the fastest run in seconds */
+template <class F>
+double best_time(F func, int reps = BENCH_REPEAT)
+{
+	double best = 0.0;
+	for(int i=0; i<reps; i++) {
+		double start = get_time();
+		func();
+		double t = get_time() - start;
+		if(i == 0 || t < best) best = t;
+	}
+	return best;
+}
+
+// random number in [0, range]
+inline float frand(float range)
+{
+	return (float)rand() / (float)RAND_MAX * range;
+}
+
+/* prints the throughput of count operations done in time seconds, in millions
+ * of operations per second
+ */
+void print_rate(const char *name, double count, double time);
+/* same as above, for two implementations of the same count operations, and the
+ * speedup of the second over the first
+ */
+void print_cmp(const char *name, double count, const char *name_a, double time_a,
+		const char *name_b, double time_b);
+
+void bench_mat4();
+void bench_bvh();
+void bench_noise();
+void bench_noise4();
+void bench_bake();
+void bench_quat();
+void bench_hierarchy();
+
+#endif	// GMATH_BENCH_H_
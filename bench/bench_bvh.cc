@@ -0,0 +1,170 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "gmath.h"
+#include "bench.h"
+
+using namespace gph;
+
+#define SOUP_TRIS	100000
+#define GRID_SIZE	256
+#define NUM_RAYS	100000
+// brute force is much slower, so it's measured over fewer rays
+#define NUM_BRUTE_RAYS	200
+
+static Vec3 rand_point()
+{
+	return Vec3(frand(2.0f) - 1.0f, frand(2.0f) - 1.0f, frand(2.0f) - 1.0f);
+}
+
+// small triangles scattered randomly in [-1, 1]^3
+static void gen_soup(std::vector<Vec3> *verts, std::vector<unsigned int> *idx)
+{
+	verts->clear();
+	idx->clear();
+	for(int i=0; i<SOUP_TRIS; i++) {
+		Vec3 c = rand_point();
+		for(int j=0; j<3; j++) {
+			verts->push_back(c + rand_point() * 0.02f);
+		}
+	}
+}
+
+// indexed heightfield grid over [-1, 1]^2 in the xz plane
+static void gen_grid(std::vector<Vec3> *verts, std::vector<unsigned int> *idx)
+{
+	verts->clear();
+	idx->clear();
+	for(int i=0; i<=GRID_SIZE; i++) {
+		float z = (float)i / (float)GRID_SIZE * 2.0f - 1.0f;
+		for(int j=0; j<=GRID_SIZE; j++) {
+			float x = (float)j / (float)GRID_SIZE * 2.0f - 1.0f;
+			float y = sin(x * 7.0f) * cos(z * 5.0f) * 0.2f;
+			verts->push_back(Vec3(x, y, z));
+		}
+	}
+	for(int i=0; i<GRID_SIZE; i++) {
+		for(int j=0; j<GRID_SIZE; j++) {
+			unsigned int v = i * (GRID_SIZE + 1) + j;
+			unsigned int quad[] = {v, v + 1, v + GRID_SIZE + 2, v, v + GRID_SIZE + 2, v + GRID_SIZE + 1};
+			idx->insert(idx->end(), quad, quad + 6);
+		}
+	}
+}
+
+/* rays from random points on a sphere enclosing the scene, towards random
+ * points inside it
+ */
+static void gen_rays(std::vector<Ray> *rays)
+{
+	rays->resize(NUM_RAYS);
+	for(int i=0; i<NUM_RAYS; i++) {
+		Vec3 o = normalize(rand_point()) * 3.0f;
+		(*rays)[i] = Ray(o, rand_point() - o);
+	}
+}
+
+static bool brute_force(const Ray &ray, const Vec3 *verts, const unsigned int *idx,
+		int num_tris, float *tres)
+{
+	float tmin = 1e30f;
+	for(int i=0; i<num_tris; i++) {
+		const Vec3 &v0 = verts[idx ? idx[i * 3] : i * 3];
+		const Vec3 &v1 = verts[idx ? idx[i * 3 + 1] : i * 3 + 1];
+		const Vec3 &v2 = verts[idx ? idx[i * 3 + 2] : i * 3 + 2];
+		float t;
+		if(intersect_triangle(ray, v0, v1, v2, &t) && t < tmin) {
+			tmin = t;
+		}
+	}
+	*tres = tmin;
+	return tmin < 1e30f;
+}
+
+static void bench_scene(const char *name, const std::vector<Vec3> &verts,
+		const std::vector<unsigned int> &idx, const std::vector<Ray> &rays)
+{
+	const unsigned int *iptr = idx.empty() ? 0 : &idx[0];
+	int num_tris = idx.empty() ? (int)verts.size() / 3 : (int)idx.size() / 3;
+
+	printf("  %s, %d triangles\n", name, num_tris);
+
+	BVH bvh;
+	double tbuild1 = best_time([&]() { bvh.build(&verts[0], iptr, num_tris, 1); });
+	double tbuild = best_time([&]() { bvh.build(&verts[0], iptr, num_tris); });
+	printf("    build: %.1f ms (1 thread), %.1f ms (all threads), %d nodes\n",
+			tbuild1 * 1e3, tbuild * 1e3, bvh.get_node_count());
+
+	double trefit = best_time([&]() { bvh.refit(); });
+	printf("    refit: %.1f ms\n", trefit * 1e3);
+
+	int nhits = 0;
+	double tbrute = best_time([&]() {
+		nhits = 0;
+		for(int i=0; i<NUM_BRUTE_RAYS; i++) {
+			float t;
+			if(brute_force(rays[i], &verts[0], iptr, num_tris, &t)) {
+				nhits++;
+				bench_sink = bench_sink + t;
+			}
+		}
+	});
+
+	// make sure both agree, before comparing them
+	for(int i=0; i<NUM_BRUTE_RAYS; i++) {
+		float t;
+		RayHit hit;
+		bool bhit = brute_force(rays[i], &verts[0], iptr, num_tris, &t);
+		if(bhit != bvh.intersect(rays[i], &hit) || (bhit && fabs(hit.t - t) > 1e-4f)) {
+			printf("    BVH and brute force results differ for ray %d\n", i);
+			break;
+		}
+	}
+
+	double tclosest = best_time([&]() {
+		nhits = 0;
+		for(int i=0; i<NUM_RAYS; i++) {
+			RayHit hit;
+			if(bvh.intersect(rays[i], &hit)) {
+				nhits++;
+				bench_sink = bench_sink + hit.t;
+			}
+		}
+	});
+	double tany = best_time([&]() {
+		for(int i=0; i<NUM_RAYS; i++) {
+			if(bvh.occluded(rays[i])) {
+				bench_sink = bench_sink + 1.0f;
+			}
+		}
+	});
+	printf("    %d%% of the rays hit\n", nhits * 100 / NUM_RAYS);
+
+	print_cmp("closest hit rays", NUM_RAYS, "brute", tbrute * NUM_RAYS / NUM_BRUTE_RAYS,
+			"bvh", tclosest);
+	print_cmp("any hit rays", NUM_RAYS, "closest", tclosest, "any", tany);
+}
+
+void bench_bvh()
+{
+	std::vector<Vec3> verts;
+	std::vector<unsigned int> idx;
+	std::vector<Ray> rays;
+
+	gen_rays(&rays);
+
+	gen_soup(&verts, &idx);
+	bench_scene("random triangle soup", verts, idx, rays);
+
+	gen_grid(&verts, &idx);
+	bench_scene("indexed heightfield", verts, idx, rays);
+}
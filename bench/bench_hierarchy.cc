@@ -0,0 +1,130 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <thread>
+#include "gmath.h"
+#include "bench.h"
+
+using namespace gph;
+
+#define NUM_NODES	(1 << 17)
+#define BONES		128
+#define CHAIN_LEN	2048
+// fraction of nodes changed by each partial update
+#define PARTIAL_DIV	100
+
+static Mat3x4 rand_xform()
+{
+	Vec3 axis = normalize(Vec3(frand(1.0f) - 0.5f, frand(1.0f) - 0.5f, frand(1.0f) - 0.5f) + Vec3(0, 0, 0.01f));
+	Quat rot;
+	rot.set_rotation(axis, frand(0.2f));
+	return Mat3x4(Transform(Vec3(frand(1.0f), frand(1.0f), frand(1.0f)), rot));
+}
+
+// all nodes are roots
+static void gen_flat(TransformHierarchy *h)
+{
+	for(int i=0; i<NUM_NODES; i++) {
+		h->add_node(-1, rand_xform());
+	}
+}
+
+/* a scene root with many small random trees under it, like the skeletons of a
+ * crowd of characters. The parent of each bone is the previous bone or one of
+ * its ancestors, which is all that keeps the depth-first order.
+ */
+static void gen_crowd(TransformHierarchy *h)
+{
+	int root = h->add_node(-1, rand_xform());
+	while(h->get_node_count() < NUM_NODES) {
+		int last = h->add_node(root, rand_xform());
+		int first = last;
+		for(int i=1; i<BONES; i++) {
+			int p = last;
+			while(p != first && rand() % 3 == 0) {
+				p = h->get_parent(p);
+			}
+			last = h->add_node(p, rand_xform());
+		}
+	}
+}
+
+// a scene root with a few long chains under it
+static void gen_chains(TransformHierarchy *h)
+{
+	int root = h->add_node(-1, rand_xform());
+	while(h->get_node_count() < NUM_NODES) {
+		int p = root;
+		for(int i=0; i<CHAIN_LEN; i++) {
+			p = h->add_node(p, rand_xform());
+		}
+	}
+}
+
+static void bench_tree(const char *name, void (*gen)(TransformHierarchy*))
+{
+	TransformHierarchy h;
+	srand(0);
+	gen(&h);
+	int num = h.get_node_count();
+	h.update(1);
+
+	// the roots, which dirty the whole hierarchy
+	std::vector<int> roots;
+	for(int i=0; i<num; i++) {
+		if(h.get_parent(i) < 0) roots.push_back(i);
+	}
+	std::vector<int> partial(num / PARTIAL_DIV);
+	for(size_t i=0; i<partial.size(); i++) {
+		partial[i] = rand() % num;
+	}
+
+	// the same updates on a copy, done serially, to check the results against
+	TransformHierarchy ref = h;
+
+	printf("  %s, %d nodes\n", name, num);
+
+	for(int pass=0; pass<2; pass++) {
+		const std::vector<int> &inval = pass == 0 ? roots : partial;
+
+		double t1 = 0.0;
+		for(int nthr=1; nthr<=8; nthr*=2) {
+			double t = best_time([&]() {
+				for(size_t i=0; i<inval.size(); i++) {
+					h.invalidate(inval[i]);
+				}
+				h.update(nthr);
+			});
+			if(nthr == 1) t1 = t;
+
+			for(size_t i=0; i<inval.size(); i++) {
+				ref.invalidate(inval[i]);
+			}
+			ref.update(1);
+			bool same = memcmp(h.get_world_array(), ref.get_world_array(), num * sizeof(Mat3x4)) == 0;
+
+			printf("    %s, %d thread%s: %7.3f ms  (%.2fx)%s\n", pass == 0 ? "full" : "partial",
+					nthr, nthr > 1 ? "s" : " ", t * 1e3, t1 / t, same ? "" : "  RESULTS DIFFER");
+		}
+	}
+	bench_sink = bench_sink + h.get_world(num - 1)[3][0];
+}
+
+void bench_hierarchy()
+{
+	printf("  hardware threads: %u\n", std::thread::hardware_concurrency());
+
+	bench_tree("flat, all roots", gen_flat);
+	bench_tree("crowd, 128 bone skeletons", gen_crowd);
+	bench_tree("chains of 2048 nodes", gen_chains);
+}
@@ -0,0 +1,125 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#include <stdlib.h>
+#include <vector>
+#include "gmath.h"
+#include "bench.h"
+
+using namespace gph;
+
+#define NUM_MAT		1024
+#define MAT_ITER	256
+#define NUM_VEC		16384
+#define VEC_ITER	64
+
+/* the scalar code path of Mat4 * Mat4, as it is compiled with GPH_NO_SIMD.
+ * Copied here, so that both can be measured in the same build.
+ */
+static inline Mat4 mul_scalar(const Mat4 &a, const Mat4 &b)
+{
+	Mat4 res(noinit);
+	for(int i=0; i<4; i++) {
+		for(int j=0; j<4; j++) {
+			res.m[i][j] = a.m[i][0] * b.m[0][j] + a.m[i][1] * b.m[1][j] +
+				a.m[i][2] * b.m[2][j] + a.m[i][3] * b.m[3][j];
+		}
+	}
+	return res;
+}
+
+// same for the out of line transforms, in mat4_scalar.cc
+Vec4 xform_scalar(const Mat4 &m, const Vec4 &v);
+Vec4 xform_scalar(const Vec4 &v, const Mat4 &m);
+
+void bench_mat4()
+{
+	std::vector<Mat4> a(NUM_MAT), b(NUM_MAT), res(NUM_MAT);
+	for(int i=0; i<NUM_MAT; i++) {
+		for(int j=0; j<16; j++) {
+			a[i].m[j / 4][j % 4] = frand(2.0f) - 1.0f;
+			b[i].m[j / 4][j % 4] = frand(2.0f) - 1.0f;
+		}
+	}
+
+	std::vector<Vec4> v(NUM_VEC), vres(NUM_VEC);
+	for(int i=0; i<NUM_VEC; i++) {
+		v[i] = Vec4(frand(2.0f) - 1.0f, frand(2.0f) - 1.0f, frand(2.0f) - 1.0f, 1.0f);
+	}
+
+	/* the second operand changes with every iteration, so that no iteration
+	 * repeats the work of the previous one
+	 */
+	double tref = best_time([&]() {
+		for(int k=0; k<MAT_ITER; k++) {
+			for(int i=0; i<NUM_MAT; i++) {
+				res[i] = mul_scalar(a[i], b[(i + k) & (NUM_MAT - 1)]);
+			}
+		}
+	});
+	bench_sink = bench_sink + res[0][0][0];
+	double t = best_time([&]() {
+		for(int k=0; k<MAT_ITER; k++) {
+			for(int i=0; i<NUM_MAT; i++) {
+				res[i] = a[i] * b[(i + k) & (NUM_MAT - 1)];
+			}
+		}
+	});
+	bench_sink = bench_sink + res[0][0][0];
+	print_cmp("Mat4 * Mat4", NUM_MAT * MAT_ITER, "scalar", tref, "simd", t);
+
+	tref = best_time([&]() {
+		for(int k=0; k<VEC_ITER; k++) {
+			const Mat4 &m = a[k];
+			for(int i=0; i<NUM_VEC; i++) {
+				vres[i] = xform_scalar(m, v[i]);
+			}
+		}
+	});
+	bench_sink = bench_sink + vres[0].x;
+	t = best_time([&]() {
+		for(int k=0; k<VEC_ITER; k++) {
+			const Mat4 &m = a[k];
+			for(int i=0; i<NUM_VEC; i++) {
+				vres[i] = m * v[i];
+			}
+		}
+	});
+	bench_sink = bench_sink + vres[0].x;
+	print_cmp("Mat4 * Vec4", NUM_VEC * VEC_ITER, "scalar", tref, "simd", t);
+
+	// same transform, batched over the whole array
+	t = best_time([&]() {
+		for(int k=0; k<VEC_ITER; k++) {
+			transform_homogeneous(&vres[0], &v[0], NUM_VEC, a[k]);
+		}
+	});
+	bench_sink = bench_sink + vres[0].x;
+	print_cmp("Mat4 * Vec4 (batch)", NUM_VEC * VEC_ITER, "scalar", tref, "simd", t);
+
+	tref = best_time([&]() {
+		for(int k=0; k<VEC_ITER; k++) {
+			const Mat4 &m = a[k];
+			for(int i=0; i<NUM_VEC; i++) {
+				vres[i] = xform_scalar(v[i], m);
+			}
+		}
+	});
+	bench_sink = bench_sink + vres[0].x;
+	t = best_time([&]() {
+		for(int k=0; k<VEC_ITER; k++) {
+			const Mat4 &m = a[k];
+			for(int i=0; i<NUM_VEC; i++) {
+				vres[i] = v[i] * m;
+			}
+		}
+	});
+	bench_sink = bench_sink + vres[0].x;
+	print_cmp("Vec4 * Mat4", NUM_VEC * VEC_ITER, "scalar", tref, "simd", t);
+}
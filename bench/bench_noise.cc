@@ -0,0 +1,234 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <thread>
+#include "gmath.h"
+#include "bench.h"
+
+using namespace gph;
+
+#define GRID2_SIZE	1024
+#define GRID3_SIZE	128
+#define GRID3_DEPTH	64
+#define NUM_POINTS	(1 << 20)
+
+static float max_diff(const std::vector<float> &a, const std::vector<float> &b)
+{
+	float res = 0.0f;
+	for(size_t i=0; i<a.size(); i++) {
+		float d = fabs(a[i] - b[i]);
+		if(d > res) res = d;
+	}
+	return res;
+}
+
+void bench_noise()
+{
+	NoiseContext ctx;
+	std::vector<float> ref(NUM_POINTS), res(NUM_POINTS);
+
+	// ---- 2D grid, with the lattice setup along x shared by all rows ----
+	Vec2 org2(0.5f, 0.5f), step2(0.037f, 0.041f);
+	double tref = best_time([&]() {
+		float *dest = &ref[0];
+		for(int i=0; i<GRID2_SIZE; i++) {
+			for(int j=0; j<GRID2_SIZE; j++) {
+				*dest++ = ctx.noise(org2.x + step2.x * j, org2.y + step2.y * i);
+			}
+		}
+	});
+	double t = best_time([&]() {
+		ctx.noise_grid(&res[0], GRID2_SIZE, GRID2_SIZE, org2, step2);
+	});
+	print_cmp("noise_grid 2D", NUM_POINTS, "scalar", tref, "simd", t);
+	printf("    max difference: %g\n", max_diff(ref, res));
+
+	// ---- 3D grid ----
+	Vec3 org3(0.5f, 0.5f, 0.5f), step3(0.037f, 0.041f, 0.043f);
+	tref = best_time([&]() {
+		float *dest = &ref[0];
+		for(int i=0; i<GRID3_DEPTH; i++) {
+			for(int j=0; j<GRID3_SIZE; j++) {
+				for(int k=0; k<GRID3_SIZE; k++) {
+					*dest++ = ctx.noise(org3.x + step3.x * k, org3.y + step3.y * j,
+							org3.z + step3.z * i);
+				}
+			}
+		}
+	});
+	t = best_time([&]() {
+		ctx.noise_grid(&res[0], GRID3_SIZE, GRID3_SIZE, GRID3_DEPTH, org3, step3);
+	});
+	print_cmp("noise_grid 3D", NUM_POINTS, "scalar", tref, "simd", t);
+	printf("    max difference: %g\n", max_diff(ref, res));
+
+	// spacing larger than the lattice, so every sample is in a different cell
+	step3 = Vec3(1.37f, 1.41f, 1.43f);
+	tref = best_time([&]() {
+		float *dest = &ref[0];
+		for(int i=0; i<GRID3_DEPTH; i++) {
+			for(int j=0; j<GRID3_SIZE; j++) {
+				for(int k=0; k<GRID3_SIZE; k++) {
+					*dest++ = ctx.noise(org3.x + step3.x * k, org3.y + step3.y * j,
+							org3.z + step3.z * i);
+				}
+			}
+		}
+	});
+	t = best_time([&]() {
+		ctx.noise_grid(&res[0], GRID3_SIZE, GRID3_SIZE, GRID3_DEPTH, org3, step3);
+	});
+	print_cmp("noise_grid 3D, sparse", NUM_POINTS, "scalar", tref, "simd", t);
+	printf("    max difference: %g\n", max_diff(ref, res));
+
+	// ---- arbitrary points ----
+	std::vector<Vec2> pos2(NUM_POINTS);
+	for(int i=0; i<NUM_POINTS; i++) {
+		pos2[i] = Vec2(frand(64.0f), frand(64.0f));
+	}
+	tref = best_time([&]() {
+		for(int i=0; i<NUM_POINTS; i++) {
+			ref[i] = ctx.noise(pos2[i].x, pos2[i].y);
+		}
+	});
+	t = best_time([&]() {
+		ctx.noise_batch(&res[0], &pos2[0], NUM_POINTS);
+	});
+	print_cmp("noise_batch 2D", NUM_POINTS, "scalar", tref, "simd", t);
+	printf("    max difference: %g\n", max_diff(ref, res));
+
+	std::vector<Vec3> pos3(NUM_POINTS);
+	for(int i=0; i<NUM_POINTS; i++) {
+		pos3[i] = Vec3(frand(64.0f), frand(64.0f), frand(64.0f));
+	}
+	tref = best_time([&]() {
+		for(int i=0; i<NUM_POINTS; i++) {
+			ref[i] = ctx.noise(pos3[i].x, pos3[i].y, pos3[i].z);
+		}
+	});
+	t = best_time([&]() {
+		ctx.noise_batch(&res[0], &pos3[0], NUM_POINTS);
+	});
+	print_cmp("noise_batch 3D", NUM_POINTS, "scalar", tref, "simd", t);
+	printf("    max difference: %g\n", max_diff(ref, res));
+
+	bench_sink = bench_sink + res[0] + ref[0];
+}
+
+#define NUM_POINTS4	(1 << 18)
+
+static void print_cost(const char *name, double count, double time3, double time4)
+{
+	printf("  %-28s 3D: %6.1f ns  4D: %6.1f ns  (4D/3D: %.2f)\n", name,
+			time3 / count * 1e9, time4 / count * 1e9, time4 / time3);
+}
+
+/* time per sample of the 4D noise functions, compared to their 3D versions */
+void bench_noise4()
+{
+	NoiseContext ctx;
+	std::vector<Vec4> pos(NUM_POINTS4);
+	for(int i=0; i<NUM_POINTS4; i++) {
+		pos[i] = Vec4(frand(64.0f), frand(64.0f), frand(64.0f), frand(64.0f));
+	}
+
+	float sum = 0.0f;
+	double t3 = best_time([&]() {
+		for(int i=0; i<NUM_POINTS4; i++) {
+			sum += ctx.noise(pos[i].x, pos[i].y, pos[i].z);
+		}
+	});
+	double t4 = best_time([&]() {
+		for(int i=0; i<NUM_POINTS4; i++) {
+			sum += ctx.noise(pos[i].x, pos[i].y, pos[i].z, pos[i].w);
+		}
+	});
+	print_cost("noise (4D is simplex)", NUM_POINTS4, t3, t4);
+
+	t3 = best_time([&]() {
+		for(int i=0; i<NUM_POINTS4; i++) {
+			sum += ctx.snoise(pos[i].x, pos[i].y, pos[i].z);
+		}
+	});
+	t4 = best_time([&]() {
+		for(int i=0; i<NUM_POINTS4; i++) {
+			sum += ctx.snoise(pos[i].x, pos[i].y, pos[i].z, pos[i].w);
+		}
+	});
+	print_cost("snoise", NUM_POINTS4, t3, t4);
+
+	t3 = best_time([&]() {
+		for(int i=0; i<NUM_POINTS4; i++) {
+			sum += ctx.pnoise(pos[i].x, pos[i].y, pos[i].z, 16, 16, 16);
+		}
+	});
+	t4 = best_time([&]() {
+		for(int i=0; i<NUM_POINTS4; i++) {
+			sum += ctx.pnoise(pos[i].x, pos[i].y, pos[i].z, pos[i].w, 16, 16, 16, 16);
+		}
+	});
+	print_cost("pnoise (hypercube)", NUM_POINTS4, t3, t4);
+
+	t3 = best_time([&]() {
+		for(int i=0; i<NUM_POINTS4 / 8; i++) {
+			sum += ctx.fbm(pos[i].x, pos[i].y, pos[i].z, 8);
+		}
+	});
+	t4 = best_time([&]() {
+		for(int i=0; i<NUM_POINTS4 / 8; i++) {
+			sum += ctx.fbm(pos[i].x, pos[i].y, pos[i].z, pos[i].w, 8);
+		}
+	});
+	print_cost("fbm, 8 octaves", NUM_POINTS4 / 8, t3, t4);
+
+	bench_sink = bench_sink + sum;
+}
+
+#define BAKE_SIZE	256
+
+static void bench_bake_threads(const char *name, const NoiseBake &nb, int reps)
+{
+	NoiseContext ctx;
+	int pitch = noise_bake_pitch(BAKE_SIZE);
+	std::vector<float> vol((size_t)pitch * BAKE_SIZE * BAKE_SIZE);
+	double count = (double)BAKE_SIZE * BAKE_SIZE * BAKE_SIZE;
+
+	printf("  %s, %d^3 tileable\n", name, BAKE_SIZE);
+
+	double t1 = 0.0;
+	for(int nthr=1; nthr<=8; nthr*=2) {
+		double t = best_time([&]() {
+			ctx.noise_bake(&vol[0], BAKE_SIZE, BAKE_SIZE, BAKE_SIZE, pitch, nb, nthr);
+		}, reps);
+		if(nthr == 1) t1 = t;
+
+		printf("    %d thread%s: %8.1f ms %8.2f M/s  (%.2fx)\n", nthr, nthr > 1 ? "s" : " ",
+				t * 1e3, count / t * 1e-6, t1 / t);
+	}
+	bench_sink = bench_sink + vol[0];
+}
+
+void bench_bake()
+{
+	printf("  hardware threads: %u\n", std::thread::hardware_concurrency());
+
+	NoiseBake nb;
+	nb.size = Vec3(16, 16, 16);
+	nb.tileable = true;
+
+	nb.func = BAKE_NOISE;
+	bench_bake_threads("noise", nb, 3);
+
+	nb.func = BAKE_FBM;
+	nb.fractal = FractalParams(4);
+	bench_bake_threads("fbm, 4 octaves", nb, 1);
+}
@@ -0,0 +1,160 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include "gmath.h"
+#include "bench.h"
+
+using namespace gph;
+
+#define NUM_QUAT	(1 << 16)
+#define QUAT_ITER	16
+
+static Quat rand_rotation()
+{
+	Vec3 axis;
+	do {
+		axis = Vec3(frand(2.0f) - 1.0f, frand(2.0f) - 1.0f, frand(2.0f) - 1.0f);
+	} while(length_sq(axis) < 1e-4f);
+
+	Quat q;
+	q.set_rotation(normalize(axis), frand(2.0f * (float)M_PI));
+	return q;
+}
+
+/* slerp in double precision, as the reference for the error of all the
+ * single precision versions, including slerp itself
+ */
+static Quat slerp_ref(const Quat &q1, const Quat &q2, float t)
+{
+	double dot = (double)q1.x * q2.x + (double)q1.y * q2.y + (double)q1.z * q2.z +
+		(double)q1.w * q2.w;
+	double sign = 1.0;
+	if(dot < 0.0) {
+		sign = -1.0;
+		dot = -dot;
+	}
+	double a = 1.0 - t, b = t;
+	if(dot < 1.0) {
+		double angle = acos(dot);
+		a = sin((1.0 - t) * angle) / sin(angle);
+		b = sin(t * angle) / sin(angle);
+	}
+	return Quat((float)(sign * q1.x * a + q2.x * b), (float)(sign * q1.y * a + q2.y * b),
+			(float)(sign * q1.z * a + q2.z * b), (float)(sign * q1.w * a + q2.w * b));
+}
+
+struct QuatError {
+	float comp;		// largest difference of any component
+	float angle;	// largest angle between the rotations, in degrees
+};
+
+static QuatError max_error(const std::vector<Quat> &res, const std::vector<Quat> &ref)
+{
+	QuatError err = {0.0f, 0.0f};
+	for(size_t i=0; i<res.size(); i++) {
+		const Quat &a = res[i];
+		double dot = (double)a.x * ref[i].x + (double)a.y * ref[i].y + (double)a.z * ref[i].z +
+			(double)a.w * ref[i].w;
+
+		/* q and -q are the same rotation, and the functions pick different
+		 * signs when flipping to the shortest arc
+		 */
+		Quat b = dot < 0.0 ? -ref[i] : ref[i];
+		float d = std::max(std::max(fabs(a.x - b.x), fabs(a.y - b.y)),
+				std::max(fabs(a.z - b.z), fabs(a.w - b.w)));
+		if(d > err.comp) err.comp = d;
+
+		double lena = (double)a.x * a.x + (double)a.y * a.y + (double)a.z * a.z + (double)a.w * a.w;
+		double lenb = (double)b.x * b.x + (double)b.y * b.y + (double)b.z * b.z + (double)b.w * b.w;
+		dot = fabs(dot) / sqrt(lena * lenb);
+		float angle = (float)(2.0 * acos(std::min(dot, 1.0)) * 180.0 / M_PI);
+		if(angle > err.angle) err.angle = angle;
+	}
+	return err;
+}
+
+static void print_error(const char *name, const QuatError &err)
+{
+	printf("    %-26s max error: %.2e (component), %.4f degrees\n", name, err.comp, err.angle);
+}
+
+void bench_quat()
+{
+	std::vector<Quat> a(NUM_QUAT), b(NUM_QUAT), res(NUM_QUAT), ref(NUM_QUAT);
+	std::vector<float> t(NUM_QUAT);
+	/* arbitrary pairs of rotations, up to 180 degrees apart across the shortest
+	 * arc, which is the worst case for the error of nlerp
+	 */
+	for(int i=0; i<NUM_QUAT; i++) {
+		a[i] = rand_rotation();
+		b[i] = rand_rotation();
+		t[i] = frand(1.0f);
+	}
+
+	double count = (double)NUM_QUAT * QUAT_ITER;
+
+	double tslerp = best_time([&]() {
+		for(int k=0; k<QUAT_ITER; k++) {
+			for(int i=0; i<NUM_QUAT; i++) {
+				res[i] = slerp(a[i], b[i], t[i]);
+			}
+		}
+	});
+	bench_sink = bench_sink + res[0].w;
+	for(int i=0; i<NUM_QUAT; i++) {
+		ref[i] = slerp_ref(a[i], b[i], t[i]);
+	}
+	print_rate("slerp", count, tslerp);
+	print_error("slerp", max_error(res, ref));
+
+	double tt = best_time([&]() {
+		for(int k=0; k<QUAT_ITER; k++) {
+			for(int i=0; i<NUM_QUAT; i++) {
+				res[i] = slerp_approx(a[i], b[i], t[i]);
+			}
+		}
+	});
+	bench_sink = bench_sink + res[0].w;
+	print_cmp("slerp_approx", count, "slerp", tslerp, "approx", tt);
+	print_error("slerp_approx", max_error(res, ref));
+
+	tt = best_time([&]() {
+		for(int k=0; k<QUAT_ITER; k++) {
+			slerp_approx(&res[0], &a[0], &b[0], &t[0], NUM_QUAT);
+		}
+	});
+	bench_sink = bench_sink + res[0].w;
+	print_cmp("slerp_approx (batch)", count, "slerp", tslerp, "approx", tt);
+	print_error("slerp_approx (batch)", max_error(res, ref));
+
+	tt = best_time([&]() {
+		for(int k=0; k<QUAT_ITER; k++) {
+			for(int i=0; i<NUM_QUAT; i++) {
+				res[i] = nlerp(a[i], b[i], t[i]);
+			}
+		}
+	});
+	bench_sink = bench_sink + res[0].w;
+	print_cmp("nlerp", count, "slerp", tslerp, "nlerp", tt);
+	print_error("nlerp", max_error(res, ref));
+
+	tt = best_time([&]() {
+		for(int k=0; k<QUAT_ITER; k++) {
+			nlerp(&res[0], &a[0], &b[0], &t[0], NUM_QUAT);
+		}
+	});
+	bench_sink = bench_sink + res[0].w;
+	print_cmp("nlerp (batch)", count, "slerp", tslerp, "nlerp", tt);
+	print_error("nlerp (batch)", max_error(res, ref));
+}
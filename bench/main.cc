@@ -0,0 +1,121 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "simd.h"
+#include "bench.h"
+
+struct Benchmark {
+	const char *name;
+	void (*func)();
+	const char *desc;
+};
+
+static Benchmark benchmarks[] = {
+	{"mat4", bench_mat4, "Mat4 multiply and Mat4/Vec4 transforms, SIMD vs scalar"},
+	{"bvh", bench_bvh, "BVH build time and ray casting, vs brute force"},
+	{"noise", bench_noise, "batched noise over grids and point arrays, vs scalar noise"},
+	{"noise4", bench_noise4, "cost of 4D noise, compared to 3D"},
+	{"bake", bench_bake, "multithreaded noise_bake scaling with thread count"},
+	{"quat", bench_quat, "slerp vs slerp_approx and nlerp, throughput and error"},
+	{"hierarchy", bench_hierarchy, "TransformHierarchy update, serial vs parallel"}
+};
+#define NUM_BENCHMARKS	(int)(sizeof benchmarks / sizeof *benchmarks)
+
+volatile float bench_sink;
+
+static void print_usage(const char *argv0);
+
+int main(int argc, char **argv)
+{
+	bool run[NUM_BENCHMARKS] = {false};
+	bool run_all = true;
+
+	for(int i=1; i<argc; i++) {
+		if(strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "-help") == 0) {
+			print_usage(argv[0]);
+			return 0;
+		}
+
+		int idx = -1;
+		for(int j=0; j<NUM_BENCHMARKS; j++) {
+			if(strcmp(argv[i], benchmarks[j].name) == 0) {
+				idx = j;
+				break;
+			}
+		}
+		if(idx == -1) {
+			fprintf(stderr, "unknown benchmark: %s\n", argv[i]);
+			print_usage(argv[0]);
+			return 1;
+		}
+		run[idx] = true;
+		run_all = false;
+	}
+
+#if defined(GPH_SIMD_AVX)
+	printf("SIMD code paths: AVX\n");
+#elif defined(GPH_SIMD_SSE)
+	printf("SIMD code paths: SSE\n");
+#elif defined(GPH_SIMD_NEON)
+	printf("SIMD code paths: NEON\n");
+#else
+	printf("SIMD code paths: none\n");
+#endif
+
+	for(int i=0; i<NUM_BENCHMARKS; i++) {
+		if(run_all || run[i]) {
+			printf("\n-- %s: %s\n", benchmarks[i].name, benchmarks[i].desc);
+			benchmarks[i].func();
+		}
+	}
+	return 0;
+}
+
+static void print_usage(const char *argv0)
+{
+	printf("Usage: %s [benchmark ...]\n", argv0);
+	printf("Runs the listed benchmarks, or all of them if none are listed:\n");
+	for(int i=0; i<NUM_BENCHMARKS; i++) {
+		printf("  %-10s %s\n", benchmarks[i].name, benchmarks[i].desc);
+	}
+}
+
+double get_time()
+{
+	typedef std::chrono::steady_clock clock;
+	return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+/* enough decimal digits to show at least 3 significant ones, for the slow
+ * reference implementations
+ */
+static int rate_prec(double rate)
+{
+	if(rate >= 10.0) return 2;
+	if(rate >= 0.01) return 3;
+	return 5;
+}
+
+void print_rate(const char *name, double count, double time)
+{
+	double rate = count / time * 1e-6;
+	printf("  %-28s %10.*f M/s\n", name, rate_prec(rate), rate);
+}
+
+void print_cmp(const char *name, double count, const char *name_a, double time_a,
+		const char *name_b, double time_b)
+{
+	double rate_a = count / time_a * 1e-6;
+	double rate_b = count / time_b * 1e-6;
+	printf("  %-28s %s: %8.*f M/s  %s: %8.*f M/s  (%.2fx)\n", name, name_a,
+			rate_prec(rate_a), rate_a, name_b, rate_prec(rate_b), rate_b, time_a / time_b);
+}
@@ -0,0 +1,35 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+/* scalar code paths of the Mat4/Vec4 transforms, as they are compiled with
+ * GPH_NO_SIMD. They're kept in a separate file, so that they are called out of
+ * line like the library versions, instead of being inlined into the benchmark
+ * loop.
+ */
+#include "gmath.h"
+
+using namespace gph;
+
+Vec4 xform_scalar(const Mat4 &m, const Vec4 &v)
+{
+	float x = m[0][0] * v.x + m[1][0] * v.y + m[2][0] * v.z + m[3][0] * v.w;
+	float y = m[0][1] * v.x + m[1][1] * v.y + m[2][1] * v.z + m[3][1] * v.w;
+	float z = m[0][2] * v.x + m[1][2] * v.y + m[2][2] * v.z + m[3][2] * v.w;
+	float w = m[0][3] * v.x + m[1][3] * v.y + m[2][3] * v.z + m[3][3] * v.w;
+	return Vec4(x, y, z, w);
+}
+
+Vec4 xform_scalar(const Vec4 &v, const Mat4 &m)
+{
+	float x = v.x * m[0][0] + v.y * m[0][1] + v.z * m[0][2] + v.w * m[0][3];
+	float y = v.x * m[1][0] + v.y * m[1][1] + v.z * m[1][2] + v.w * m[1][3];
+	float z = v.x * m[2][0] + v.y * m[2][1] + v.z * m[2][2] + v.w * m[2][3];
+	float w = v.x * m[3][0] + v.y * m[3][1] + v.z * m[3][2] + v.w * m[3][3];
+	return Vec4(x, y, z, w);
+}
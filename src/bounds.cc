@@ -0,0 +1,175 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#include "bounds.h"
+#include "wide.h"
+
+namespace gph {
+
+AABB::AABB(const Vec3 *points, int count)
+{
+	set(points, count);
+}
+
+void AABB::set(const Vec3 *points, int count)
+{
+	reset();
+
+	/* 4 consecutive points are 3 whole registers: xyzx yzxy zxyz. Keeping
+	 * separate minima and maxima for each of the 3, every lane always sees the
+	 * same coordinate, and they're only sorted out once at the end.
+	 */
+	int nquads = count / 4;
+	if(nquads) {
+		const float *fptr = &points[0].x;
+		Float4 mn0(fptr), mn1(fptr + 4), mn2(fptr + 8);
+		Float4 mx0 = mn0, mx1 = mn1, mx2 = mn2;
+		fptr += 12;
+
+		for(int i=1; i<nquads; i++) {
+			Float4 v0(fptr), v1(fptr + 4), v2(fptr + 8);
+			mn0 = min(mn0, v0); mx0 = max(mx0, v0);
+			mn1 = min(mn1, v1); mx1 = max(mx1, v1);
+			mn2 = min(mn2, v2); mx2 = max(mx2, v2);
+			fptr += 12;
+		}
+
+		float lo[12], hi[12];
+		mn0.store(lo); mn1.store(lo + 4); mn2.store(lo + 8);
+		mx0.store(hi); mx1.store(hi + 4); mx2.store(hi + 8);
+		for(int i=0; i<12; i++) {
+			int c = i % 3;
+			if(lo[i] < bmin[c]) bmin[c] = lo[i];
+			if(hi[i] > bmax[c]) bmax[c] = hi[i];
+		}
+	}
+
+	for(int i=nquads*4; i<count; i++) {
+		expand(points[i]);
+	}
+}
+
+void AABB::set(const float *points, int stride, int count)
+{
+	if(stride == (int)sizeof(Vec3)) {
+		set((const Vec3*)points, count);
+		return;
+	}
+
+	reset();
+	if(count <= 0) return;
+
+	/* one point per register, ignoring the last lane. The last point is done
+	 * separately, so that we never read past the end of the array. Two sets of
+	 * minima and maxima, to avoid waiting on the latency of each min/max.
+	 */
+	const char *ptr = (const char*)points;
+	Float4 mn0(FLT_MAX), mn1(FLT_MAX);
+	Float4 mx0(-FLT_MAX), mx1(-FLT_MAX);
+
+	int i = 0;
+	for(; i<count-2; i+=2) {
+		Float4 v0((const float*)ptr);
+		Float4 v1((const float*)(ptr + stride));
+		mn0 = min(mn0, v0); mx0 = max(mx0, v0);
+		mn1 = min(mn1, v1); mx1 = max(mx1, v1);
+		ptr += stride * 2;
+	}
+
+	float lo[4], hi[4];
+	min(mn0, mn1).store(lo);
+	max(mx0, mx1).store(hi);
+	bmin = Vec3(lo[0], lo[1], lo[2]);
+	bmax = Vec3(hi[0], hi[1], hi[2]);
+
+	for(; i<count; i++) {
+		const float *p = (const float*)ptr;
+		expand(Vec3(p[0], p[1], p[2]));
+		ptr += stride;
+	}
+}
+
+Sphere::Sphere(const Vec3 *points, int count)
+{
+	set(points, count);
+}
+
+#define EPOS_NUM_DIRS	7
+
+void Sphere::set(const Vec3 *points, int count)
+{
+	static const Vec3 dirs[EPOS_NUM_DIRS] = {
+		Vec3(1, 0, 0), Vec3(0, 1, 0), Vec3(0, 0, 1),
+		Vec3(1, 1, 1), Vec3(1, 1, -1), Vec3(1, -1, 1), Vec3(1, -1, -1)
+	};
+
+	if(count <= 0) {
+		rad = -1.0f;
+		return;
+	}
+
+	// find the extremal points along each direction
+	int imin[EPOS_NUM_DIRS] = {0}, imax[EPOS_NUM_DIRS] = {0};
+	float pmin[EPOS_NUM_DIRS], pmax[EPOS_NUM_DIRS];
+	for(int i=0; i<EPOS_NUM_DIRS; i++) {
+		pmin[i] = pmax[i] = dot(points[0], dirs[i]);
+	}
+
+	for(int i=1; i<count; i++) {
+		for(int j=0; j<EPOS_NUM_DIRS; j++) {
+			float proj = dot(points[i], dirs[j]);
+			if(proj < pmin[j]) {
+				pmin[j] = proj;
+				imin[j] = i;
+			}
+			if(proj > pmax[j]) {
+				pmax[j] = proj;
+				imax[j] = i;
+			}
+		}
+	}
+
+	// the initial sphere is spanned by the most distant pair
+	int best = 0;
+	float best_dsq = -1.0f;
+	for(int i=0; i<EPOS_NUM_DIRS; i++) {
+		float dsq = length_sq(points[imax[i]] - points[imin[i]]);
+		if(dsq > best_dsq) {
+			best_dsq = dsq;
+			best = i;
+		}
+	}
+
+	const Vec3 &a = points[imin[best]];
+	const Vec3 &b = points[imax[best]];
+	center = (a + b) * 0.5f;
+	rad = sqrt(best_dsq) * 0.5f;
+
+	// grow it to include everything else
+	for(int i=0; i<count; i++) {
+		expand(points[i]);
+	}
+}
+
+OBB merge(const OBB &a, const OBB &b)
+{
+	float avol = a.half_size.x * a.half_size.y * a.half_size.z;
+	float bvol = b.half_size.x * b.half_size.y * b.half_size.z;
+
+	const OBB &big = avol >= bvol ? a : b;
+	const OBB &small = avol >= bvol ? b : a;
+
+	OBB res = big;
+	for(int i=0; i<8; i++) {
+		res.expand(small.get_corner(i));
+	}
+	return res;
+}
+
+}	// namespace gph
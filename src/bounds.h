@@ -0,0 +1,164 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#ifndef GMATH_BOUNDS_H_
+#define GMATH_BOUNDS_H_
+
+#include "config.h"
+
+#include <float.h>
+#include "vector.h"
+#include "matrix.h"
+#include "transform.h"
+#include "frustum.h"
+#include "ray.h"
+#include "intersect.h"
+
+/* Bounding volumes: axis-aligned boxes, spheres, and oriented boxes.
+ *
+ * Default constructed volumes are empty: an AABB with bmin > bmax, or a sphere
+ * with a negative radius. Expanding or merging an empty volume with anything
+ * results in the other volume, so bounds can be accumulated starting from an
+ * empty one.
+ *
+ * Transforming an AABB by a matrix results in the AABB of the transformed box
+ * (Arvo, "Transforming axis-aligned bounding boxes"), computed from the center
+ * and half-size with the absolute values of the matrix elements, instead of
+ * transforming all 8 corners. Transforming an AABB by a matrix into an OBB
+ * instead, is exact.
+ */
+
+namespace gph {
+
+class GPH_MATH_API AABB {
+public:
+	Vec3 bmin, bmax;
+
+	inline AABB();
+	AABB(const Vec3 &bmin_, const Vec3 &bmax_) : bmin(bmin_), bmax(bmax_) {}
+	// bounds of an array of points, see set
+	AABB(const Vec3 *points, int count);
+
+	inline bool is_empty() const;
+
+	inline Vec3 get_center() const;
+	inline Vec3 get_half_size() const;
+	inline float get_volume() const;
+
+	// makes the box empty
+	inline void reset();
+	/* bounds of an array of points, computed with a SIMD min/max reduction.
+	 * The second version reads the x, y, z of each point from the first 3
+	 * floats every stride bytes, for interleaved vertex data.
+	 */
+	void set(const Vec3 *points, int count);
+	void set(const float *points, int stride, int count);
+
+	inline void expand(const Vec3 &pt);
+	inline void expand(const AABB &box);
+};
+
+class GPH_MATH_API Sphere {
+public:
+	Vec3 center;
+	float rad;
+
+	Sphere() : rad(-1.0f) {}
+	Sphere(const Vec3 &center_, float rad_) : center(center_), rad(rad_) {}
+	// bounds of an array of points, see set
+	Sphere(const Vec3 *points, int count);
+
+	inline bool is_empty() const;
+
+	/* bounding sphere of an array of points: the initial sphere is spanned by
+	 * the most distant pair of the extremal points along 7 directions (EPOS-14),
+	 * which is then grown to include any points left outside (Ritter). Not the
+	 * minimal sphere, but usually within a few percent of it.
+	 */
+	void set(const Vec3 *points, int count);
+
+	// grows the sphere just enough to include pt, moving its center towards it
+	inline void expand(const Vec3 &pt);
+	inline void expand(const Sphere &s);
+};
+
+class GPH_MATH_API OBB {
+public:
+	Vec3 center;
+	Vec3 axis[3];		// orthonormal
+	Vec3 half_size;		// half extent along each axis
+
+	inline OBB();
+	OBB(const Vec3 &center_, const Vec3 &ax, const Vec3 &ay, const Vec3 &az, const Vec3 &half)
+		: center(center_), half_size(half) { axis[0] = ax; axis[1] = ay; axis[2] = az; }
+	inline explicit OBB(const AABB &box);
+	/* the box transformed by xform, which may contain rotation, translation,
+	 * and scaling along the box axes, but no shearing.
+	 */
+	inline OBB(const AABB &box, const Mat4 &xform);
+	inline OBB(const AABB &box, const Mat3x4 &xform);
+
+	inline Vec3 get_corner(int idx) const;
+	inline AABB get_aabb() const;
+
+	/* grows the box along its axes to include pt. Only the extent on the side
+	 * of pt grows, so the center moves.
+	 */
+	inline void expand(const Vec3 &pt);
+};
+
+// ---- AABB functions ----
+// union of two boxes
+inline GPH_MATH_API AABB merge(const AABB &a, const AABB &b);
+inline GPH_MATH_API AABB transform(const AABB &box, const Mat4 &m);
+inline GPH_MATH_API AABB transform(const AABB &box, const Mat3x4 &m);
+inline GPH_MATH_API bool contains(const AABB &box, const Vec3 &pt);
+inline GPH_MATH_API bool overlap(const AABB &a, const AABB &b);
+
+inline GPH_MATH_API bool intersect_aabb(const Ray &ray, const AABB &box,
+		float *tnear = 0, float *tfar = 0);
+inline GPH_MATH_API int cull_aabb(const Frustum &frust, const AABB &box,
+		unsigned int *plane_mask = 0, int *last_plane = 0);
+
+// ---- Sphere functions ----
+// smallest sphere enclosing both spheres
+inline GPH_MATH_API Sphere merge(const Sphere &a, const Sphere &b);
+/* the center is transformed as a point, and the radius scaled by the largest
+ * scaling factor of m
+ */
+inline GPH_MATH_API Sphere transform(const Sphere &s, const Mat4 &m);
+inline GPH_MATH_API Sphere transform(const Sphere &s, const Mat3x4 &m);
+inline GPH_MATH_API bool contains(const Sphere &s, const Vec3 &pt);
+inline GPH_MATH_API bool overlap(const Sphere &a, const Sphere &b);
+
+inline GPH_MATH_API bool intersect_sphere(const Ray &ray, const Sphere &s, float *t = 0);
+inline GPH_MATH_API int cull_sphere(const Frustum &frust, const Sphere &s,
+		unsigned int *plane_mask = 0, int *last_plane = 0);
+
+// ---- OBB functions ----
+/* box with the orientation of the larger of a and b, enclosing both. Not the
+ * tightest possible, but cheap, and exact when one contains the other.
+ */
+GPH_MATH_API OBB merge(const OBB &a, const OBB &b);
+// same restrictions as the OBB(AABB, Mat4) constructor
+inline GPH_MATH_API OBB transform(const OBB &box, const Mat4 &m);
+inline GPH_MATH_API OBB transform(const OBB &box, const Mat3x4 &m);
+inline GPH_MATH_API bool contains(const OBB &box, const Vec3 &pt);
+
+// the ray is transformed to the frame of the box, and tested as an AABB
+inline GPH_MATH_API bool intersect_obb(const Ray &ray, const OBB &box,
+		float *tnear = 0, float *tfar = 0);
+inline GPH_MATH_API int cull_obb(const Frustum &frust, const OBB &box,
+		unsigned int *plane_mask = 0, int *last_plane = 0);
+
+#include "bounds.inl"
+
+}	// namespace gph
+
+#endif	// GMATH_BOUNDS_H_
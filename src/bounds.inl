@@ -0,0 +1,307 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+
+// ---- AABB ----
+
+inline AABB::AABB()
+	: bmin(FLT_MAX, FLT_MAX, FLT_MAX), bmax(-FLT_MAX, -FLT_MAX, -FLT_MAX)
+{
+}
+
+inline bool AABB::is_empty() const
+{
+	return bmin.x > bmax.x || bmin.y > bmax.y || bmin.z > bmax.z;
+}
+
+inline Vec3 AABB::get_center() const
+{
+	return (bmin + bmax) * 0.5f;
+}
+
+inline Vec3 AABB::get_half_size() const
+{
+	return (bmax - bmin) * 0.5f;
+}
+
+inline float AABB::get_volume() const
+{
+	if(is_empty()) return 0.0f;
+	Vec3 sz = bmax - bmin;
+	return sz.x * sz.y * sz.z;
+}
+
+inline void AABB::reset()
+{
+	bmin = Vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+	bmax = Vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+}
+
+inline void AABB::expand(const Vec3 &pt)
+{
+	if(pt.x < bmin.x) bmin.x = pt.x;
+	if(pt.y < bmin.y) bmin.y = pt.y;
+	if(pt.z < bmin.z) bmin.z = pt.z;
+	if(pt.x > bmax.x) bmax.x = pt.x;
+	if(pt.y > bmax.y) bmax.y = pt.y;
+	if(pt.z > bmax.z) bmax.z = pt.z;
+}
+
+inline void AABB::expand(const AABB &box)
+{
+	if(box.bmin.x < bmin.x) bmin.x = box.bmin.x;
+	if(box.bmin.y < bmin.y) bmin.y = box.bmin.y;
+	if(box.bmin.z < bmin.z) bmin.z = box.bmin.z;
+	if(box.bmax.x > bmax.x) bmax.x = box.bmax.x;
+	if(box.bmax.y > bmax.y) bmax.y = box.bmax.y;
+	if(box.bmax.z > bmax.z) bmax.z = box.bmax.z;
+}
+
+inline AABB merge(const AABB &a, const AABB &b)
+{
+	AABB res = a;
+	res.expand(b);
+	return res;
+}
+
+inline AABB transform(const AABB &box, const Mat4 &m)
+{
+	return transform(box, Mat3x4(m));
+}
+
+inline AABB transform(const AABB &box, const Mat3x4 &m)
+{
+	if(box.is_empty()) return box;
+
+	Vec3 c = m * box.get_center();
+	Vec3 h = box.get_half_size();
+
+	// the half-size of the result is the half-size transformed by |m|
+	Vec3 hres(noinit);
+	hres.x = fabs(m[0][0]) * h.x + fabs(m[1][0]) * h.y + fabs(m[2][0]) * h.z;
+	hres.y = fabs(m[0][1]) * h.x + fabs(m[1][1]) * h.y + fabs(m[2][1]) * h.z;
+	hres.z = fabs(m[0][2]) * h.x + fabs(m[1][2]) * h.y + fabs(m[2][2]) * h.z;
+	return AABB(c - hres, c + hres);
+}
+
+inline bool contains(const AABB &box, const Vec3 &pt)
+{
+	return pt.x >= box.bmin.x && pt.y >= box.bmin.y && pt.z >= box.bmin.z &&
+		pt.x <= box.bmax.x && pt.y <= box.bmax.y && pt.z <= box.bmax.z;
+}
+
+inline bool overlap(const AABB &a, const AABB &b)
+{
+	return a.bmin.x <= b.bmax.x && a.bmax.x >= b.bmin.x &&
+		a.bmin.y <= b.bmax.y && a.bmax.y >= b.bmin.y &&
+		a.bmin.z <= b.bmax.z && a.bmax.z >= b.bmin.z;
+}
+
+inline bool intersect_aabb(const Ray &ray, const AABB &box, float *tnear, float *tfar)
+{
+	return intersect_aabb(ray, box.bmin, box.bmax, tnear, tfar);
+}
+
+inline int cull_aabb(const Frustum &frust, const AABB &box, unsigned int *plane_mask,
+		int *last_plane)
+{
+	return cull_aabb(frust, box.bmin, box.bmax, plane_mask, last_plane);
+}
+
+// ---- Sphere ----
+
+inline bool Sphere::is_empty() const
+{
+	return rad < 0.0f;
+}
+
+inline void Sphere::expand(const Vec3 &pt)
+{
+	if(rad < 0.0f) {
+		center = pt;
+		rad = 0.0f;
+		return;
+	}
+
+	Vec3 dir = pt - center;
+	float dsq = length_sq(dir);
+	if(dsq > rad * rad) {
+		float dist = sqrt(dsq);
+		float new_rad = (rad + dist) * 0.5f;
+		center += dir * ((new_rad - rad) / dist);
+		rad = new_rad;
+	}
+}
+
+inline void Sphere::expand(const Sphere &s)
+{
+	*this = merge(*this, s);
+}
+
+inline Sphere merge(const Sphere &a, const Sphere &b)
+{
+	if(a.rad < 0.0f) return b;
+	if(b.rad < 0.0f) return a;
+
+	Vec3 dir = b.center - a.center;
+	float dist = length(dir);
+	if(dist + b.rad <= a.rad) return a;
+	if(dist + a.rad <= b.rad) return b;
+
+	float rad = (dist + a.rad + b.rad) * 0.5f;
+	return Sphere(a.center + dir * ((rad - a.rad) / dist), rad);
+}
+
+inline Sphere transform(const Sphere &s, const Mat4 &m)
+{
+	return transform(s, Mat3x4(m));
+}
+
+inline Sphere transform(const Sphere &s, const Mat3x4 &m)
+{
+	if(s.rad < 0.0f) return s;
+
+	float sx = m[0][0] * m[0][0] + m[0][1] * m[0][1] + m[0][2] * m[0][2];
+	float sy = m[1][0] * m[1][0] + m[1][1] * m[1][1] + m[1][2] * m[1][2];
+	float sz = m[2][0] * m[2][0] + m[2][1] * m[2][1] + m[2][2] * m[2][2];
+	float smax = sx > sy ? (sx > sz ? sx : sz) : (sy > sz ? sy : sz);
+	return Sphere(m * s.center, s.rad * sqrt(smax));
+}
+
+inline bool contains(const Sphere &s, const Vec3 &pt)
+{
+	return length_sq(pt - s.center) <= s.rad * s.rad;
+}
+
+inline bool overlap(const Sphere &a, const Sphere &b)
+{
+	float rsum = a.rad + b.rad;
+	return a.rad >= 0.0f && b.rad >= 0.0f && length_sq(b.center - a.center) <= rsum * rsum;
+}
+
+inline bool intersect_sphere(const Ray &ray, const Sphere &s, float *t)
+{
+	return intersect_sphere(ray, s.center, s.rad, t);
+}
+
+inline int cull_sphere(const Frustum &frust, const Sphere &s, unsigned int *plane_mask,
+		int *last_plane)
+{
+	return cull_sphere(frust, s.center, s.rad, plane_mask, last_plane);
+}
+
+// ---- OBB ----
+
+inline OBB::OBB()
+{
+	axis[0] = Vec3(1, 0, 0);
+	axis[1] = Vec3(0, 1, 0);
+	axis[2] = Vec3(0, 0, 1);
+}
+
+inline OBB::OBB(const AABB &box)
+{
+	center = box.get_center();
+	half_size = box.get_half_size();
+	axis[0] = Vec3(1, 0, 0);
+	axis[1] = Vec3(0, 1, 0);
+	axis[2] = Vec3(0, 0, 1);
+}
+
+inline OBB::OBB(const AABB &box, const Mat4 &xform)
+{
+	*this = transform(OBB(box), Mat3x4(xform));
+}
+
+inline OBB::OBB(const AABB &box, const Mat3x4 &xform)
+{
+	*this = transform(OBB(box), xform);
+}
+
+/* bit 0, 1, 2 of idx selects the positive side of the box along the first,
+ * second, and third axis respectively
+ */
+inline Vec3 OBB::get_corner(int idx) const
+{
+	Vec3 ax = axis[0] * half_size.x;
+	Vec3 ay = axis[1] * half_size.y;
+	Vec3 az = axis[2] * half_size.z;
+	return center + (idx & 1 ? ax : -ax) + (idx & 2 ? ay : -ay) + (idx & 4 ? az : -az);
+}
+
+inline AABB OBB::get_aabb() const
+{
+	Vec3 h(noinit);
+	h.x = fabs(axis[0].x) * half_size.x + fabs(axis[1].x) * half_size.y + fabs(axis[2].x) * half_size.z;
+	h.y = fabs(axis[0].y) * half_size.x + fabs(axis[1].y) * half_size.y + fabs(axis[2].y) * half_size.z;
+	h.z = fabs(axis[0].z) * half_size.x + fabs(axis[1].z) * half_size.y + fabs(axis[2].z) * half_size.z;
+	return AABB(center - h, center + h);
+}
+
+inline void OBB::expand(const Vec3 &pt)
+{
+	for(int i=0; i<3; i++) {
+		float d = dot(pt - center, axis[i]);
+		float h = half_size[i];
+		// moving the center along one axis, doesn't change the others
+		if(d > h) {
+			float grow = (d - h) * 0.5f;
+			half_size[i] += grow;
+			center += axis[i] * grow;
+		} else if(d < -h) {
+			float grow = (-d - h) * 0.5f;
+			half_size[i] += grow;
+			center -= axis[i] * grow;
+		}
+	}
+}
+
+inline OBB transform(const OBB &box, const Mat4 &m)
+{
+	return transform(box, Mat3x4(m));
+}
+
+inline OBB transform(const OBB &box, const Mat3x4 &m)
+{
+	OBB res;
+	res.center = m * box.center;
+	for(int i=0; i<3; i++) {
+		Vec3 v = transform_vector(m, box.axis[i]);
+		float len = length(v);
+		res.axis[i] = len != 0.0f ? v / len : box.axis[i];
+		res.half_size[i] = box.half_size[i] * len;
+	}
+	return res;
+}
+
+inline bool contains(const OBB &box, const Vec3 &pt)
+{
+	Vec3 d = pt - box.center;
+	return fabs(dot(d, box.axis[0])) <= box.half_size.x &&
+		fabs(dot(d, box.axis[1])) <= box.half_size.y &&
+		fabs(dot(d, box.axis[2])) <= box.half_size.z;
+}
+
+inline bool intersect_obb(const Ray &ray, const OBB &box, float *tnear, float *tfar)
+{
+	// the axes are orthonormal, so t is the same in the frame of the box
+	Vec3 o = ray.origin - box.center;
+	Ray lray;
+	lray.origin = Vec3(dot(o, box.axis[0]), dot(o, box.axis[1]), dot(o, box.axis[2]));
+	lray.dir = Vec3(dot(ray.dir, box.axis[0]), dot(ray.dir, box.axis[1]), dot(ray.dir, box.axis[2]));
+	return intersect_aabb(lray, -box.half_size, box.half_size, tnear, tfar);
+}
+
+inline int cull_obb(const Frustum &frust, const OBB &box, unsigned int *plane_mask,
+		int *last_plane)
+{
+	return cull_obb(frust, box.center, box.axis[0] * box.half_size.x,
+			box.axis[1] * box.half_size.y, box.axis[2] * box.half_size.z,
+			plane_mask, last_plane);
+}
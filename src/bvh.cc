@@ -0,0 +1,470 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include "bvh.h"
+#include "intersect.h"
+
+#define NUM_BINS		16
+#define MAX_LEAF_PRIMS	4
+/* relative cost of a traversal step vs a ray-triangle test, for the SAH */
+#define TRAVERSAL_COST	1.0f
+/* don't bother spawning threads for subtrees smaller than this */
+#define MIN_PARALLEL	4096
+#define STACK_SIZE		64
+/* past this depth nodes are split in the middle, which bounds the tree depth
+ * to MAX_SAH_DEPTH + log2(n), well within the traversal stack
+ */
+#define MAX_SAH_DEPTH	32
+
+namespace gph {
+
+struct SAHBin {
+	Vec3 bmin, bmax;
+	int count;
+};
+
+struct BuildData {
+	BVHNode *nodes;
+	int *prims;
+	std::vector<Vec3> tri_bmin, tri_bmax, centroid;
+	std::atomic<int> num_nodes;
+};
+
+/* sorts primitives to the left side of the chosen split bin */
+struct SplitPred {
+	const Vec3 *centroid;
+	int axis, split;
+	float cmin, scale;
+
+	bool operator ()(int p) const
+	{
+		int b = (int)((centroid[p][axis] - cmin) * scale);
+		return (b >= NUM_BINS ? NUM_BINS - 1 : b) <= split;
+	}
+};
+
+struct CentroidLess {
+	const Vec3 *centroid;
+	int axis;
+
+	bool operator ()(int a, int b) const
+	{
+		return centroid[a][axis] < centroid[b][axis];
+	}
+};
+
+static void build_node(BuildData *bd, int nidx, int begin, int end, int depth, int par_depth);
+static void relayout(const BVHNode *src, int sidx, BVHNode *dest, int didx, int *next);
+
+static inline void expand(Vec3 &bmin, Vec3 &bmax, const Vec3 &pmin, const Vec3 &pmax)
+{
+	if(pmin.x < bmin.x) bmin.x = pmin.x;
+	if(pmin.y < bmin.y) bmin.y = pmin.y;
+	if(pmin.z < bmin.z) bmin.z = pmin.z;
+	if(pmax.x > bmax.x) bmax.x = pmax.x;
+	if(pmax.y > bmax.y) bmax.y = pmax.y;
+	if(pmax.z > bmax.z) bmax.z = pmax.z;
+}
+
+static inline float half_area(const Vec3 &bmin, const Vec3 &bmax)
+{
+	Vec3 d = bmax - bmin;
+	return d.x * d.y + d.y * d.z + d.z * d.x;
+}
+
+BVH::BVH()
+{
+	verts = 0;
+	indices = 0;
+	num_tris = 0;
+}
+
+void BVH::get_tri(int idx, Vec3 *v) const
+{
+	if(indices) {
+		const unsigned int *tri = indices + idx * 3;
+		v[0] = verts[tri[0]];
+		v[1] = verts[tri[1]];
+		v[2] = verts[tri[2]];
+	} else {
+		v[0] = verts[idx * 3];
+		v[1] = verts[idx * 3 + 1];
+		v[2] = verts[idx * 3 + 2];
+	}
+}
+
+bool BVH::build(const Vec3 *verts, const unsigned int *indices, int num_tris, int num_threads)
+{
+	nodes.clear();
+	prims.clear();
+	if(!verts || num_tris <= 0) {
+		return false;
+	}
+	this->verts = verts;
+	this->indices = indices;
+	this->num_tris = num_tris;
+
+	if(num_threads <= 0) {
+		num_threads = std::thread::hardware_concurrency();
+	}
+	/* each level of parallel recursion doubles the number of threads */
+	int par_depth = 0;
+	while((1 << par_depth) < num_threads) {
+		par_depth++;
+	}
+
+	BuildData bd;
+	bd.tri_bmin.resize(num_tris);
+	bd.tri_bmax.resize(num_tris);
+	bd.centroid.resize(num_tris);
+	for(int i=0; i<num_tris; i++) {
+		Vec3 v[3];
+		get_tri(i, v);
+		bd.tri_bmin[i] = bd.tri_bmax[i] = v[0];
+		expand(bd.tri_bmin[i], bd.tri_bmax[i], v[1], v[1]);
+		expand(bd.tri_bmin[i], bd.tri_bmax[i], v[2], v[2]);
+		bd.centroid[i] = (bd.tri_bmin[i] + bd.tri_bmax[i]) * 0.5f;
+	}
+
+	prims.resize(num_tris);
+	for(int i=0; i<num_tris; i++) {
+		prims[i] = i;
+	}
+
+	/* a binary tree with at least one primitive per leaf has at most
+	 * 2n - 1 nodes. Pre-allocating all of them means threads can grab nodes
+	 * with an atomic increment.
+	 */
+	std::vector<BVHNode> tmp_nodes(2 * num_tris - 1);
+	bd.nodes = &tmp_nodes[0];
+	bd.prims = &prims[0];
+	bd.num_nodes = 1;
+
+	build_node(&bd, 0, 0, num_tris, 0, par_depth);
+
+	if(par_depth > 0) {
+		/* threads allocate nodes in an interleaved order; lay the tree out
+		 * again in depth-first order for better locality during traversal
+		 */
+		nodes.resize(bd.num_nodes);
+		nodes[0] = tmp_nodes[0];
+		int next = 1;
+		relayout(&tmp_nodes[0], 0, &nodes[0], 0, &next);
+	} else {
+		tmp_nodes.resize(bd.num_nodes);
+		nodes.swap(tmp_nodes);
+	}
+	return true;
+}
+
+static void build_node(BuildData *bd, int nidx, int begin, int end, int depth, int par_depth)
+{
+	BVHNode *node = bd->nodes + nidx;
+	int *prims = bd->prims;
+	int count = end - begin;
+
+	Vec3 bmin = bd->tri_bmin[prims[begin]];
+	Vec3 bmax = bd->tri_bmax[prims[begin]];
+	Vec3 cmin = bd->centroid[prims[begin]];
+	Vec3 cmax = cmin;
+	for(int i=begin+1; i<end; i++) {
+		int p = prims[i];
+		expand(bmin, bmax, bd->tri_bmin[p], bd->tri_bmax[p]);
+		expand(cmin, cmax, bd->centroid[p], bd->centroid[p]);
+	}
+	node->bmin = bmin;
+	node->bmax = bmax;
+
+	if(count <= MAX_LEAF_PRIMS) {
+		node->first = begin;
+		node->count = count;
+		return;
+	}
+
+	/* find the split plane with the lowest SAH cost, among the bin
+	 * boundaries of each axis
+	 */
+	float best_cost = 1e30f;
+	int best_axis = -1, best_split = 0;
+
+	for(int axis=0; axis<3; axis++) {
+		float extent = cmax[axis] - cmin[axis];
+		if(extent <= 0.0f) continue;
+		float scale = NUM_BINS / extent;
+
+		SAHBin bins[NUM_BINS];
+		for(int i=0; i<NUM_BINS; i++) {
+			bins[i].count = 0;
+		}
+		for(int i=begin; i<end; i++) {
+			int p = prims[i];
+			int b = (int)((bd->centroid[p][axis] - cmin[axis]) * scale);
+			if(b >= NUM_BINS) b = NUM_BINS - 1;
+
+			if(bins[b].count++) {
+				expand(bins[b].bmin, bins[b].bmax, bd->tri_bmin[p], bd->tri_bmax[p]);
+			} else {
+				bins[b].bmin = bd->tri_bmin[p];
+				bins[b].bmax = bd->tri_bmax[p];
+			}
+		}
+
+		// sweep from the right, to get the cost of everything right of each split
+		float right_cost[NUM_BINS];
+		Vec3 rmin, rmax;
+		int rcount = 0;
+		for(int i=NUM_BINS-1; i>0; i--) {
+			if(bins[i].count) {
+				if(rcount) {
+					expand(rmin, rmax, bins[i].bmin, bins[i].bmax);
+				} else {
+					rmin = bins[i].bmin;
+					rmax = bins[i].bmax;
+				}
+				rcount += bins[i].count;
+			}
+			right_cost[i] = rcount ? rcount * half_area(rmin, rmax) : 0.0f;
+		}
+
+		// then from the left, adding the right cost for each split
+		Vec3 lmin, lmax;
+		int lcount = 0;
+		for(int i=0; i<NUM_BINS-1; i++) {
+			if(bins[i].count) {
+				if(lcount) {
+					expand(lmin, lmax, bins[i].bmin, bins[i].bmax);
+				} else {
+					lmin = bins[i].bmin;
+					lmax = bins[i].bmax;
+				}
+				lcount += bins[i].count;
+			}
+			if(!lcount || lcount == count) continue;
+
+			float cost = lcount * half_area(lmin, lmax) + right_cost[i + 1];
+			if(cost < best_cost) {
+				best_cost = cost;
+				best_axis = axis;
+				best_split = i;
+			}
+		}
+	}
+
+	int mid;
+	if(best_axis == -1) {
+		/* all centroids coincide, there is no useful split. Just halve the
+		 * primitive range, so that leaves stay small.
+		 */
+		mid = begin + count / 2;
+	} else if(depth >= MAX_SAH_DEPTH) {
+		// median split along the largest centroid extent
+		Vec3 ext = cmax - cmin;
+		CentroidLess less;
+		less.centroid = &bd->centroid[0];
+		less.axis = ext.x > ext.y ? (ext.x > ext.z ? 0 : 2) : (ext.y > ext.z ? 1 : 2);
+		mid = begin + count / 2;
+		std::nth_element(prims + begin, prims + mid, prims + end, less);
+	} else {
+		float area = half_area(bmin, bmax);
+		float leaf_cost = count * area;
+		if(TRAVERSAL_COST * area + best_cost >= leaf_cost && count <= MAX_LEAF_PRIMS * 4) {
+			node->first = begin;
+			node->count = count;
+			return;
+		}
+
+		SplitPred pred;
+		pred.centroid = &bd->centroid[0];
+		pred.axis = best_axis;
+		pred.split = best_split;
+		pred.cmin = cmin[best_axis];
+		pred.scale = NUM_BINS / (cmax[best_axis] - cmin[best_axis]);
+		mid = std::partition(prims + begin, prims + end, pred) - prims;
+	}
+
+	int left = bd->num_nodes.fetch_add(2);
+	node->first = left;
+	node->count = 0;
+
+	if(par_depth > 0 && count >= MIN_PARALLEL) {
+		std::thread thr(build_node, bd, left, begin, mid, depth + 1, par_depth - 1);
+		build_node(bd, left + 1, mid, end, depth + 1, par_depth - 1);
+		thr.join();
+	} else {
+		build_node(bd, left, begin, mid, depth + 1, 0);
+		build_node(bd, left + 1, mid, end, depth + 1, 0);
+	}
+}
+
+/* copies the children of node sidx in src, to dest in depth-first order.
+ * dest[didx] is expected to already be a copy of src[sidx], and gets its child
+ * index updated. next is the next free node index in dest.
+ */
+static void relayout(const BVHNode *src, int sidx, BVHNode *dest, int didx, int *next)
+{
+	const BVHNode *snode = src + sidx;
+	if(snode->count) return;
+
+	int left = *next;
+	*next += 2;
+	dest[left] = src[snode->first];
+	dest[left + 1] = src[snode->first + 1];
+	dest[didx].first = left;
+
+	relayout(src, snode->first, dest, left, next);
+	relayout(src, snode->first + 1, dest, left + 1, next);
+}
+
+void BVH::refit()
+{
+	/* children are always stored after their parents, so going backwards
+	 * through the array updates all children before their parent
+	 */
+	for(int i=(int)nodes.size()-1; i>=0; i--) {
+		BVHNode *node = &nodes[i];
+
+		if(node->count) {
+			Vec3 v[3];
+			get_tri(prims[node->first], v);
+			node->bmin = node->bmax = v[0];
+			for(int j=0; j<node->count; j++) {
+				get_tri(prims[node->first + j], v);
+				for(int k=0; k<3; k++) {
+					expand(node->bmin, node->bmax, v[k], v[k]);
+				}
+			}
+		} else {
+			const BVHNode *left = &nodes[node->first];
+			const BVHNode *right = left + 1;
+			node->bmin = left->bmin;
+			node->bmax = left->bmax;
+			expand(node->bmin, node->bmax, right->bmin, right->bmax);
+		}
+	}
+}
+
+bool BVH::intersect(const Ray &ray, RayHit *hit, float tmax) const
+{
+	if(nodes.empty()) return false;
+
+	Vec3 inv_dir = Vec3(1.0f / ray.dir.x, 1.0f / ray.dir.y, 1.0f / ray.dir.z);
+	const BVHNode *root = &nodes[0];
+	if(!intersect_aabb(ray, inv_dir, root->bmin, root->bmax)) {
+		return false;
+	}
+
+	int stack[STACK_SIZE];
+	int top = 0;
+	stack[top++] = 0;
+
+	bool found = false;
+	float tnearest = tmax;
+
+	while(top > 0) {
+		const BVHNode *node = &nodes[stack[--top]];
+
+		if(node->count) {
+			for(int i=0; i<node->count; i++) {
+				int p = prims[node->first + i];
+				Vec3 v[3], bary;
+				float t;
+				get_tri(p, v);
+				if(intersect_triangle(ray, v[0], v[1], v[2], &t, &bary) && t <= tnearest) {
+					tnearest = t;
+					found = true;
+					if(hit) {
+						hit->t = t;
+						hit->prim = p;
+						hit->bary = bary;
+					}
+				}
+			}
+			continue;
+		}
+
+		/* visit the nearest child first, and skip children which start
+		 * further away than the nearest hit so far
+		 */
+		const BVHNode *left = &nodes[node->first];
+		const BVHNode *right = left + 1;
+		float tleft, tright;
+		bool hit_left = intersect_aabb(ray, inv_dir, left->bmin, left->bmax, &tleft) && tleft <= tnearest;
+		bool hit_right = intersect_aabb(ray, inv_dir, right->bmin, right->bmax, &tright) && tright <= tnearest;
+
+		if(hit_left && hit_right) {
+			if(tleft < tright) {
+				stack[top++] = node->first + 1;
+				stack[top++] = node->first;
+			} else {
+				stack[top++] = node->first;
+				stack[top++] = node->first + 1;
+			}
+		} else if(hit_left) {
+			stack[top++] = node->first;
+		} else if(hit_right) {
+			stack[top++] = node->first + 1;
+		}
+	}
+	return found;
+}
+
+bool BVH::occluded(const Ray &ray, float tmax) const
+{
+	if(nodes.empty()) return false;
+
+	Vec3 inv_dir = Vec3(1.0f / ray.dir.x, 1.0f / ray.dir.y, 1.0f / ray.dir.z);
+
+	int stack[STACK_SIZE];
+	int top = 0;
+	stack[top++] = 0;
+
+	while(top > 0) {
+		const BVHNode *node = &nodes[stack[--top]];
+
+		float tnear;
+		if(!intersect_aabb(ray, inv_dir, node->bmin, node->bmax, &tnear) || tnear > tmax) {
+			continue;
+		}
+
+		if(node->count) {
+			for(int i=0; i<node->count; i++) {
+				Vec3 v[3];
+				float t;
+				get_tri(prims[node->first + i], v);
+				if(intersect_triangle(ray, v[0], v[1], v[2], &t) && t <= tmax) {
+					return true;
+				}
+			}
+		} else {
+			stack[top++] = node->first + 1;
+			stack[top++] = node->first;
+		}
+	}
+	return false;
+}
+
+const BVHNode *BVH::get_nodes() const
+{
+	return nodes.empty() ? 0 : &nodes[0];
+}
+
+int BVH::get_node_count() const
+{
+	return (int)nodes.size();
+}
+
+const int *BVH::get_prims() const
+{
+	return prims.empty() ? 0 : &prims[0];
+}
+
+}	// namespace gph
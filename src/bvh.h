@@ -0,0 +1,81 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#ifndef GMATH_BVH_H_
+#define GMATH_BVH_H_
+
+#include "config.h"
+
+#include <vector>
+#include "vector.h"
+#include "ray.h"
+
+namespace gph {
+
+/* 32 byte BVH node. Interior nodes have count == 0, and their two children
+ * are stored next to each other, at indices first and first + 1. Leaf nodes
+ * reference count primitives starting at index first of the BVH primitive
+ * index array.
+ */
+struct GPH_MATH_API BVHNode {
+	Vec3 bmin;
+	int first;
+	Vec3 bmax;
+	int count;
+};
+
+struct GPH_MATH_API RayHit {
+	float t;	// parametric distance along the ray
+	int prim;	// index of the triangle which was hit
+	Vec3 bary;	// barycentric coordinates of the hit point in that triangle
+};
+
+/* Bounding volume hierarchy over a triangle mesh, for ray casting.
+ *
+ * The tree is built with the surface area heuristic, evaluated over a fixed
+ * number of bins along each axis. The top levels of the tree are built in
+ * parallel by num_threads threads (0 means as many as the hardware supports).
+ *
+ * The mesh data are not copied; they must remain valid for as long as the BVH
+ * is used. If the vertices are modified (e.g. animated), call refit to update
+ * the node bounds without rebuilding the tree.
+ */
+class GPH_MATH_API BVH {
+private:
+	std::vector<BVHNode> nodes;
+	std::vector<int> prims;
+
+	const Vec3 *verts;
+	const unsigned int *indices;
+	int num_tris;
+
+	void get_tri(int idx, Vec3 *v) const;
+
+public:
+	BVH();
+
+	/* indices has 3 entries per triangle, or is null for non-indexed meshes,
+	 * in which case every 3 consecutive vertices form a triangle
+	 */
+	bool build(const Vec3 *verts, const unsigned int *indices, int num_tris, int num_threads = 0);
+	void refit();
+
+	// find the closest hit with t in [0, tmax]
+	bool intersect(const Ray &ray, RayHit *hit = 0, float tmax = 1e30f) const;
+	// find out if there's any hit with t in [0, tmax], returning early
+	bool occluded(const Ray &ray, float tmax = 1e30f) const;
+
+	const BVHNode *get_nodes() const;
+	int get_node_count() const;
+	const int *get_prims() const;
+};
+
+}	// namespace gph
+
+#endif	// GMATH_BVH_H_
@@ -0,0 +1,109 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#include <math.h>
+#include "dualquat.h"
+
+namespace gph {
+
+const DualQuat DualQuat::identity;
+
+DualQuat::DualQuat(const Mat4 &m)
+{
+	// get_rotation expects an orthonormal upper 3x3
+	Mat4 rmat = m;
+	for(int i=0; i<3; i++) {
+		Vec3 col = gph::normalize(Vec3(rmat[i][0], rmat[i][1], rmat[i][2]));
+		rmat[i][0] = col.x;
+		rmat[i][1] = col.y;
+		rmat[i][2] = col.z;
+	}
+
+	*this = DualQuat(gph::normalize(rmat.get_rotation()), m.get_translation());
+}
+
+/* a * (conjugate(a) * b)^t, where the power is taken by converting to screw
+ * parameters: a rotation by angle about an axis l passing through a point with
+ * moment m, and a translation by pitch along that axis. The power scales the
+ * angle and pitch by t.
+ */
+DualQuat sclerp(const DualQuat &a, const DualQuat &b, float t)
+{
+	DualQuat diff = conjugate(a) * b;
+	if(diff.real.w < 0.0f) {
+		diff = -diff;	// shortest path
+	}
+
+	Vec3 rv = Vec3(diff.real.x, diff.real.y, diff.real.z);
+	Vec3 dv = Vec3(diff.dual.x, diff.dual.y, diff.dual.z);
+
+	float sin_half = length(rv);
+	if(sin_half < 1e-6f) {
+		// pure translation, the screw axis is undefined
+		return a * DualQuat(Quat(), diff.get_translation() * t);
+	}
+	float cos_half = diff.real.w;
+	float half_angle = atan2(sin_half, cos_half);
+
+	Vec3 l = rv / sin_half;
+	float pitch = -2.0f * diff.dual.w / sin_half;
+	Vec3 m = (dv - l * (pitch * 0.5f * cos_half)) / sin_half;
+
+	half_angle *= t;
+	pitch *= t;
+	sin_half = sin(half_angle);
+	cos_half = cos(half_angle);
+
+	Quat real = Quat(l * sin_half, cos_half);
+	Quat dual = Quat(m * sin_half + l * (pitch * 0.5f * cos_half), -pitch * 0.5f * sin_half);
+	return a * DualQuat(real, dual);
+}
+
+DualQuat dlb(const DualQuat *dq, const float *weights, int count)
+{
+	if(count <= 0) {
+		return DualQuat();
+	}
+
+	DualQuat res = dq[0] * weights[0];
+	for(int i=1; i<count; i++) {
+		float d = dot(dq[0].real, dq[i].real);
+		res += dq[i] * (d < 0.0f ? -weights[i] : weights[i]);
+	}
+	return normalize(res);
+}
+
+void dlb(DualQuat *dest, const DualQuat *bones, const int *bone_idx,
+		const float *weights, int num_infl, int count)
+{
+	for(int i=0; i<count; i++) {
+		/* the first influence sets the hemisphere; skinning data usually
+		 * has the bones sorted by decreasing weight
+		 */
+		const DualQuat &first = bones[bone_idx[0]];
+		DualQuat res = first * weights[0];
+
+		for(int j=1; j<num_infl; j++) {
+			float w = weights[j];
+			if(w == 0.0f) continue;
+
+			const DualQuat &dq = bones[bone_idx[j]];
+			if(dot(first.real, dq.real) < 0.0f) {
+				w = -w;
+			}
+			res += dq * w;
+		}
+		dest[i] = normalize(res);
+
+		bone_idx += num_infl;
+		weights += num_infl;
+	}
+}
+
+}	// namespace gph
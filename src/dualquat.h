@@ -0,0 +1,107 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#ifndef GMATH_DUALQUAT_H_
+#define GMATH_DUALQUAT_H_
+
+#include "config.h"
+
+#include "vector.h"
+#include "matrix.h"
+#include "quat.h"
+
+/* Dual quaternions: real + e dual, with e^2 = 0. A unit dual quaternion
+ * represents a rigid transformation (rotation followed by translation) in 8
+ * floats: real is the rotation quaternion, and dual is 0.5 * t * real, where t
+ * is the translation as a pure quaternion.
+ *
+ * Like with Quat, a * b is the transformation which applies b first and then
+ * a; the opposite order from Mat4 multiplication.
+ *
+ * Blending unit dual quaternions (dlb) and renormalizing gives a rigid
+ * transformation, without the volume loss of blending matrices, which makes
+ * them ideal for skinning (Kavan et al. "Skinning with dual quaternions").
+ */
+
+namespace gph {
+
+class GPH_MATH_API DualQuat {
+public:
+	Quat real, dual;
+
+	static const DualQuat identity;
+
+	constexpr DualQuat() : real(0, 0, 0, 1), dual(0, 0, 0, 0) {}
+	constexpr DualQuat(const Quat &real_, const Quat &dual_) : real(real_), dual(dual_) {}
+	// rotation by the unit quaternion rot, followed by translation by trans
+	inline DualQuat(const Quat &rot, const Vec3 &trans);
+	/* from a rotation and translation matrix. Scaling is not representable
+	 * and gets dropped.
+	 */
+	explicit DualQuat(const Mat4 &m);
+
+	inline void normalize();
+	inline void conjugate();
+
+	inline Quat get_rotation() const;
+	inline Vec3 get_translation() const;
+	inline Mat4 calc_matrix() const;
+};
+
+inline GPH_MATH_API DualQuat operator -(const DualQuat &dq);
+inline GPH_MATH_API DualQuat operator +(const DualQuat &a, const DualQuat &b);
+inline GPH_MATH_API DualQuat operator -(const DualQuat &a, const DualQuat &b);
+inline GPH_MATH_API DualQuat operator *(const DualQuat &a, const DualQuat &b);
+inline GPH_MATH_API DualQuat operator *(const DualQuat &dq, float s);
+inline GPH_MATH_API DualQuat operator *(float s, const DualQuat &dq);
+
+inline GPH_MATH_API DualQuat &operator +=(DualQuat &a, const DualQuat &b);
+inline GPH_MATH_API DualQuat &operator -=(DualQuat &a, const DualQuat &b);
+inline GPH_MATH_API DualQuat &operator *=(DualQuat &a, const DualQuat &b);
+inline GPH_MATH_API DualQuat &operator *=(DualQuat &dq, float s);
+
+/* makes the real part unit length, and the dual part orthogonal to it, so that
+ * dq is a rigid transformation again
+ */
+inline GPH_MATH_API DualQuat normalize(const DualQuat &dq);
+// quaternion conjugate of both parts; the inverse of a unit dual quaternion
+inline GPH_MATH_API DualQuat conjugate(const DualQuat &dq);
+
+/* transform points and vectors by the unit dual quaternion dq, same as
+ * multiplying by calc_matrix(). Vectors are only rotated.
+ */
+inline GPH_MATH_API Vec3 transform_point(const DualQuat &dq, const Vec3 &p);
+inline GPH_MATH_API Vec3 transform_vector(const DualQuat &dq, const Vec3 &v);
+
+/* screw linear interpolation: constant speed motion along the screw axis
+ * taking a to b, which is the dual quaternion counterpart of slerp.
+ */
+GPH_MATH_API DualQuat sclerp(const DualQuat &a, const DualQuat &b, float t);
+
+/* dual quaternion linear blending: normalized weighted sum of count unit dual
+ * quaternions. Each one is flipped if needed, to lie in the same hemisphere as
+ * the first, so that the blend takes the shortest path. Much cheaper than
+ * sclerp, and a very close approximation for skinning.
+ */
+inline GPH_MATH_API DualQuat dlb(const DualQuat &a, const DualQuat &b, float t);
+GPH_MATH_API DualQuat dlb(const DualQuat *dq, const float *weights, int count);
+
+/* batch blending for skinning, with num_infl bones influencing each vertex.
+ * For vertex i, the bone indices and weights are the num_infl consecutive
+ * elements starting at bone_idx[i * num_infl] and weights[i * num_infl], and
+ * dest[i] is the dlb of the corresponding bones. Zero weights are skipped.
+ */
+GPH_MATH_API void dlb(DualQuat *dest, const DualQuat *bones, const int *bone_idx,
+		const float *weights, int num_infl, int count);
+
+#include "dualquat.inl"
+
+}	// namespace gph
+
+#endif	// GMATH_DUALQUAT_H_
@@ -0,0 +1,147 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+
+inline DualQuat::DualQuat(const Quat &rot, const Vec3 &trans)
+	: real(rot)
+{
+	// 0.5 * (trans, 0) * rot
+	Vec3 rv = Vec3(rot.x, rot.y, rot.z);
+	Vec3 dv = (trans * rot.w + cross(trans, rv)) * 0.5f;
+	dual = Quat(dv, -0.5f * dot(trans, rv));
+}
+
+inline DualQuat operator -(const DualQuat &dq)
+{
+	return DualQuat(-dq.real, -dq.dual);
+}
+
+inline DualQuat operator +(const DualQuat &a, const DualQuat &b)
+{
+	return DualQuat(a.real + b.real, a.dual + b.dual);
+}
+
+inline DualQuat operator -(const DualQuat &a, const DualQuat &b)
+{
+	return DualQuat(a.real - b.real, a.dual - b.dual);
+}
+
+inline DualQuat operator *(const DualQuat &a, const DualQuat &b)
+{
+	return DualQuat(a.real * b.real, a.real * b.dual + a.dual * b.real);
+}
+
+inline DualQuat operator *(const DualQuat &dq, float s)
+{
+	const Quat &r = dq.real;
+	const Quat &d = dq.dual;
+	return DualQuat(Quat(r.x * s, r.y * s, r.z * s, r.w * s), Quat(d.x * s, d.y * s, d.z * s, d.w * s));
+}
+
+inline DualQuat operator *(float s, const DualQuat &dq)
+{
+	return dq * s;
+}
+
+inline DualQuat &operator +=(DualQuat &a, const DualQuat &b)
+{
+	a.real += b.real;
+	a.dual += b.dual;
+	return a;
+}
+
+inline DualQuat &operator -=(DualQuat &a, const DualQuat &b)
+{
+	a.real -= b.real;
+	a.dual -= b.dual;
+	return a;
+}
+
+inline DualQuat &operator *=(DualQuat &a, const DualQuat &b)
+{
+	a = a * b;
+	return a;
+}
+
+inline DualQuat &operator *=(DualQuat &dq, float s)
+{
+	dq = dq * s;
+	return dq;
+}
+
+inline void DualQuat::normalize()
+{
+	*this = gph::normalize(*this);
+}
+
+inline DualQuat normalize(const DualQuat &dq)
+{
+	float len = length(dq.real);
+	if(len == 0.0f) {
+		return dq;
+	}
+	float s = 1.0f / len;
+	Quat r = Quat(dq.real.x * s, dq.real.y * s, dq.real.z * s, dq.real.w * s);
+	Quat d = Quat(dq.dual.x * s, dq.dual.y * s, dq.dual.z * s, dq.dual.w * s);
+
+	// remove the part of the dual parallel to the real
+	float rd = dot(r, d);
+	d -= Quat(r.x * rd, r.y * rd, r.z * rd, r.w * rd);
+	return DualQuat(r, d);
+}
+
+inline void DualQuat::conjugate()
+{
+	real.conjugate();
+	dual.conjugate();
+}
+
+inline DualQuat conjugate(const DualQuat &dq)
+{
+	return DualQuat(conjugate(dq.real), conjugate(dq.dual));
+}
+
+inline Quat DualQuat::get_rotation() const
+{
+	return real;
+}
+
+// 2 * dual * conjugate(real)
+inline Vec3 DualQuat::get_translation() const
+{
+	Vec3 rv = Vec3(real.x, real.y, real.z);
+	Vec3 dv = Vec3(dual.x, dual.y, dual.z);
+	return (dv * real.w - rv * dual.w + cross(rv, dv)) * 2.0f;
+}
+
+inline Mat4 DualQuat::calc_matrix() const
+{
+	Mat4 res = real.calc_matrix();
+	Vec3 t = get_translation();
+	res[3][0] = t.x;
+	res[3][1] = t.y;
+	res[3][2] = t.z;
+	return res;
+}
+
+inline Vec3 transform_point(const DualQuat &dq, const Vec3 &p)
+{
+	return rotate_unit(p, dq.real) + dq.get_translation();
+}
+
+inline Vec3 transform_vector(const DualQuat &dq, const Vec3 &v)
+{
+	return rotate_unit(v, dq.real);
+}
+
+inline DualQuat dlb(const DualQuat &a, const DualQuat &b, float t)
+{
+	float d = dot(a.real, b.real);
+	return normalize(a * (1.0f - t) + b * (d < 0.0f ? -t : t));
+}
@@ -0,0 +1,791 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+
+#if !defined(GPH_SIMD_SSE) && !defined(GPH_SIMD_NEON)
+/* the scalar fallback keeps masks as floats with all bits set, and needs
+ * to get at the bits to combine them
+ */
+inline unsigned int float_bits(float f)
+{
+	unsigned int u;
+	memcpy(&u, &f, sizeof u);
+	return u;
+}
+
+inline float bits_float(unsigned int u)
+{
+	float f;
+	memcpy(&f, &u, sizeof f);
+	return f;
+}
+
+inline float mask_float(bool b)
+{
+	return bits_float(b ? 0xffffffff : 0);
+}
+#endif
+
+// ---- Float4 ----
+
+#if defined(GPH_SIMD_SSE)
+inline Float4::Float4() : v(_mm_setzero_ps()) {}
+inline Float4::Float4(float s) : v(_mm_set1_ps(s)) {}
+inline Float4::Float4(float a, float b, float c, float d) : v(_mm_setr_ps(a, b, c, d)) {}
+inline Float4::Float4(const float *ptr) : v(_mm_loadu_ps(ptr)) {}
+
+inline void Float4::store(float *ptr) const
+{
+	_mm_storeu_ps(ptr, v);
+}
+
+#elif defined(GPH_SIMD_NEON)
+inline Float4::Float4() : v(vdupq_n_f32(0.0f)) {}
+inline Float4::Float4(float s) : v(vdupq_n_f32(s)) {}
+
+inline Float4::Float4(float a, float b, float c, float d)
+{
+	float tmp[] = {a, b, c, d};
+	v = vld1q_f32(tmp);
+}
+
+inline Float4::Float4(const float *ptr) : v(vld1q_f32(ptr)) {}
+
+inline void Float4::store(float *ptr) const
+{
+	vst1q_f32(ptr, v);
+}
+
+#else
+inline Float4::Float4()
+{
+	v[0] = v[1] = v[2] = v[3] = 0.0f;
+}
+
+inline Float4::Float4(float s)
+{
+	v[0] = v[1] = v[2] = v[3] = s;
+}
+
+inline Float4::Float4(float a, float b, float c, float d)
+{
+	v[0] = a; v[1] = b; v[2] = c; v[3] = d;
+}
+
+inline Float4::Float4(const float *ptr)
+{
+	v[0] = ptr[0]; v[1] = ptr[1]; v[2] = ptr[2]; v[3] = ptr[3];
+}
+
+inline void Float4::store(float *ptr) const
+{
+	ptr[0] = v[0]; ptr[1] = v[1]; ptr[2] = v[2]; ptr[3] = v[3];
+}
+#endif
+
+inline float Float4::operator [](int idx) const
+{
+	float tmp[4];
+	store(tmp);
+	return tmp[idx];
+}
+
+#if defined(GPH_SIMD_SSE)
+inline Float4 operator -(const Float4 &a)
+{
+	return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f));
+}
+
+inline Float4 operator +(const Float4 &a, const Float4 &b)
+{
+	return _mm_add_ps(a.v, b.v);
+}
+
+inline Float4 operator -(const Float4 &a, const Float4 &b)
+{
+	return _mm_sub_ps(a.v, b.v);
+}
+
+inline Float4 operator *(const Float4 &a, const Float4 &b)
+{
+	return _mm_mul_ps(a.v, b.v);
+}
+
+inline Float4 operator /(const Float4 &a, const Float4 &b)
+{
+	return _mm_div_ps(a.v, b.v);
+}
+
+inline Float4 operator <(const Float4 &a, const Float4 &b)
+{
+	return _mm_cmplt_ps(a.v, b.v);
+}
+
+inline Float4 operator <=(const Float4 &a, const Float4 &b)
+{
+	return _mm_cmple_ps(a.v, b.v);
+}
+
+inline Float4 operator >(const Float4 &a, const Float4 &b)
+{
+	return _mm_cmpgt_ps(a.v, b.v);
+}
+
+inline Float4 operator >=(const Float4 &a, const Float4 &b)
+{
+	return _mm_cmpge_ps(a.v, b.v);
+}
+
+inline Float4 operator ==(const Float4 &a, const Float4 &b)
+{
+	return _mm_cmpeq_ps(a.v, b.v);
+}
+
+inline Float4 operator !=(const Float4 &a, const Float4 &b)
+{
+	return _mm_cmpneq_ps(a.v, b.v);
+}
+
+inline Float4 operator &(const Float4 &a, const Float4 &b)
+{
+	return _mm_and_ps(a.v, b.v);
+}
+
+inline Float4 operator |(const Float4 &a, const Float4 &b)
+{
+	return _mm_or_ps(a.v, b.v);
+}
+
+inline Float4 operator ^(const Float4 &a, const Float4 &b)
+{
+	return _mm_xor_ps(a.v, b.v);
+}
+
+inline Float4 andnot(const Float4 &a, const Float4 &b)
+{
+	return _mm_andnot_ps(b.v, a.v);
+}
+
+inline Float4 select(const Float4 &mask, const Float4 &a, const Float4 &b)
+{
+	return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+}
+
+inline int movemask(const Float4 &mask)
+{
+	return _mm_movemask_ps(mask.v);
+}
+
+inline Float4 min(const Float4 &a, const Float4 &b)
+{
+	return _mm_min_ps(a.v, b.v);
+}
+
+inline Float4 max(const Float4 &a, const Float4 &b)
+{
+	return _mm_max_ps(a.v, b.v);
+}
+
+inline Float4 vsqrt(const Float4 &a)
+{
+	return _mm_sqrt_ps(a.v);
+}
+
+inline Float4 vabs(const Float4 &a)
+{
+	return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v);
+}
+
+#elif defined(GPH_SIMD_NEON)
+inline Float4 operator -(const Float4 &a)
+{
+	return vnegq_f32(a.v);
+}
+
+inline Float4 operator +(const Float4 &a, const Float4 &b)
+{
+	return vaddq_f32(a.v, b.v);
+}
+
+inline Float4 operator -(const Float4 &a, const Float4 &b)
+{
+	return vsubq_f32(a.v, b.v);
+}
+
+inline Float4 operator *(const Float4 &a, const Float4 &b)
+{
+	return vmulq_f32(a.v, b.v);
+}
+
+inline Float4 operator /(const Float4 &a, const Float4 &b)
+{
+#ifdef __aarch64__
+	return vdivq_f32(a.v, b.v);
+#else
+	// reciprocal estimate refined with two newton-raphson steps
+	float32x4_t rcp = vrecpeq_f32(b.v);
+	rcp = vmulq_f32(vrecpsq_f32(b.v, rcp), rcp);
+	rcp = vmulq_f32(vrecpsq_f32(b.v, rcp), rcp);
+	return vmulq_f32(a.v, rcp);
+#endif
+}
+
+inline Float4 operator <(const Float4 &a, const Float4 &b)
+{
+	return vreinterpretq_f32_u32(vcltq_f32(a.v, b.v));
+}
+
+inline Float4 operator <=(const Float4 &a, const Float4 &b)
+{
+	return vreinterpretq_f32_u32(vcleq_f32(a.v, b.v));
+}
+
+inline Float4 operator >(const Float4 &a, const Float4 &b)
+{
+	return vreinterpretq_f32_u32(vcgtq_f32(a.v, b.v));
+}
+
+inline Float4 operator >=(const Float4 &a, const Float4 &b)
+{
+	return vreinterpretq_f32_u32(vcgeq_f32(a.v, b.v));
+}
+
+inline Float4 operator ==(const Float4 &a, const Float4 &b)
+{
+	return vreinterpretq_f32_u32(vceqq_f32(a.v, b.v));
+}
+
+inline Float4 operator !=(const Float4 &a, const Float4 &b)
+{
+	return vreinterpretq_f32_u32(vmvnq_u32(vceqq_f32(a.v, b.v)));
+}
+
+inline Float4 operator &(const Float4 &a, const Float4 &b)
+{
+	return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a.v), vreinterpretq_u32_f32(b.v)));
+}
+
+inline Float4 operator |(const Float4 &a, const Float4 &b)
+{
+	return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a.v), vreinterpretq_u32_f32(b.v)));
+}
+
+inline Float4 operator ^(const Float4 &a, const Float4 &b)
+{
+	return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a.v), vreinterpretq_u32_f32(b.v)));
+}
+
+inline Float4 andnot(const Float4 &a, const Float4 &b)
+{
+	return vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(a.v), vreinterpretq_u32_f32(b.v)));
+}
+
+inline Float4 select(const Float4 &mask, const Float4 &a, const Float4 &b)
+{
+	return vbslq_f32(vreinterpretq_u32_f32(mask.v), a.v, b.v);
+}
+
+inline int movemask(const Float4 &mask)
+{
+	uint32x4_t bits = vshrq_n_u32(vreinterpretq_u32_f32(mask.v), 31);
+	return vgetq_lane_u32(bits, 0) | (vgetq_lane_u32(bits, 1) << 1) |
+		(vgetq_lane_u32(bits, 2) << 2) | (vgetq_lane_u32(bits, 3) << 3);
+}
+
+inline Float4 min(const Float4 &a, const Float4 &b)
+{
+	return vminq_f32(a.v, b.v);
+}
+
+inline Float4 max(const Float4 &a, const Float4 &b)
+{
+	return vmaxq_f32(a.v, b.v);
+}
+
+inline Float4 vsqrt(const Float4 &a)
+{
+#ifdef __aarch64__
+	return vsqrtq_f32(a.v);
+#else
+	// x * 1/sqrt(x), with the reciprocal square root estimate refined
+	float32x4_t rsq = vrsqrteq_f32(a.v);
+	rsq = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a.v, rsq), rsq), rsq);
+	rsq = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a.v, rsq), rsq), rsq);
+	float32x4_t res = vmulq_f32(a.v, rsq);
+	// sqrt(0) would come out as 0 * inf = nan
+	return vbslq_f32(vceqq_f32(a.v, vdupq_n_f32(0.0f)), a.v, res);
+#endif
+}
+
+inline Float4 vabs(const Float4 &a)
+{
+	return vabsq_f32(a.v);
+}
+
+#else	/* scalar fallback */
+inline Float4 operator -(const Float4 &a)
+{
+	return Float4(-a.v[0], -a.v[1], -a.v[2], -a.v[3]);
+}
+
+inline Float4 operator +(const Float4 &a, const Float4 &b)
+{
+	return Float4(a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]);
+}
+
+inline Float4 operator -(const Float4 &a, const Float4 &b)
+{
+	return Float4(a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]);
+}
+
+inline Float4 operator *(const Float4 &a, const Float4 &b)
+{
+	return Float4(a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]);
+}
+
+inline Float4 operator /(const Float4 &a, const Float4 &b)
+{
+	return Float4(a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3]);
+}
+
+inline Float4 operator <(const Float4 &a, const Float4 &b)
+{
+	return Float4(mask_float(a.v[0] < b.v[0]), mask_float(a.v[1] < b.v[1]),
+			mask_float(a.v[2] < b.v[2]), mask_float(a.v[3] < b.v[3]));
+}
+
+inline Float4 operator <=(const Float4 &a, const Float4 &b)
+{
+	return Float4(mask_float(a.v[0] <= b.v[0]), mask_float(a.v[1] <= b.v[1]),
+			mask_float(a.v[2] <= b.v[2]), mask_float(a.v[3] <= b.v[3]));
+}
+
+inline Float4 operator >(const Float4 &a, const Float4 &b)
+{
+	return Float4(mask_float(a.v[0] > b.v[0]), mask_float(a.v[1] > b.v[1]),
+			mask_float(a.v[2] > b.v[2]), mask_float(a.v[3] > b.v[3]));
+}
+
+inline Float4 operator >=(const Float4 &a, const Float4 &b)
+{
+	return Float4(mask_float(a.v[0] >= b.v[0]), mask_float(a.v[1] >= b.v[1]),
+			mask_float(a.v[2] >= b.v[2]), mask_float(a.v[3] >= b.v[3]));
+}
+
+inline Float4 operator ==(const Float4 &a, const Float4 &b)
+{
+	return Float4(mask_float(a.v[0] == b.v[0]), mask_float(a.v[1] == b.v[1]),
+			mask_float(a.v[2] == b.v[2]), mask_float(a.v[3] == b.v[3]));
+}
+
+inline Float4 operator !=(const Float4 &a, const Float4 &b)
+{
+	return Float4(mask_float(a.v[0] != b.v[0]), mask_float(a.v[1] != b.v[1]),
+			mask_float(a.v[2] != b.v[2]), mask_float(a.v[3] != b.v[3]));
+}
+
+inline Float4 operator &(const Float4 &a, const Float4 &b)
+{
+	Float4 res;
+	for(int i=0; i<4; i++) {
+		res.v[i] = bits_float(float_bits(a.v[i]) & float_bits(b.v[i]));
+	}
+	return res;
+}
+
+inline Float4 operator |(const Float4 &a, const Float4 &b)
+{
+	Float4 res;
+	for(int i=0; i<4; i++) {
+		res.v[i] = bits_float(float_bits(a.v[i]) | float_bits(b.v[i]));
+	}
+	return res;
+}
+
+inline Float4 operator ^(const Float4 &a, const Float4 &b)
+{
+	Float4 res;
+	for(int i=0; i<4; i++) {
+		res.v[i] = bits_float(float_bits(a.v[i]) ^ float_bits(b.v[i]));
+	}
+	return res;
+}
+
+inline Float4 andnot(const Float4 &a, const Float4 &b)
+{
+	Float4 res;
+	for(int i=0; i<4; i++) {
+		res.v[i] = bits_float(float_bits(a.v[i]) & ~float_bits(b.v[i]));
+	}
+	return res;
+}
+
+inline Float4 select(const Float4 &mask, const Float4 &a, const Float4 &b)
+{
+	Float4 res;
+	for(int i=0; i<4; i++) {
+		res.v[i] = float_bits(mask.v[i]) ? a.v[i] : b.v[i];
+	}
+	return res;
+}
+
+inline int movemask(const Float4 &mask)
+{
+	int res = 0;
+	for(int i=0; i<4; i++) {
+		res |= (float_bits(mask.v[i]) >> 31) << i;
+	}
+	return res;
+}
+
+inline Float4 min(const Float4 &a, const Float4 &b)
+{
+	return Float4(a.v[0] < b.v[0] ? a.v[0] : b.v[0], a.v[1] < b.v[1] ? a.v[1] : b.v[1],
+			a.v[2] < b.v[2] ? a.v[2] : b.v[2], a.v[3] < b.v[3] ? a.v[3] : b.v[3]);
+}
+
+inline Float4 max(const Float4 &a, const Float4 &b)
+{
+	return Float4(a.v[0] > b.v[0] ? a.v[0] : b.v[0], a.v[1] > b.v[1] ? a.v[1] : b.v[1],
+			a.v[2] > b.v[2] ? a.v[2] : b.v[2], a.v[3] > b.v[3] ? a.v[3] : b.v[3]);
+}
+
+inline Float4 vsqrt(const Float4 &a)
+{
+	return Float4(sqrt(a.v[0]), sqrt(a.v[1]), sqrt(a.v[2]), sqrt(a.v[3]));
+}
+
+inline Float4 vabs(const Float4 &a)
+{
+	return Float4(fabs(a.v[0]), fabs(a.v[1]), fabs(a.v[2]), fabs(a.v[3]));
+}
+#endif
+
+inline Float4 &operator +=(Float4 &a, const Float4 &b)
+{
+	a = a + b;
+	return a;
+}
+
+inline Float4 &operator -=(Float4 &a, const Float4 &b)
+{
+	a = a - b;
+	return a;
+}
+
+inline Float4 &operator *=(Float4 &a, const Float4 &b)
+{
+	a = a * b;
+	return a;
+}
+
+inline Float4 &operator /=(Float4 &a, const Float4 &b)
+{
+	a = a / b;
+	return a;
+}
+
+inline bool any(const Float4 &mask)
+{
+	return movemask(mask) != 0;
+}
+
+inline bool all(const Float4 &mask)
+{
+	return movemask(mask) == 0xf;
+}
+
+inline Float4 lerp(const Float4 &a, const Float4 &b, const Float4 &t)
+{
+	return a + (b - a) * t;
+}
+
+// ---- Float8 ----
+
+#if defined(GPH_SIMD_AVX)
+inline Float8::Float8() : v(_mm256_setzero_ps()) {}
+inline Float8::Float8(float s) : v(_mm256_set1_ps(s)) {}
+inline Float8::Float8(float a, float b, float c, float d, float e, float f, float g, float h)
+	: v(_mm256_setr_ps(a, b, c, d, e, f, g, h)) {}
+inline Float8::Float8(const float *ptr) : v(_mm256_loadu_ps(ptr)) {}
+
+inline void Float8::store(float *ptr) const
+{
+	_mm256_storeu_ps(ptr, v);
+}
+
+inline Float8 operator -(const Float8 &a)
+{
+	return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f));
+}
+
+inline Float8 operator +(const Float8 &a, const Float8 &b)
+{
+	return _mm256_add_ps(a.v, b.v);
+}
+
+inline Float8 operator -(const Float8 &a, const Float8 &b)
+{
+	return _mm256_sub_ps(a.v, b.v);
+}
+
+inline Float8 operator *(const Float8 &a, const Float8 &b)
+{
+	return _mm256_mul_ps(a.v, b.v);
+}
+
+inline Float8 operator /(const Float8 &a, const Float8 &b)
+{
+	return _mm256_div_ps(a.v, b.v);
+}
+
+inline Float8 operator <(const Float8 &a, const Float8 &b)
+{
+	return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ);
+}
+
+inline Float8 operator <=(const Float8 &a, const Float8 &b)
+{
+	return _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ);
+}
+
+inline Float8 operator >(const Float8 &a, const Float8 &b)
+{
+	return _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ);
+}
+
+inline Float8 operator >=(const Float8 &a, const Float8 &b)
+{
+	return _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ);
+}
+
+inline Float8 operator ==(const Float8 &a, const Float8 &b)
+{
+	return _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ);
+}
+
+inline Float8 operator !=(const Float8 &a, const Float8 &b)
+{
+	return _mm256_cmp_ps(a.v, b.v, _CMP_NEQ_UQ);
+}
+
+inline Float8 operator &(const Float8 &a, const Float8 &b)
+{
+	return _mm256_and_ps(a.v, b.v);
+}
+
+inline Float8 operator |(const Float8 &a, const Float8 &b)
+{
+	return _mm256_or_ps(a.v, b.v);
+}
+
+inline Float8 operator ^(const Float8 &a, const Float8 &b)
+{
+	return _mm256_xor_ps(a.v, b.v);
+}
+
+inline Float8 andnot(const Float8 &a, const Float8 &b)
+{
+	return _mm256_andnot_ps(b.v, a.v);
+}
+
+inline Float8 select(const Float8 &mask, const Float8 &a, const Float8 &b)
+{
+	return _mm256_blendv_ps(b.v, a.v, mask.v);
+}
+
+inline int movemask(const Float8 &mask)
+{
+	return _mm256_movemask_ps(mask.v);
+}
+
+inline Float8 min(const Float8 &a, const Float8 &b)
+{
+	return _mm256_min_ps(a.v, b.v);
+}
+
+inline Float8 max(const Float8 &a, const Float8 &b)
+{
+	return _mm256_max_ps(a.v, b.v);
+}
+
+inline Float8 vsqrt(const Float8 &a)
+{
+	return _mm256_sqrt_ps(a.v);
+}
+
+inline Float8 vabs(const Float8 &a)
+{
+	return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v);
+}
+
+#else	/* no AVX, Float8 is a pair of Float4 */
+inline Float8::Float8() {}
+inline Float8::Float8(float s) : lo(s), hi(s) {}
+inline Float8::Float8(float a, float b, float c, float d, float e, float f, float g, float h)
+	: lo(a, b, c, d), hi(e, f, g, h) {}
+inline Float8::Float8(const float *ptr) : lo(ptr), hi(ptr + 4) {}
+
+inline void Float8::store(float *ptr) const
+{
+	lo.store(ptr);
+	hi.store(ptr + 4);
+}
+
+inline Float8 operator -(const Float8 &a)
+{
+	return Float8(-a.lo, -a.hi);
+}
+
+inline Float8 operator +(const Float8 &a, const Float8 &b)
+{
+	return Float8(a.lo + b.lo, a.hi + b.hi);
+}
+
+inline Float8 operator -(const Float8 &a, const Float8 &b)
+{
+	return Float8(a.lo - b.lo, a.hi - b.hi);
+}
+
+inline Float8 operator *(const Float8 &a, const Float8 &b)
+{
+	return Float8(a.lo * b.lo, a.hi * b.hi);
+}
+
+inline Float8 operator /(const Float8 &a, const Float8 &b)
+{
+	return Float8(a.lo / b.lo, a.hi / b.hi);
+}
+
+inline Float8 operator <(const Float8 &a, const Float8 &b)
+{
+	return Float8(a.lo < b.lo, a.hi < b.hi);
+}
+
+inline Float8 operator <=(const Float8 &a, const Float8 &b)
+{
+	return Float8(a.lo <= b.lo, a.hi <= b.hi);
+}
+
+inline Float8 operator >(const Float8 &a, const Float8 &b)
+{
+	return Float8(a.lo > b.lo, a.hi > b.hi);
+}
+
+inline Float8 operator >=(const Float8 &a, const Float8 &b)
+{
+	return Float8(a.lo >= b.lo, a.hi >= b.hi);
+}
+
+inline Float8 operator ==(const Float8 &a, const Float8 &b)
+{
+	return Float8(a.lo == b.lo, a.hi == b.hi);
+}
+
+inline Float8 operator !=(const Float8 &a, const Float8 &b)
+{
+	return Float8(a.lo != b.lo, a.hi != b.hi);
+}
+
+inline Float8 operator &(const Float8 &a, const Float8 &b)
+{
+	return Float8(a.lo & b.lo, a.hi & b.hi);
+}
+
+inline Float8 operator |(const Float8 &a, const Float8 &b)
+{
+	return Float8(a.lo | b.lo, a.hi | b.hi);
+}
+
+inline Float8 operator ^(const Float8 &a, const Float8 &b)
+{
+	return Float8(a.lo ^ b.lo, a.hi ^ b.hi);
+}
+
+inline Float8 andnot(const Float8 &a, const Float8 &b)
+{
+	return Float8(andnot(a.lo, b.lo), andnot(a.hi, b.hi));
+}
+
+inline Float8 select(const Float8 &mask, const Float8 &a, const Float8 &b)
+{
+	return Float8(select(mask.lo, a.lo, b.lo), select(mask.hi, a.hi, b.hi));
+}
+
+inline int movemask(const Float8 &mask)
+{
+	return movemask(mask.lo) | (movemask(mask.hi) << 4);
+}
+
+inline Float8 min(const Float8 &a, const Float8 &b)
+{
+	return Float8(min(a.lo, b.lo), min(a.hi, b.hi));
+}
+
+inline Float8 max(const Float8 &a, const Float8 &b)
+{
+	return Float8(max(a.lo, b.lo), max(a.hi, b.hi));
+}
+
+inline Float8 vsqrt(const Float8 &a)
+{
+	return Float8(vsqrt(a.lo), vsqrt(a.hi));
+}
+
+inline Float8 vabs(const Float8 &a)
+{
+	return Float8(vabs(a.lo), vabs(a.hi));
+}
+#endif
+
+inline float Float8::operator [](int idx) const
+{
+	float tmp[8];
+	store(tmp);
+	return tmp[idx];
+}
+
+inline Float8 &operator +=(Float8 &a, const Float8 &b)
+{
+	a = a + b;
+	return a;
+}
+
+inline Float8 &operator -=(Float8 &a, const Float8 &b)
+{
+	a = a - b;
+	return a;
+}
+
+inline Float8 &operator *=(Float8 &a, const Float8 &b)
+{
+	a = a * b;
+	return a;
+}
+
+inline Float8 &operator /=(Float8 &a, const Float8 &b)
+{
+	a = a / b;
+	return a;
+}
+
+inline bool any(const Float8 &mask)
+{
+	return movemask(mask) != 0;
+}
+
+inline bool all(const Float8 &mask)
+{
+	return movemask(mask) == 0xff;
+}
+
+inline Float8 lerp(const Float8 &a, const Float8 &b, const Float8 &t)
+{
+	return a + (b - a) * t;
+}
@@ -0,0 +1,129 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#include "frustum.h"
+#include "wide.h"
+
+namespace gph {
+
+Frustum::Frustum(const Mat4 &m)
+{
+	set(m);
+}
+
+/* same planes as Mat4::get_frustum_plane: the last row of the matrix plus or
+ * minus each of the first three
+ */
+void Frustum::set(const Mat4 &m)
+{
+	Vec4 w = Vec4(m[0][3], m[1][3], m[2][3], m[3][3]);
+	for(int i=0; i<3; i++) {
+		Vec4 r = Vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+		plane[i * 2] = normalize_plane(w + r);
+		plane[i * 2 + 1] = normalize_plane(w - r);
+	}
+}
+
+/* The batch versions test 8 volumes against each plane at a time, stopping
+ * early when all 8 are outside of one, and finish any remaining volumes with
+ * the scalar tests.
+ */
+#define CULL_BATCH	8
+
+static inline void set_vis(uint32_t *vis, int idx, unsigned int bits, int nbits)
+{
+	uint32_t *word = vis + (idx >> 5);
+	int shift = idx & 31;
+	uint32_t mask = (nbits >= 32 ? 0xffffffff : (1u << nbits) - 1) << shift;
+	*word = (*word & ~mask) | ((bits << shift) & mask);
+}
+
+static inline int count_bits(unsigned int x)
+{
+	int n = 0;
+	while(x) {
+		x &= x - 1;
+		n++;
+	}
+	return n;
+}
+
+int cull_spheres(const Frustum &frust, const float *x, const float *y,
+		const float *z, const float *rad, int count, uint32_t *vis)
+{
+	int num_vis = 0;
+	int i = 0;
+
+	for(; i + CULL_BATCH <= count; i += CULL_BATCH) {
+		Float8 vx = Float8(x + i);
+		Float8 vy = Float8(y + i);
+		Float8 vz = Float8(z + i);
+		Float8 neg_rad = -Float8(rad + i);
+		Float8 out = Float8(0.0f);
+
+		for(int j=0; j<6; j++) {
+			const Vec4 &pl = frust.plane[j];
+			Float8 d = Float8(pl.x) * vx + Float8(pl.y) * vy + Float8(pl.z) * vz + Float8(pl.w);
+			out = out | (d < neg_rad);
+			if(all(out)) break;
+		}
+
+		unsigned int bits = ~movemask(out) & 0xff;
+		set_vis(vis, i, bits, CULL_BATCH);
+		num_vis += count_bits(bits);
+	}
+
+	for(; i<count; i++) {
+		int res = cull_sphere(frust, Vec3(x[i], y[i], z[i]), rad[i]) != CULL_OUTSIDE;
+		set_vis(vis, i, res, 1);
+		num_vis += res;
+	}
+	return num_vis;
+}
+
+int cull_aabbs(const Frustum &frust, const float *cx, const float *cy,
+		const float *cz, const float *hx, const float *hy, const float *hz, int count,
+		uint32_t *vis)
+{
+	int num_vis = 0;
+	int i = 0;
+
+	for(; i + CULL_BATCH <= count; i += CULL_BATCH) {
+		Float8 vx = Float8(cx + i);
+		Float8 vy = Float8(cy + i);
+		Float8 vz = Float8(cz + i);
+		Float8 vhx = Float8(hx + i);
+		Float8 vhy = Float8(hy + i);
+		Float8 vhz = Float8(hz + i);
+		Float8 out = Float8(0.0f);
+
+		for(int j=0; j<6; j++) {
+			const Vec4 &pl = frust.plane[j];
+			Float8 d = Float8(pl.x) * vx + Float8(pl.y) * vy + Float8(pl.z) * vz + Float8(pl.w);
+			Float8 r = Float8(fabs(pl.x)) * vhx + Float8(fabs(pl.y)) * vhy + Float8(fabs(pl.z)) * vhz;
+			out = out | (d < -r);
+			if(all(out)) break;
+		}
+
+		unsigned int bits = ~movemask(out) & 0xff;
+		set_vis(vis, i, bits, CULL_BATCH);
+		num_vis += count_bits(bits);
+	}
+
+	for(; i<count; i++) {
+		Vec3 c = Vec3(cx[i], cy[i], cz[i]);
+		Vec3 h = Vec3(hx[i], hy[i], hz[i]);
+		int res = cull_aabb(frust, c - h, c + h) != CULL_OUTSIDE;
+		set_vis(vis, i, res, 1);
+		num_vis += res;
+	}
+	return num_vis;
+}
+
+}	// namespace gph
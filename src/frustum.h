@@ -0,0 +1,85 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#ifndef GMATH_FRUSTUM_H_
+#define GMATH_FRUSTUM_H_
+
+#include "config.h"
+
+#include <stdint.h>
+#include "vector.h"
+#include "matrix.h"
+
+/* View frustum culling.
+ *
+ * A Frustum holds the 6 planes of a view volume, normalized and facing
+ * inwards, in the same order as the FRUSTUM_* constants of matrix.h. Built
+ * from a projection matrix the planes are in view space, and from a view *
+ * projection matrix in world space.
+ *
+ * The scalar tests classify a bounding volume as outside, intersecting, or
+ * inside the frustum, and take two optional arguments to skip work for
+ * coherent queries:
+ * - plane_mask: bit i set means plane i needs to be tested. On return only the
+ *   bits of the planes which intersect the volume are left set, so passing
+ *   the result of a parent node to its children skips the planes which the
+ *   parent was found to be entirely inside of. Start with FRUSTUM_ALL_PLANES.
+ * - last_plane: the plane which rejected this volume last time, to be tested
+ *   first (objects which were culled by a plane in the previous frame, tend
+ *   to be culled by the same plane in the next one). Updated on rejection.
+ *   Start with 0.
+ *
+ * The batch versions cull whole arrays of bounding volumes, given as
+ * structures of arrays, 8 at a time with SIMD. They write a visibility bitmask
+ * vis, of (count + 31) / 32 words, where bit (i & 31) of vis[i >> 5] is set
+ * if volume i is at least partially inside the frustum, and return the number
+ * of visible volumes. Ranges of the arrays starting at multiples of 32 write
+ * to separate words of vis, and can be culled from multiple threads.
+ */
+
+#define FRUSTUM_ALL_PLANES	0x3f
+
+namespace gph {
+
+enum { CULL_OUTSIDE, CULL_INTERSECT, CULL_INSIDE };
+
+class GPH_MATH_API Frustum {
+public:
+	Vec4 plane[6];
+
+	Frustum() {}
+	explicit Frustum(const Mat4 &m);
+
+	// extract all 6 planes of the matrix in one pass, and normalize them
+	void set(const Mat4 &m);
+};
+
+inline GPH_MATH_API int cull_sphere(const Frustum &frust, const Vec3 &center, float rad,
+		unsigned int *plane_mask = 0, int *last_plane = 0);
+inline GPH_MATH_API int cull_aabb(const Frustum &frust, const Vec3 &bmin, const Vec3 &bmax,
+		unsigned int *plane_mask = 0, int *last_plane = 0);
+/* oriented box with the given center, and half-size axes: the unit axes of
+ * the box multiplied by half its extent along each of them
+ */
+inline GPH_MATH_API int cull_obb(const Frustum &frust, const Vec3 &center, const Vec3 &ax,
+		const Vec3 &ay, const Vec3 &az, unsigned int *plane_mask = 0, int *last_plane = 0);
+
+// batch culling of spheres with centers (x, y, z) and radii rad
+GPH_MATH_API int cull_spheres(const Frustum &frust, const float *x, const float *y,
+		const float *z, const float *rad, int count, uint32_t *vis);
+// batch culling of axis-aligned boxes with centers (cx, cy, cz) and half-sizes (hx, hy, hz)
+GPH_MATH_API int cull_aabbs(const Frustum &frust, const float *cx, const float *cy,
+		const float *cz, const float *hx, const float *hy, const float *hz, int count,
+		uint32_t *vis);
+
+#include "frustum.inl"
+
+}	// namespace gph
+
+#endif	// GMATH_FRUSTUM_H_
@@ -0,0 +1,92 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+
+/* All tests compare the signed distance d of the center of the volume from
+ * each plane, against the radius r of the volume projected onto the plane
+ * normal: the volume is outside if d < -r, and intersects the plane if d < r.
+ */
+
+inline int cull_sphere(const Frustum &frust, const Vec3 &center, float rad,
+		unsigned int *plane_mask, int *last_plane)
+{
+	unsigned int mask = plane_mask ? *plane_mask : FRUSTUM_ALL_PLANES;
+	int p = last_plane ? *last_plane : 0;
+	unsigned int isect = 0;
+
+	for(int i=0; i<6; i++) {
+		if(mask & (1 << p)) {
+			const Vec4 &pl = frust.plane[p];
+			float d = pl.x * center.x + pl.y * center.y + pl.z * center.z + pl.w;
+			if(d < -rad) {
+				if(last_plane) *last_plane = p;
+				return CULL_OUTSIDE;
+			}
+			if(d < rad) isect |= 1 << p;
+		}
+		if(++p >= 6) p = 0;
+	}
+
+	if(plane_mask) *plane_mask = isect;
+	return isect ? CULL_INTERSECT : CULL_INSIDE;
+}
+
+inline int cull_aabb(const Frustum &frust, const Vec3 &bmin, const Vec3 &bmax,
+		unsigned int *plane_mask, int *last_plane)
+{
+	Vec3 c = (bmin + bmax) * 0.5f;
+	Vec3 h = (bmax - bmin) * 0.5f;
+
+	unsigned int mask = plane_mask ? *plane_mask : FRUSTUM_ALL_PLANES;
+	int p = last_plane ? *last_plane : 0;
+	unsigned int isect = 0;
+
+	for(int i=0; i<6; i++) {
+		if(mask & (1 << p)) {
+			const Vec4 &pl = frust.plane[p];
+			float d = pl.x * c.x + pl.y * c.y + pl.z * c.z + pl.w;
+			float r = fabs(pl.x) * h.x + fabs(pl.y) * h.y + fabs(pl.z) * h.z;
+			if(d < -r) {
+				if(last_plane) *last_plane = p;
+				return CULL_OUTSIDE;
+			}
+			if(d < r) isect |= 1 << p;
+		}
+		if(++p >= 6) p = 0;
+	}
+
+	if(plane_mask) *plane_mask = isect;
+	return isect ? CULL_INTERSECT : CULL_INSIDE;
+}
+
+inline int cull_obb(const Frustum &frust, const Vec3 &center, const Vec3 &ax,
+		const Vec3 &ay, const Vec3 &az, unsigned int *plane_mask, int *last_plane)
+{
+	unsigned int mask = plane_mask ? *plane_mask : FRUSTUM_ALL_PLANES;
+	int p = last_plane ? *last_plane : 0;
+	unsigned int isect = 0;
+
+	for(int i=0; i<6; i++) {
+		if(mask & (1 << p)) {
+			const Vec4 &pl = frust.plane[p];
+			Vec3 n = Vec3(pl.x, pl.y, pl.z);
+			float d = dot(n, center) + pl.w;
+			float r = fabs(dot(n, ax)) + fabs(dot(n, ay)) + fabs(dot(n, az));
+			if(d < -r) {
+				if(last_plane) *last_plane = p;
+				return CULL_OUTSIDE;
+			}
+			if(d < r) isect |= 1 << p;
+		}
+		if(++p >= 6) p = 0;
+	}
+
+	if(plane_mask) *plane_mask = isect;
+	return isect ? CULL_INTERSECT : CULL_INSIDE;
+}
@@ -15,7 +15,17 @@ replace this paragraph with the full contents of the LICENSE file.
 #include "vector.h"
 #include "matrix.h"
 #include "quat.h"
+#include "dualquat.h"
+#include "transform.h"
+#include "frustum.h"
+#include "bounds.h"
+#include "hierarchy.h"
+#include "wide.h"
 #include "ray.h"
+#include "intersect.h"
+#include "bvh.h"
+#include "random.h"
+#include "sampling.h"
 #include "noise.h"
 #include "misc.h"
 
@@ -0,0 +1,206 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#include <atomic>
+#include <thread>
+#include "hierarchy.h"
+
+/* don't bother spawning threads for hierarchies smaller than this */
+#define MIN_PARALLEL	16384
+/* smallest range of nodes worth handing to a thread on its own */
+#define MIN_TASK_NODES	1024
+/* aim for this many tasks per thread, to balance the load */
+#define TASKS_PER_THREAD	8
+
+namespace gph {
+
+/* a range of consecutive whole subtrees, whose ancestors are already updated */
+struct UpdateTask {
+	int begin, end;
+};
+
+struct UpdateJob {
+	const int *parent;
+	const int *subtree_end;
+	const Mat3x4 *local;
+	Mat3x4 *world;
+	unsigned char *dirty;
+	unsigned int *changed;
+	unsigned int count;		// current update count
+
+	const UpdateTask *tasks;
+	int num_tasks;
+	std::atomic<int> next_task;
+};
+
+/* a node is recomputed if it's dirty, or if its parent was recomputed during
+ * this update; nodes are visited in order, so the parent is always done first
+ */
+static inline void update_node(UpdateJob *job, int idx)
+{
+	int p = job->parent[idx];
+	if(p < 0) {
+		if(job->dirty[idx]) {
+			job->world[idx] = job->local[idx];
+			job->changed[idx] = job->count;
+			job->dirty[idx] = 0;
+		}
+	} else if(job->dirty[idx] || job->changed[p] == job->count) {
+		job->world[idx] = job->local[idx] * job->world[p];
+		job->changed[idx] = job->count;
+		job->dirty[idx] = 0;
+	}
+}
+
+static void update_thread(UpdateJob *job)
+{
+	for(;;) {
+		int t = job->next_task++;
+		if(t >= job->num_tasks) break;
+
+		int end = job->tasks[t].end;
+		for(int i=job->tasks[t].begin; i<end; i++) {
+			update_node(job, i);
+		}
+	}
+}
+
+TransformHierarchy::TransformHierarchy()
+{
+	update_count = 0;
+	any_dirty = false;
+}
+
+void TransformHierarchy::clear()
+{
+	parent.clear();
+	subtree_end.clear();
+	local.clear();
+	world.clear();
+	dirty.clear();
+	changed.clear();
+	any_dirty = false;
+}
+
+void TransformHierarchy::reserve(int count)
+{
+	parent.reserve(count);
+	subtree_end.reserve(count);
+	local.reserve(count);
+	world.reserve(count);
+	dirty.reserve(count);
+	changed.reserve(count);
+}
+
+int TransformHierarchy::add_node(int parent_idx, const Mat3x4 &xform)
+{
+	int idx = (int)parent.size();
+
+	/* the parent's subtree has to end right here, for the new node to extend
+	 * it, which is only true for the last node and its ancestors
+	 */
+	if(parent_idx >= 0 && (parent_idx >= idx || subtree_end[parent_idx] != idx)) {
+		return -1;
+	}
+
+	parent.push_back(parent_idx);
+	subtree_end.push_back(idx + 1);
+	local.push_back(xform);
+	world.push_back(xform);
+	dirty.push_back(1);
+	changed.push_back(update_count - 1);
+
+	while(parent_idx >= 0) {
+		subtree_end[parent_idx] = idx + 1;
+		parent_idx = parent[parent_idx];
+	}
+
+	any_dirty = true;
+	return idx;
+}
+
+void TransformHierarchy::update(int num_threads)
+{
+	update_count++;
+	if(!any_dirty) return;
+	any_dirty = false;
+
+	int num_nodes = (int)parent.size();
+
+	UpdateJob job;
+	job.parent = &parent[0];
+	job.subtree_end = &subtree_end[0];
+	job.local = &local[0];
+	job.world = &world[0];
+	job.dirty = &dirty[0];
+	job.changed = &changed[0];
+	job.count = update_count;
+
+	if(num_threads <= 0) {
+		num_threads = std::thread::hardware_concurrency();
+		if(num_threads <= 0) num_threads = 1;
+	}
+
+	if(num_threads == 1 || num_nodes < MIN_PARALLEL) {
+		for(int i=0; i<num_nodes; i++) {
+			update_node(&job, i);
+		}
+		return;
+	}
+
+	/* walk down from the roots, updating nodes with large subtrees in place,
+	 * until reaching subtrees small enough to fit in a task. Consecutive small
+	 * subtrees are grouped into tasks of up to task_size nodes, so that a wide
+	 * tree with many tiny subtrees (or many roots) doesn't turn into as many
+	 * tasks. Only the nodes above the tasks are visited here, since each
+	 * subtree is skipped as a whole.
+	 */
+	int task_size = num_nodes / (num_threads * TASKS_PER_THREAD);
+	if(task_size < MIN_TASK_NODES) task_size = MIN_TASK_NODES;
+
+	std::vector<UpdateTask> tasks;
+	UpdateTask cur = {0, 0};
+	int idx = 0;
+	while(idx < num_nodes) {
+		int end = subtree_end[idx];
+		if(end - idx <= task_size) {
+			if(end - cur.begin > task_size) {
+				if(cur.end > cur.begin) tasks.push_back(cur);
+				cur.begin = idx;
+			}
+			cur.end = idx = end;
+		} else {
+			if(cur.end > cur.begin) tasks.push_back(cur);
+			update_node(&job, idx++);
+			cur.begin = cur.end = idx;
+		}
+	}
+	if(cur.end > cur.begin) tasks.push_back(cur);
+
+	if(tasks.empty()) return;
+
+	job.tasks = &tasks[0];
+	job.num_tasks = (int)tasks.size();
+	job.next_task = 0;
+
+	// no point in starting more threads than there are tasks
+	if(num_threads > job.num_tasks) num_threads = job.num_tasks;
+
+	std::vector<std::thread> threads;
+	for(int i=1; i<num_threads; i++) {
+		threads.push_back(std::thread(update_thread, &job));
+	}
+	update_thread(&job);
+
+	for(size_t i=0; i<threads.size(); i++) {
+		threads[i].join();
+	}
+}
+
+}	// namespace gph
@@ -0,0 +1,87 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#ifndef GMATH_HIERARCHY_H_
+#define GMATH_HIERARCHY_H_
+
+#include "config.h"
+
+#include <vector>
+#include "transform.h"
+
+namespace gph {
+
+/* Flat transformation hierarchy, for computing the world matrices of a scene
+ * graph or a skeleton without chasing pointers.
+ *
+ * Nodes are stored in depth-first order in contiguous arrays: the parent
+ * indices, the local matrices, and the world matrices (Mat3x4; call
+ * calc_matrix for a Mat4). This means that every node comes after its parent,
+ * and the descendants of each node immediately follow it, so any subtree is a
+ * contiguous range of nodes. To keep it that way, add_node only accepts as
+ * parent the last node added or one of its ancestors, which is what a
+ * depth-first traversal of the source scene graph produces. Structural changes
+ * other than appending nodes require rebuilding the hierarchy.
+ *
+ * The world matrix of each node is its local matrix followed by the world
+ * matrix of its parent. set_local marks a node as dirty, and update recomputes
+ * the world matrices of dirty nodes and all their descendants, in one linear
+ * pass. Large hierarchies are split into ranges of independent subtrees, which
+ * are updated in parallel by num_threads threads (0 means as many as the
+ * hardware supports), after the few nodes above them.
+ */
+class GPH_MATH_API TransformHierarchy {
+private:
+	std::vector<int> parent;
+	std::vector<int> subtree_end;
+	std::vector<Mat3x4> local, world;
+	std::vector<unsigned char> dirty;
+	std::vector<unsigned int> changed;	// update count when world last changed
+	unsigned int update_count;
+	bool any_dirty;
+
+public:
+	TransformHierarchy();
+
+	void clear();
+	void reserve(int count);
+
+	/* appends a node, returning its index, or -1 if the parent would break the
+	 * depth-first order. Use -1 as the parent for root nodes.
+	 */
+	int add_node(int parent_idx, const Mat3x4 &xform = Mat3x4::identity);
+
+	inline int get_node_count() const;
+	inline int get_parent(int idx) const;
+	// one past the last descendant of idx
+	inline int get_subtree_end(int idx) const;
+
+	inline void set_local(int idx, const Mat3x4 &xform);
+	inline const Mat3x4 &get_local(int idx) const;
+	// valid after update
+	inline const Mat3x4 &get_world(int idx) const;
+	// true if the world matrix of idx was recomputed by the last update
+	inline bool world_changed(int idx) const;
+
+	/* direct access to the arrays, for bulk updates. After writing to the
+	 * local matrices call invalidate for each node changed.
+	 */
+	inline Mat3x4 *get_local_array();
+	inline const Mat3x4 *get_world_array() const;
+	inline const int *get_parent_array() const;
+	inline void invalidate(int idx);
+
+	void update(int num_threads = 0);
+};
+
+#include "hierarchy.inl"
+
+}	// namespace gph
+
+#endif	// GMATH_HIERARCHY_H_
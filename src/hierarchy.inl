@@ -0,0 +1,67 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+
+inline int TransformHierarchy::get_node_count() const
+{
+	return (int)parent.size();
+}
+
+inline int TransformHierarchy::get_parent(int idx) const
+{
+	return parent[idx];
+}
+
+inline int TransformHierarchy::get_subtree_end(int idx) const
+{
+	return subtree_end[idx];
+}
+
+inline void TransformHierarchy::set_local(int idx, const Mat3x4 &xform)
+{
+	local[idx] = xform;
+	dirty[idx] = 1;
+	any_dirty = true;
+}
+
+inline const Mat3x4 &TransformHierarchy::get_local(int idx) const
+{
+	return local[idx];
+}
+
+inline const Mat3x4 &TransformHierarchy::get_world(int idx) const
+{
+	return world[idx];
+}
+
+inline bool TransformHierarchy::world_changed(int idx) const
+{
+	return changed[idx] == update_count;
+}
+
+inline Mat3x4 *TransformHierarchy::get_local_array()
+{
+	return local.empty() ? 0 : &local[0];
+}
+
+inline const Mat3x4 *TransformHierarchy::get_world_array() const
+{
+	return world.empty() ? 0 : &world[0];
+}
+
+inline const int *TransformHierarchy::get_parent_array() const
+{
+	return parent.empty() ? 0 : &parent[0];
+}
+
+inline void TransformHierarchy::invalidate(int idx)
+{
+	dirty[idx] = 1;
+	any_dirty = true;
+}
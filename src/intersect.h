@@ -0,0 +1,72 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#ifndef GMATH_INTERSECT_H_
+#define GMATH_INTERSECT_H_
+
+#include "config.h"
+
+#include "vector.h"
+#include "ray.h"
+#include "wide.h"
+
+/* Ray-primitive intersection tests.
+ *
+ * Intersection distances are parametric: the hit point is ray.origin +
+ * ray.dir * t, so t is in units of the length of the ray direction. Only hits
+ * with t >= 0 are reported. Rays from mouse_pick_ray for instance, span the
+ * near to far plane range for t in [0, 1].
+ *
+ * The scalar tests return true on intersection, and write the results to any
+ * of the output pointers which are not null. The packet tests return a mask
+ * with the lanes which hit the primitive, and write results for all lanes;
+ * result values in lanes which missed are undefined.
+ *
+ * Planes are given as Vec4(a, b, c, d) for the plane equation
+ * ax + by + cz + d = 0, just like Mat4::get_frustum_plane returns them.
+ *
+ * Triangle tests use the Moller-Trumbore algorithm, are double-sided, and
+ * return the barycentric coordinates of the hit point: the weights of v0, v1,
+ * and v2 in the x, y, and z components respectively.
+ */
+
+namespace gph {
+
+// ---- scalar ray tests ----
+inline GPH_MATH_API bool intersect_aabb(const Ray &ray, const Vec3 &inv_dir, const Vec3 &bmin,
+		const Vec3 &bmax, float *tnear = 0, float *tfar = 0);
+inline GPH_MATH_API bool intersect_aabb(const Ray &ray, const Vec3 &bmin, const Vec3 &bmax,
+		float *tnear = 0, float *tfar = 0);
+inline GPH_MATH_API bool intersect_sphere(const Ray &ray, const Vec3 &center, float rad, float *t = 0);
+inline GPH_MATH_API bool intersect_plane(const Ray &ray, const Vec4 &plane, float *t = 0);
+inline GPH_MATH_API bool intersect_plane(const Ray &ray, const Vec3 &n, float d, float *t = 0);
+inline GPH_MATH_API bool intersect_triangle(const Ray &ray, const Vec3 &v0, const Vec3 &v1,
+		const Vec3 &v2, float *t = 0, Vec3 *bary = 0);
+
+// ---- packet tests, 4 rays against one primitive ----
+inline GPH_MATH_API Float4 intersect_aabb(const RayPacket4 &rp, const Vec3 &bmin, const Vec3 &bmax,
+		Float4 *tnear = 0, Float4 *tfar = 0);
+inline GPH_MATH_API Float4 intersect_sphere(const RayPacket4 &rp, const Vec3 &center, float rad, Float4 *t = 0);
+inline GPH_MATH_API Float4 intersect_plane(const RayPacket4 &rp, const Vec4 &plane, Float4 *t = 0);
+inline GPH_MATH_API Float4 intersect_triangle(const RayPacket4 &rp, const Vec3 &v0, const Vec3 &v1,
+		const Vec3 &v2, Float4 *t = 0, Vec3x4 *bary = 0);
+
+// ---- packet tests, 8 rays against one primitive ----
+inline GPH_MATH_API Float8 intersect_aabb(const RayPacket8 &rp, const Vec3 &bmin, const Vec3 &bmax,
+		Float8 *tnear = 0, Float8 *tfar = 0);
+inline GPH_MATH_API Float8 intersect_sphere(const RayPacket8 &rp, const Vec3 &center, float rad, Float8 *t = 0);
+inline GPH_MATH_API Float8 intersect_plane(const RayPacket8 &rp, const Vec4 &plane, Float8 *t = 0);
+inline GPH_MATH_API Float8 intersect_triangle(const RayPacket8 &rp, const Vec3 &v0, const Vec3 &v1,
+		const Vec3 &v2, Float8 *t = 0, Vec3x8 *bary = 0);
+
+#include "intersect.inl"
+
+}	// namespace gph
+
+#endif	// GMATH_INTERSECT_H_
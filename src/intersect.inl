@@ -0,0 +1,305 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+
+// ---- scalar ray tests ----
+
+/* slab test: clip the ray parameter range against each pair of axis-aligned
+ * planes in turn, and check if anything is left of it.
+ */
+inline bool intersect_aabb(const Ray &ray, const Vec3 &inv_dir, const Vec3 &bmin,
+		const Vec3 &bmax, float *tnear, float *tfar)
+{
+	float t0 = (bmin.x - ray.origin.x) * inv_dir.x;
+	float t1 = (bmax.x - ray.origin.x) * inv_dir.x;
+	float tmin = t0 < t1 ? t0 : t1;
+	float tmax = t0 < t1 ? t1 : t0;
+
+	t0 = (bmin.y - ray.origin.y) * inv_dir.y;
+	t1 = (bmax.y - ray.origin.y) * inv_dir.y;
+	if(t0 > t1) {
+		float tmp = t0;
+		t0 = t1;
+		t1 = tmp;
+	}
+	if(t0 > tmin) tmin = t0;
+	if(t1 < tmax) tmax = t1;
+
+	t0 = (bmin.z - ray.origin.z) * inv_dir.z;
+	t1 = (bmax.z - ray.origin.z) * inv_dir.z;
+	if(t0 > t1) {
+		float tmp = t0;
+		t0 = t1;
+		t1 = tmp;
+	}
+	if(t0 > tmin) tmin = t0;
+	if(t1 < tmax) tmax = t1;
+
+	if(tmax < 0.0f || tmin > tmax) {
+		return false;
+	}
+	if(tnear) *tnear = tmin;
+	if(tfar) *tfar = tmax;
+	return true;
+}
+
+inline bool intersect_aabb(const Ray &ray, const Vec3 &bmin, const Vec3 &bmax, float *tnear, float *tfar)
+{
+	Vec3 inv_dir = Vec3(1.0f / ray.dir.x, 1.0f / ray.dir.y, 1.0f / ray.dir.z);
+	return intersect_aabb(ray, inv_dir, bmin, bmax, tnear, tfar);
+}
+
+/* if the ray starts inside the sphere, the exit point is returned */
+inline bool intersect_sphere(const Ray &ray, const Vec3 &center, float rad, float *t)
+{
+	Vec3 oc = ray.origin - center;
+	float a = dot(ray.dir, ray.dir);
+	float b = 2.0f * dot(ray.dir, oc);
+	float c = dot(oc, oc) - rad * rad;
+
+	float discr = b * b - 4.0f * a * c;
+	if(discr < 0.0f || a == 0.0f) {
+		return false;
+	}
+
+	float sqrt_discr = sqrt(discr);
+	float t0 = (-b - sqrt_discr) / (2.0f * a);
+	float t1 = (-b + sqrt_discr) / (2.0f * a);
+	if(t1 < 0.0f) {
+		return false;
+	}
+	if(t) *t = t0 >= 0.0f ? t0 : t1;
+	return true;
+}
+
+inline bool intersect_plane(const Ray &ray, const Vec4 &plane, float *t)
+{
+	return intersect_plane(ray, Vec3(plane.x, plane.y, plane.z), plane.w, t);
+}
+
+inline bool intersect_plane(const Ray &ray, const Vec3 &n, float d, float *t)
+{
+	float ndotdir = dot(n, ray.dir);
+	if(ndotdir == 0.0f) {
+		return false;
+	}
+
+	float tres = -(dot(n, ray.origin) + d) / ndotdir;
+	if(tres < 0.0f) {
+		return false;
+	}
+	if(t) *t = tres;
+	return true;
+}
+
+/* the range tests are written so that they fail for NaNs */
+inline bool intersect_triangle(const Ray &ray, const Vec3 &v0, const Vec3 &v1,
+		const Vec3 &v2, float *t, Vec3 *bary)
+{
+	Vec3 e1 = v1 - v0;
+	Vec3 e2 = v2 - v0;
+	Vec3 pvec = cross(ray.dir, e2);
+
+	float det = dot(e1, pvec);
+	if(det == 0.0f) {
+		return false;
+	}
+	float inv_det = 1.0f / det;
+
+	Vec3 tvec = ray.origin - v0;
+	float u = dot(tvec, pvec) * inv_det;
+	if(!(u >= 0.0f && u <= 1.0f)) {
+		return false;
+	}
+
+	Vec3 qvec = cross(tvec, e1);
+	float v = dot(ray.dir, qvec) * inv_det;
+	if(!(v >= 0.0f && u + v <= 1.0f)) {
+		return false;
+	}
+
+	float tres = dot(e2, qvec) * inv_det;
+	if(!(tres >= 0.0f)) {
+		return false;
+	}
+
+	if(t) *t = tres;
+	if(bary) *bary = Vec3(1.0f - u - v, u, v);
+	return true;
+}
+
+// ---- packet tests, 4 rays against one primitive ----
+
+inline Float4 intersect_aabb(const RayPacket4 &rp, const Vec3 &bmin, const Vec3 &bmax,
+		Float4 *tnear, Float4 *tfar)
+{
+	Float4 t0 = (Float4(bmin.x) - rp.origin.x) * rp.inv_dir.x;
+	Float4 t1 = (Float4(bmax.x) - rp.origin.x) * rp.inv_dir.x;
+	Float4 tmin = min(t0, t1);
+	Float4 tmax = max(t0, t1);
+
+	t0 = (Float4(bmin.y) - rp.origin.y) * rp.inv_dir.y;
+	t1 = (Float4(bmax.y) - rp.origin.y) * rp.inv_dir.y;
+	tmin = max(tmin, min(t0, t1));
+	tmax = min(tmax, max(t0, t1));
+
+	t0 = (Float4(bmin.z) - rp.origin.z) * rp.inv_dir.z;
+	t1 = (Float4(bmax.z) - rp.origin.z) * rp.inv_dir.z;
+	tmin = max(tmin, min(t0, t1));
+	tmax = min(tmax, max(t0, t1));
+
+	if(tnear) *tnear = tmin;
+	if(tfar) *tfar = tmax;
+	return (tmax >= Float4(0.0f)) & (tmin <= tmax);
+}
+
+inline Float4 intersect_sphere(const RayPacket4 &rp, const Vec3 &center, float rad, Float4 *t)
+{
+	Float4 zero = Float4(0.0f);
+	Vec3x4 oc = rp.origin - Vec3x4(center);
+	Float4 a = dot(rp.dir, rp.dir);
+	Float4 b = Float4(2.0f) * dot(rp.dir, oc);
+	Float4 c = dot(oc, oc) - Float4(rad * rad);
+
+	Float4 discr = b * b - Float4(4.0f) * a * c;
+	Float4 valid = (discr >= zero) & (a != zero);
+	Float4 sqrt_discr = vsqrt(max(discr, zero));
+	Float4 inv_2a = Float4(1.0f) / select(valid, a + a, Float4(1.0f));
+
+	Float4 t0 = (-b - sqrt_discr) * inv_2a;
+	Float4 t1 = (-b + sqrt_discr) * inv_2a;
+	if(t) *t = select(t0 >= zero, t0, t1);
+	return valid & (t1 >= zero);
+}
+
+inline Float4 intersect_plane(const RayPacket4 &rp, const Vec4 &plane, Float4 *t)
+{
+	Float4 zero = Float4(0.0f);
+	Vec3x4 n = Vec3x4(Vec3(plane.x, plane.y, plane.z));
+	Float4 ndotdir = dot(n, rp.dir);
+	Float4 valid = ndotdir != zero;
+
+	Float4 tres = -(dot(n, rp.origin) + Float4(plane.w)) / select(valid, ndotdir, Float4(1.0f));
+	if(t) *t = tres;
+	return valid & (tres >= zero);
+}
+
+inline Float4 intersect_triangle(const RayPacket4 &rp, const Vec3 &v0, const Vec3 &v1,
+		const Vec3 &v2, Float4 *t, Vec3x4 *bary)
+{
+	Float4 zero = Float4(0.0f);
+	Float4 one = Float4(1.0f);
+	Vec3x4 e1 = Vec3x4(v1 - v0);
+	Vec3x4 e2 = Vec3x4(v2 - v0);
+	Vec3x4 pvec = cross(rp.dir, e2);
+
+	Float4 det = dot(e1, pvec);
+	Float4 valid = det != zero;
+	Float4 inv_det = one / select(valid, det, one);
+
+	Vec3x4 tvec = rp.origin - Vec3x4(v0);
+	Float4 u = dot(tvec, pvec) * inv_det;
+	valid = valid & (u >= zero) & (u <= one);
+
+	Vec3x4 qvec = cross(tvec, e1);
+	Float4 v = dot(rp.dir, qvec) * inv_det;
+	valid = valid & (v >= zero) & (u + v <= one);
+
+	Float4 tres = dot(e2, qvec) * inv_det;
+	valid = valid & (tres >= zero);
+
+	if(t) *t = tres;
+	if(bary) *bary = Vec3x4(one - u - v, u, v);
+	return valid;
+}
+
+// ---- packet tests, 8 rays against one primitive ----
+
+inline Float8 intersect_aabb(const RayPacket8 &rp, const Vec3 &bmin, const Vec3 &bmax,
+		Float8 *tnear, Float8 *tfar)
+{
+	Float8 t0 = (Float8(bmin.x) - rp.origin.x) * rp.inv_dir.x;
+	Float8 t1 = (Float8(bmax.x) - rp.origin.x) * rp.inv_dir.x;
+	Float8 tmin = min(t0, t1);
+	Float8 tmax = max(t0, t1);
+
+	t0 = (Float8(bmin.y) - rp.origin.y) * rp.inv_dir.y;
+	t1 = (Float8(bmax.y) - rp.origin.y) * rp.inv_dir.y;
+	tmin = max(tmin, min(t0, t1));
+	tmax = min(tmax, max(t0, t1));
+
+	t0 = (Float8(bmin.z) - rp.origin.z) * rp.inv_dir.z;
+	t1 = (Float8(bmax.z) - rp.origin.z) * rp.inv_dir.z;
+	tmin = max(tmin, min(t0, t1));
+	tmax = min(tmax, max(t0, t1));
+
+	if(tnear) *tnear = tmin;
+	if(tfar) *tfar = tmax;
+	return (tmax >= Float8(0.0f)) & (tmin <= tmax);
+}
+
+inline Float8 intersect_sphere(const RayPacket8 &rp, const Vec3 &center, float rad, Float8 *t)
+{
+	Float8 zero = Float8(0.0f);
+	Vec3x8 oc = rp.origin - Vec3x8(center);
+	Float8 a = dot(rp.dir, rp.dir);
+	Float8 b = Float8(2.0f) * dot(rp.dir, oc);
+	Float8 c = dot(oc, oc) - Float8(rad * rad);
+
+	Float8 discr = b * b - Float8(4.0f) * a * c;
+	Float8 valid = (discr >= zero) & (a != zero);
+	Float8 sqrt_discr = vsqrt(max(discr, zero));
+	Float8 inv_2a = Float8(1.0f) / select(valid, a + a, Float8(1.0f));
+
+	Float8 t0 = (-b - sqrt_discr) * inv_2a;
+	Float8 t1 = (-b + sqrt_discr) * inv_2a;
+	if(t) *t = select(t0 >= zero, t0, t1);
+	return valid & (t1 >= zero);
+}
+
+inline Float8 intersect_plane(const RayPacket8 &rp, const Vec4 &plane, Float8 *t)
+{
+	Float8 zero = Float8(0.0f);
+	Vec3x8 n = Vec3x8(Vec3(plane.x, plane.y, plane.z));
+	Float8 ndotdir = dot(n, rp.dir);
+	Float8 valid = ndotdir != zero;
+
+	Float8 tres = -(dot(n, rp.origin) + Float8(plane.w)) / select(valid, ndotdir, Float8(1.0f));
+	if(t) *t = tres;
+	return valid & (tres >= zero);
+}
+
+inline Float8 intersect_triangle(const RayPacket8 &rp, const Vec3 &v0, const Vec3 &v1,
+		const Vec3 &v2, Float8 *t, Vec3x8 *bary)
+{
+	Float8 zero = Float8(0.0f);
+	Float8 one = Float8(1.0f);
+	Vec3x8 e1 = Vec3x8(v1 - v0);
+	Vec3x8 e2 = Vec3x8(v2 - v0);
+	Vec3x8 pvec = cross(rp.dir, e2);
+
+	Float8 det = dot(e1, pvec);
+	Float8 valid = det != zero;
+	Float8 inv_det = one / select(valid, det, one);
+
+	Vec3x8 tvec = rp.origin - Vec3x8(v0);
+	Float8 u = dot(tvec, pvec) * inv_det;
+	valid = valid & (u >= zero) & (u <= one);
+
+	Vec3x8 qvec = cross(tvec, e1);
+	Float8 v = dot(rp.dir, qvec) * inv_det;
+	valid = valid & (v >= zero) & (u + v <= one);
+
+	Float8 tres = dot(e2, qvec) * inv_det;
+	valid = valid & (tres >= zero);
+
+	if(t) *t = tres;
+	if(bary) *bary = Vec3x8(one - u - v, u, v);
+	return valid;
+}
@@ -12,10 +12,10 @@ replace this paragraph with the full contents of the LICENSE file.
 
 namespace gph {
 
-Mat2 Mat2::identity(1, 0, 0, 1);
-Mat3 Mat3::identity(1, 0, 0, 0, 1, 0, 0, 0, 1);
-Mat4 Mat4::identity(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1);
-Mat4 Mat4::zero(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+const Mat2 Mat2::identity(1, 0, 0, 1);
+const Mat3 Mat3::identity(1, 0, 0, 0, 1, 0, 0, 0, 1);
+const Mat4 Mat4::identity(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1);
+const Mat4 Mat4::zero(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
 
 void gph::Mat4::rotation(const Quat &q)
 {
@@ -57,11 +57,233 @@ Quat gph::Mat4::get_rotation() const
 		quat[i + 1] = 0.5f * root;
 		root = 0.5f / root;
 		quat[0] = (m[j][k] - m[k][j]) * root;
-		quat[j + 1] = (m[i][j] - m[j][i]) * root;
-		quat[k + 1] = (m[i][k] - m[k][i]) * root;
+		quat[j + 1] = (m[i][j] + m[j][i]) * root;
+		quat[k + 1] = (m[i][k] + m[k][i]) * root;
 	}
 	return Quat(quat[1], quat[2], quat[3], quat[0]);
 }
 
 
+static inline float *next_elem(float *p, int stride)
+{
+	return (float*)((char*)p + stride);
+}
+
+static inline const float *next_elem(const float *p, int stride)
+{
+	return (const float*)((const char*)p + stride);
+}
+
+void transform_points(Vec3 *dest, const Vec3 *src, int count, const Mat4 &m, bool proj_div)
+{
+	transform_points(&dest->x, sizeof *dest, &src->x, sizeof *src, count, m, proj_div);
+}
+
+void transform_vectors(Vec3 *dest, const Vec3 *src, int count, const Mat4 &m)
+{
+	transform_vectors(&dest->x, sizeof *dest, &src->x, sizeof *src, count, m);
+}
+
+void transform_homogeneous(Vec4 *dest, const Vec4 *src, int count, const Mat4 &m, bool proj_div)
+{
+	transform_homogeneous(&dest->x, sizeof *dest, &src->x, sizeof *src, count, m, proj_div);
+}
+
+/* The SIMD versions keep the matrix rows in registers for the whole batch and
+ * transform one vector per iteration, as a linear combination of the matrix
+ * rows weighted by the vector elements. That way arbitrary strides and
+ * in-place transformation work without any gathering or shuffling.
+ */
+void transform_points(float *dest, int dest_stride, const float *src, int src_stride,
+		int count, const Mat4 &m, bool proj_div)
+{
+	if(!dest_stride) dest_stride = 3 * sizeof(float);
+	if(!src_stride) src_stride = 3 * sizeof(float);
+
+#if defined(GPH_SIMD_SSE)
+	__m128 r0 = _mm_loadu_ps(m[0]);
+	__m128 r1 = _mm_loadu_ps(m[1]);
+	__m128 r2 = _mm_loadu_ps(m[2]);
+	__m128 r3 = _mm_loadu_ps(m[3]);
+
+	for(int i=0; i<count; i++) {
+		__m128 v = _mm_mul_ps(r0, _mm_set1_ps(src[0]));
+		v = _mm_add_ps(v, _mm_mul_ps(r1, _mm_set1_ps(src[1])));
+		v = _mm_add_ps(v, _mm_mul_ps(r2, _mm_set1_ps(src[2])));
+		v = _mm_add_ps(v, r3);
+		if(proj_div) {
+			v = _mm_div_ps(v, _mm_shuffle_ps(v, v, 0xff));
+		}
+		_mm_storel_pi((__m64*)dest, v);
+		_mm_store_ss(dest + 2, _mm_movehl_ps(v, v));
+
+		src = next_elem(src, src_stride);
+		dest = next_elem(dest, dest_stride);
+	}
+#elif defined(GPH_SIMD_NEON)
+	float32x4_t r0 = vld1q_f32(m[0]);
+	float32x4_t r1 = vld1q_f32(m[1]);
+	float32x4_t r2 = vld1q_f32(m[2]);
+	float32x4_t r3 = vld1q_f32(m[3]);
+
+	for(int i=0; i<count; i++) {
+		float32x4_t v = vmulq_n_f32(r0, src[0]);
+		v = vaddq_f32(v, vmulq_n_f32(r1, src[1]));
+		v = vaddq_f32(v, vmulq_n_f32(r2, src[2]));
+		v = vaddq_f32(v, r3);
+		if(proj_div) {
+			v = vmulq_n_f32(v, 1.0f / vgetq_lane_f32(v, 3));
+			v = vsetq_lane_f32(1.0f, v, 3);
+		}
+		vst1_f32(dest, vget_low_f32(v));
+		vst1q_lane_f32(dest + 2, v, 2);
+
+		src = next_elem(src, src_stride);
+		dest = next_elem(dest, dest_stride);
+	}
+#else
+	for(int i=0; i<count; i++) {
+		float x = m[0][0] * src[0] + m[1][0] * src[1] + m[2][0] * src[2] + m[3][0];
+		float y = m[0][1] * src[0] + m[1][1] * src[1] + m[2][1] * src[2] + m[3][1];
+		float z = m[0][2] * src[0] + m[1][2] * src[1] + m[2][2] * src[2] + m[3][2];
+		if(proj_div) {
+			float w = m[0][3] * src[0] + m[1][3] * src[1] + m[2][3] * src[2] + m[3][3];
+			x /= w;
+			y /= w;
+			z /= w;
+		}
+		dest[0] = x;
+		dest[1] = y;
+		dest[2] = z;
+
+		src = next_elem(src, src_stride);
+		dest = next_elem(dest, dest_stride);
+	}
+#endif
+}
+
+void transform_vectors(float *dest, int dest_stride, const float *src, int src_stride,
+		int count, const Mat4 &m)
+{
+	if(!dest_stride) dest_stride = 3 * sizeof(float);
+	if(!src_stride) src_stride = 3 * sizeof(float);
+
+#if defined(GPH_SIMD_SSE)
+	__m128 r0 = _mm_loadu_ps(m[0]);
+	__m128 r1 = _mm_loadu_ps(m[1]);
+	__m128 r2 = _mm_loadu_ps(m[2]);
+
+	for(int i=0; i<count; i++) {
+		__m128 v = _mm_mul_ps(r0, _mm_set1_ps(src[0]));
+		v = _mm_add_ps(v, _mm_mul_ps(r1, _mm_set1_ps(src[1])));
+		v = _mm_add_ps(v, _mm_mul_ps(r2, _mm_set1_ps(src[2])));
+		_mm_storel_pi((__m64*)dest, v);
+		_mm_store_ss(dest + 2, _mm_movehl_ps(v, v));
+
+		src = next_elem(src, src_stride);
+		dest = next_elem(dest, dest_stride);
+	}
+#elif defined(GPH_SIMD_NEON)
+	float32x4_t r0 = vld1q_f32(m[0]);
+	float32x4_t r1 = vld1q_f32(m[1]);
+	float32x4_t r2 = vld1q_f32(m[2]);
+
+	for(int i=0; i<count; i++) {
+		float32x4_t v = vmulq_n_f32(r0, src[0]);
+		v = vaddq_f32(v, vmulq_n_f32(r1, src[1]));
+		v = vaddq_f32(v, vmulq_n_f32(r2, src[2]));
+		vst1_f32(dest, vget_low_f32(v));
+		vst1q_lane_f32(dest + 2, v, 2);
+
+		src = next_elem(src, src_stride);
+		dest = next_elem(dest, dest_stride);
+	}
+#else
+	for(int i=0; i<count; i++) {
+		float x = m[0][0] * src[0] + m[1][0] * src[1] + m[2][0] * src[2];
+		float y = m[0][1] * src[0] + m[1][1] * src[1] + m[2][1] * src[2];
+		float z = m[0][2] * src[0] + m[1][2] * src[1] + m[2][2] * src[2];
+		dest[0] = x;
+		dest[1] = y;
+		dest[2] = z;
+
+		src = next_elem(src, src_stride);
+		dest = next_elem(dest, dest_stride);
+	}
+#endif
+}
+
+void transform_homogeneous(float *dest, int dest_stride, const float *src, int src_stride,
+		int count, const Mat4 &m, bool proj_div)
+{
+	if(!dest_stride) dest_stride = 4 * sizeof(float);
+	if(!src_stride) src_stride = 4 * sizeof(float);
+
+#if defined(GPH_SIMD_SSE)
+	__m128 r0 = _mm_loadu_ps(m[0]);
+	__m128 r1 = _mm_loadu_ps(m[1]);
+	__m128 r2 = _mm_loadu_ps(m[2]);
+	__m128 r3 = _mm_loadu_ps(m[3]);
+	__m128 one = _mm_set1_ps(1.0f);
+
+	for(int i=0; i<count; i++) {
+		__m128 v = _mm_mul_ps(r0, _mm_set1_ps(src[0]));
+		v = _mm_add_ps(v, _mm_mul_ps(r1, _mm_set1_ps(src[1])));
+		v = _mm_add_ps(v, _mm_mul_ps(r2, _mm_set1_ps(src[2])));
+		v = _mm_add_ps(v, _mm_mul_ps(r3, _mm_set1_ps(src[3])));
+		if(proj_div) {
+			v = _mm_div_ps(v, _mm_shuffle_ps(v, v, 0xff));
+			/* w is 1, like the scalar version, instead of w/w which is NaN
+			 * for w = 0: (x, y) from v, and (z, 1) from (z, 1, w, 1)
+			 */
+			v = _mm_shuffle_ps(v, _mm_unpackhi_ps(v, one), _MM_SHUFFLE(1, 0, 1, 0));
+		}
+		_mm_storeu_ps(dest, v);
+
+		src = next_elem(src, src_stride);
+		dest = next_elem(dest, dest_stride);
+	}
+#elif defined(GPH_SIMD_NEON)
+	float32x4_t r0 = vld1q_f32(m[0]);
+	float32x4_t r1 = vld1q_f32(m[1]);
+	float32x4_t r2 = vld1q_f32(m[2]);
+	float32x4_t r3 = vld1q_f32(m[3]);
+
+	for(int i=0; i<count; i++) {
+		float32x4_t v = vmulq_n_f32(r0, src[0]);
+		v = vaddq_f32(v, vmulq_n_f32(r1, src[1]));
+		v = vaddq_f32(v, vmulq_n_f32(r2, src[2]));
+		v = vaddq_f32(v, vmulq_n_f32(r3, src[3]));
+		if(proj_div) {
+			v = vmulq_n_f32(v, 1.0f / vgetq_lane_f32(v, 3));
+			v = vsetq_lane_f32(1.0f, v, 3);
+		}
+		vst1q_f32(dest, v);
+
+		src = next_elem(src, src_stride);
+		dest = next_elem(dest, dest_stride);
+	}
+#else
+	for(int i=0; i<count; i++) {
+		float x = m[0][0] * src[0] + m[1][0] * src[1] + m[2][0] * src[2] + m[3][0] * src[3];
+		float y = m[0][1] * src[0] + m[1][1] * src[1] + m[2][1] * src[2] + m[3][1] * src[3];
+		float z = m[0][2] * src[0] + m[1][2] * src[1] + m[2][2] * src[2] + m[3][2] * src[3];
+		float w = m[0][3] * src[0] + m[1][3] * src[1] + m[2][3] * src[2] + m[3][3] * src[3];
+		if(proj_div) {
+			x /= w;
+			y /= w;
+			z /= w;
+			w = 1.0f;
+		}
+		dest[0] = x;
+		dest[1] = y;
+		dest[2] = z;
+		dest[3] = w;
+
+		src = next_elem(src, src_stride);
+		dest = next_elem(dest, dest_stride);
+	}
+#endif
+}
+
 }	// namespace gph
@@ -15,6 +15,7 @@ replace this paragraph with the full contents of the LICENSE file.
 #include <stdio.h>
 #include <string.h>
 #include "vector.h"
+#include "simd.h"
 
 /* NOTE:
  * matrices are treated by all operations as column-major, to match OpenGL
@@ -33,30 +34,32 @@ class GPH_MATH_API Mat2 {
 public:
 	float m[2][2];
 
-	static Mat2 identity;
+	static const Mat2 identity;
 
-	inline Mat2();
-	inline Mat2(float m00, float m01, float m10, float m11);
+	constexpr Mat2();
+	constexpr Mat2(float m00, float m01, float m10, float m11);
+	inline explicit Mat2(NoInit);
 
 	inline float *operator [](int idx);
-	inline const float *operator [](int idx) const;
+	constexpr const float *operator [](int idx) const;
 
-	inline float determinant() const;
+	constexpr float determinant() const;
 };
 
 class GPH_MATH_API Mat3 {
 public:
 	float m[3][3];
 
-	static Mat3 identity;
+	static const Mat3 identity;
 
-	inline Mat3();
-	inline Mat3(float m00, float m01, float m02,
+	constexpr Mat3();
+	constexpr Mat3(float m00, float m01, float m02,
 			float m10, float m11, float m12,
 			float m20, float m21, float m22);
+	inline explicit Mat3(NoInit);
 
 	inline float *operator [](int idx);
-	inline const float *operator [](int idx) const;
+	constexpr const float *operator [](int idx) const;
 
 	inline Mat2 submatrix(int row, int col) const;
 	inline float subdet(int row, int col) const;
@@ -68,33 +71,34 @@ class GPH_MATH_API Mat4 {
 public:
 	float m[4][4];
 
-	static Mat4 zero;
-	static Mat4 identity;
+	static const Mat4 zero;
+	static const Mat4 identity;
 
-	inline Mat4();
+	constexpr Mat4();
+	inline explicit Mat4(NoInit);
 	inline Mat4(const float *m);
-	inline Mat4(float m00, float m01, float m02, float m03,
+	constexpr Mat4(float m00, float m01, float m02, float m03,
 			float m10, float m11, float m12, float m13,
 			float m20, float m21, float m22, float m23,
 			float m30, float m31, float m32, float m33);
-	inline Mat4(const Vec4 &v0, const Vec4 &v1, const Vec4 &v2, const Vec4 &v3);
-	inline Mat4(const Vec3 &v0, const Vec3 &v1, const Vec3 &v2, const Vec3 &v3 = Vec3(0, 0, 0));
+	constexpr Mat4(const Vec4 &v0, const Vec4 &v1, const Vec4 &v2, const Vec4 &v3);
+	constexpr Mat4(const Vec3 &v0, const Vec3 &v1, const Vec3 &v2, const Vec3 &v3 = Vec3(0, 0, 0));
 
 	inline Mat3 submatrix(int row, int col) const;
 
 	inline float *operator [](int idx);
-	inline const float *operator [](int idx) const;
+	constexpr const float *operator [](int idx) const;
 
 	inline void set_row(int idx, const Vec3 &v);
 	inline void set_row(int idx, const Vec4 &v);
 	inline void set_column(int idx, const Vec3 &v);
 	inline void set_column(int idx, const Vec4 &v);
-	inline Vec4 get_row(int idx) const;
-	inline Vec3 get_row3(int idx) const;
-	inline Vec4 get_column(int idx) const;
-	inline Vec3 get_column3(int idx) const;
+	constexpr Vec4 get_row(int idx) const;
+	constexpr Vec3 get_row3(int idx) const;
+	constexpr Vec4 get_column(int idx) const;
+	constexpr Vec3 get_column3(int idx) const;
 
-	inline Mat4 upper3x3() const;
+	constexpr Mat4 upper3x3() const;
 
 	inline float subdet(int row, int col) const;
 	inline float cofactor(int row, int col) const;
@@ -102,6 +106,13 @@ public:
 
 	inline void transpose();
 	inline bool inverse();
+	/* cheaper inverses for special cases of transformation matrices:
+	 * inverse_affine assumes the last column is (0, 0, 0, 1), i.e. any
+	 * combination of translation/rotation/scaling/shearing, and inverse_rigid
+	 * further assumes the upper 3x3 part is orthonormal (rotation+translation)
+	 */
+	inline bool inverse_affine();
+	inline void inverse_rigid();
 
 	/* translation/rotation/scaling functions construct a transformation
 	 * matrix of the appropriate type, discarding any previous contents
@@ -171,11 +182,14 @@ public:
 	// rotate by quaternion
 	inline void pre_rotate(const Quat &q);
 
-	inline Vec3 get_translation() const;
+	constexpr Vec3 get_translation() const;
 	Quat get_rotation() const;
 	inline Vec3 get_scaling() const;
 
-	// extract each one of the 6 frustum planes from a projection matrix
+	/* extract each one of the 6 frustum planes from a projection matrix. The
+	 * planes face inwards, and are not normalized. For a view * projection
+	 * matrix, they are in world space. See also Frustum in frustum.h.
+	 */
 	inline Vec4 get_frustum_plane(int p) const;
 
 	// construct a lookat transformation
@@ -203,12 +217,35 @@ inline GPH_MATH_API Mat4 operator *(const Mat4 &m, float s);
 inline GPH_MATH_API Mat4 operator *(float s, const Mat4 &m);
 
 inline GPH_MATH_API float determinant(const Mat4 &m);
-inline GPH_MATH_API Mat4 transpose(const Mat4 &m);
+constexpr GPH_MATH_API Mat4 transpose(const Mat4 &m);
 inline GPH_MATH_API Mat4 cofactor_matrix(const Mat4 &m);
 inline GPH_MATH_API Mat4 inverse(const Mat4 &m);
+inline GPH_MATH_API Mat4 inverse_affine(const Mat4 &m);
+inline GPH_MATH_API Mat4 inverse_rigid(const Mat4 &m);
 
 inline GPH_MATH_API Vec4 normalize_plane(const Vec4 &p);
 
+/* batch transformation of arrays of vectors by a matrix, equivalent to doing
+ * dest[i] = m * src[i] for each one of them. Points are transformed as if
+ * w = 1, and vectors as if w = 0 (translation ignored). If proj_div is true,
+ * the transformed vectors are divided by the resulting w, and the w written by
+ * transform_homogeneous is 1.
+ *
+ * The raw float versions take the stride in bytes between consecutive vectors
+ * in each buffer, or 0 for tightly packed 3 (or 4) floats per vector.
+ * dest may be the same buffer as src, but they should not partially overlap.
+ */
+GPH_MATH_API void transform_points(Vec3 *dest, const Vec3 *src, int count, const Mat4 &m, bool proj_div = false);
+GPH_MATH_API void transform_vectors(Vec3 *dest, const Vec3 *src, int count, const Mat4 &m);
+GPH_MATH_API void transform_homogeneous(Vec4 *dest, const Vec4 *src, int count, const Mat4 &m, bool proj_div = false);
+
+GPH_MATH_API void transform_points(float *dest, int dest_stride, const float *src, int src_stride,
+		int count, const Mat4 &m, bool proj_div = false);
+GPH_MATH_API void transform_vectors(float *dest, int dest_stride, const float *src, int src_stride,
+		int count, const Mat4 &m);
+GPH_MATH_API void transform_homogeneous(float *dest, int dest_stride, const float *src, int src_stride,
+		int count, const Mat4 &m, bool proj_div = false);
+
 #include "matrix.inl"
 
 }	// namespace gph
@@ -8,15 +8,18 @@ If you intend to redistribute parts of the code without the LICENSE file
 replace this paragraph with the full contents of the LICENSE file.
 */
 
-inline Mat2::Mat2()
+constexpr Mat2::Mat2()
+	: m{{1, 0}, {0, 1}}
 {
-	memcpy((float*)m, (const float*)identity.m, 4 * sizeof(float));
 }
 
-inline Mat2::Mat2(float m00, float m01, float m10, float m11)
+constexpr Mat2::Mat2(float m00, float m01, float m10, float m11)
+	: m{{m00, m01}, {m10, m11}}
+{
+}
+
+inline Mat2::Mat2(NoInit)
 {
-	m[0][0] = m00; m[0][1] = m01;
-	m[1][0] = m10; m[1][1] = m11;
 }
 
 inline float *Mat2::operator [](int idx)
@@ -24,28 +27,30 @@ inline float *Mat2::operator [](int idx)
 	return m[idx];
 }
 
-inline const float *Mat2::operator [](int idx) const
+constexpr const float *Mat2::operator [](int idx) const
 {
 	return m[idx];
 }
 
-inline float Mat2::determinant() const
+constexpr float Mat2::determinant() const
 {
 	return m[0][0] * m[1][1] - m[0][1] * m[1][0];
 }
 
-inline Mat3::Mat3()
+constexpr Mat3::Mat3()
+	: m{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}
 {
-	memcpy((float*)m, (const float*)identity.m, 9 * sizeof(float));
 }
 
-inline Mat3::Mat3(float m00, float m01, float m02,
+constexpr Mat3::Mat3(float m00, float m01, float m02,
 			float m10, float m11, float m12,
 			float m20, float m21, float m22)
+	: m{{m00, m01, m02}, {m10, m11, m12}, {m20, m21, m22}}
+{
+}
+
+inline Mat3::Mat3(NoInit)
 {
-	m[0][0] = m00; m[0][1] = m01; m[0][2] = m02;
-	m[1][0] = m10; m[1][1] = m11; m[1][2] = m12;
-	m[2][0] = m20; m[2][1] = m21; m[2][2] = m22;
 }
 
 inline float *Mat3::operator [](int idx)
@@ -53,14 +58,14 @@ inline float *Mat3::operator [](int idx)
 	return m[idx];
 }
 
-inline const float *Mat3::operator [](int idx) const
+constexpr const float *Mat3::operator [](int idx) const
 {
 	return m[idx];
 }
 
 inline Mat2 Mat3::submatrix(int row, int col) const
 {
-	Mat2 sub;
+	Mat2 sub(noinit);
 	int subi = 0;
 	for(int i=0; i<3; i++) {
 		if(i == row) continue;
@@ -88,9 +93,13 @@ inline float Mat3::determinant() const
 
 // ---- Mat4 functions ----
 
-inline Mat4::Mat4()
+constexpr Mat4::Mat4()
+	: m{{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1}}
+{
+}
+
+inline Mat4::Mat4(NoInit)
 {
-	memcpy((float*)m, (const float*)identity.m, 16 * sizeof(float));
 }
 
 inline Mat4::Mat4(const float *m)
@@ -98,36 +107,36 @@ inline Mat4::Mat4(const float *m)
 	memcpy((float*)this->m, (const float*)m, 16 * sizeof(float));
 }
 
-inline Mat4::Mat4(float m00, float m01, float m02, float m03,
+constexpr Mat4::Mat4(float m00, float m01, float m02, float m03,
 		float m10, float m11, float m12, float m13,
 		float m20, float m21, float m22, float m23,
 		float m30, float m31, float m32, float m33)
+	: m{{m00, m01, m02, m03},
+		{m10, m11, m12, m13},
+		{m20, m21, m22, m23},
+		{m30, m31, m32, m33}}
 {
-	m[0][0] = m00; m[0][1] = m01; m[0][2] = m02; m[0][3] = m03;
-	m[1][0] = m10; m[1][1] = m11; m[1][2] = m12; m[1][3] = m13;
-	m[2][0] = m20; m[2][1] = m21; m[2][2] = m22; m[2][3] = m23;
-	m[3][0] = m30; m[3][1] = m31; m[3][2] = m32; m[3][3] = m33;
 }
 
-inline Mat4::Mat4(const Vec4 &v0, const Vec4 &v1, const Vec4 &v2, const Vec4 &v3)
+constexpr Mat4::Mat4(const Vec4 &v0, const Vec4 &v1, const Vec4 &v2, const Vec4 &v3)
+	: m{{v0.x, v0.y, v0.z, v0.w},
+		{v1.x, v1.y, v1.z, v1.w},
+		{v2.x, v2.y, v2.z, v2.w},
+		{v3.x, v3.y, v3.z, v3.w}}
 {
-	m[0][0] = v0.x; m[0][1] = v0.y; m[0][2] = v0.z; m[0][3] = v0.w;
-	m[1][0] = v1.x; m[1][1] = v1.y; m[1][2] = v1.z; m[1][3] = v1.w;
-	m[2][0] = v2.x; m[2][1] = v2.y; m[2][2] = v2.z; m[2][3] = v2.w;
-	m[3][0] = v3.x; m[3][1] = v3.y; m[3][2] = v3.z; m[3][3] = v3.w;
 }
 
-inline Mat4::Mat4(const Vec3 &v0, const Vec3 &v1, const Vec3 &v2, const Vec3 &v3)
+constexpr Mat4::Mat4(const Vec3 &v0, const Vec3 &v1, const Vec3 &v2, const Vec3 &v3)
+	: m{{v0.x, v0.y, v0.z, 0.0f},
+		{v1.x, v1.y, v1.z, 0.0f},
+		{v2.x, v2.y, v2.z, 0.0f},
+		{v3.x, v3.y, v3.z, 1.0f}}
 {
-	m[0][0] = v0.x; m[0][1] = v0.y; m[0][2] = v0.z; m[0][3] = 0.0f;
-	m[1][0] = v1.x; m[1][1] = v1.y; m[1][2] = v1.z; m[1][3] = 0.0f;
-	m[2][0] = v2.x; m[2][1] = v2.y; m[2][2] = v2.z; m[2][3] = 0.0f;
-	m[3][0] = v3.x; m[3][1] = v3.y; m[3][2] = v3.z; m[3][3] = 1.0f;
 }
 
 inline Mat3 Mat4::submatrix(int row, int col) const
 {
-	Mat3 sub;
+	Mat3 sub(noinit);
 	int subi = 0;
 	for(int i=0; i<4; i++) {
 		if(i == row) continue;
@@ -148,7 +157,7 @@ inline float *Mat4::operator [](int idx)
 	return m[idx];
 }
 
-inline const float *Mat4::operator [](int idx) const
+constexpr const float *Mat4::operator [](int idx) const
 {
 	return m[idx];
 }
@@ -185,27 +194,27 @@ inline void Mat4::set_column(int idx, const Vec4 &v)
 	m[3][idx] = v.w;
 }
 
-inline Vec4 Mat4::get_row(int idx) const
+constexpr Vec4 Mat4::get_row(int idx) const
 {
 	return Vec4(m[idx][0], m[idx][1], m[idx][2], m[idx][3]);
 }
 
-inline Vec3 Mat4::get_row3(int idx) const
+constexpr Vec3 Mat4::get_row3(int idx) const
 {
 	return Vec3(m[idx][0], m[idx][1], m[idx][2]);
 }
 
-inline Vec4 Mat4::get_column(int idx) const
+constexpr Vec4 Mat4::get_column(int idx) const
 {
 	return Vec4(m[0][idx], m[1][idx], m[2][idx], m[3][idx]);
 }
 
-inline Vec3 Mat4::get_column3(int idx) const
+constexpr Vec3 Mat4::get_column3(int idx) const
 {
 	return Vec3(m[0][idx], m[1][idx], m[2][idx]);
 }
 
-inline Mat4 Mat4::upper3x3() const
+constexpr Mat4 Mat4::upper3x3() const
 {
 	return Mat4(get_row3(0), get_row3(1), get_row3(2));
 }
@@ -221,10 +230,28 @@ inline float Mat4::cofactor(int row, int col) const
 	return (row + col) & 1 ? -min : min;
 }
 
+/* determinant and inverse are calculated in closed form, by Laplace expansion
+ * over the 2x2 sub-determinants of the top two and bottom two rows. See:
+ * David Eberly, "The Laplace Expansion Theorem: Computing the Determinants and
+ * Inverses of Matrices".
+ */
 inline float Mat4::determinant() const
 {
-	return m[0][0] * subdet(0, 0) - m[0][1] * subdet(0, 1) +
-		m[0][2] * subdet(0, 2) - m[0][3] * subdet(0, 3);
+	float s0 = m[0][0] * m[1][1] - m[1][0] * m[0][1];
+	float s1 = m[0][0] * m[1][2] - m[1][0] * m[0][2];
+	float s2 = m[0][0] * m[1][3] - m[1][0] * m[0][3];
+	float s3 = m[0][1] * m[1][2] - m[1][1] * m[0][2];
+	float s4 = m[0][1] * m[1][3] - m[1][1] * m[0][3];
+	float s5 = m[0][2] * m[1][3] - m[1][2] * m[0][3];
+
+	float c5 = m[2][2] * m[3][3] - m[3][2] * m[2][3];
+	float c4 = m[2][1] * m[3][3] - m[3][1] * m[2][3];
+	float c3 = m[2][1] * m[3][2] - m[3][1] * m[2][2];
+	float c2 = m[2][0] * m[3][3] - m[3][0] * m[2][3];
+	float c1 = m[2][0] * m[3][2] - m[3][0] * m[2][2];
+	float c0 = m[2][0] * m[3][1] - m[3][0] * m[2][1];
+
+	return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
 }
 
 inline void Mat4::transpose()
@@ -240,13 +267,99 @@ inline void Mat4::transpose()
 
 inline bool Mat4::inverse()
 {
-	float det = determinant();
+	float s0 = m[0][0] * m[1][1] - m[1][0] * m[0][1];
+	float s1 = m[0][0] * m[1][2] - m[1][0] * m[0][2];
+	float s2 = m[0][0] * m[1][3] - m[1][0] * m[0][3];
+	float s3 = m[0][1] * m[1][2] - m[1][1] * m[0][2];
+	float s4 = m[0][1] * m[1][3] - m[1][1] * m[0][3];
+	float s5 = m[0][2] * m[1][3] - m[1][2] * m[0][3];
+
+	float c5 = m[2][2] * m[3][3] - m[3][2] * m[2][3];
+	float c4 = m[2][1] * m[3][3] - m[3][1] * m[2][3];
+	float c3 = m[2][1] * m[3][2] - m[3][1] * m[2][2];
+	float c2 = m[2][0] * m[3][3] - m[3][0] * m[2][3];
+	float c1 = m[2][0] * m[3][2] - m[3][0] * m[2][2];
+	float c0 = m[2][0] * m[3][1] - m[3][0] * m[2][1];
+
+	float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+	if(!det) return false;
+	float s = 1.0f / det;
+
+	Mat4 a = *this;
+	m[0][0] = ( a.m[1][1] * c5 - a.m[1][2] * c4 + a.m[1][3] * c3) * s;
+	m[0][1] = (-a.m[0][1] * c5 + a.m[0][2] * c4 - a.m[0][3] * c3) * s;
+	m[0][2] = ( a.m[3][1] * s5 - a.m[3][2] * s4 + a.m[3][3] * s3) * s;
+	m[0][3] = (-a.m[2][1] * s5 + a.m[2][2] * s4 - a.m[2][3] * s3) * s;
+
+	m[1][0] = (-a.m[1][0] * c5 + a.m[1][2] * c2 - a.m[1][3] * c1) * s;
+	m[1][1] = ( a.m[0][0] * c5 - a.m[0][2] * c2 + a.m[0][3] * c1) * s;
+	m[1][2] = (-a.m[3][0] * s5 + a.m[3][2] * s2 - a.m[3][3] * s1) * s;
+	m[1][3] = ( a.m[2][0] * s5 - a.m[2][2] * s2 + a.m[2][3] * s1) * s;
+
+	m[2][0] = ( a.m[1][0] * c4 - a.m[1][1] * c2 + a.m[1][3] * c0) * s;
+	m[2][1] = (-a.m[0][0] * c4 + a.m[0][1] * c2 - a.m[0][3] * c0) * s;
+	m[2][2] = ( a.m[3][0] * s4 - a.m[3][1] * s2 + a.m[3][3] * s0) * s;
+	m[2][3] = (-a.m[2][0] * s4 + a.m[2][1] * s2 - a.m[2][3] * s0) * s;
+
+	m[3][0] = (-a.m[1][0] * c3 + a.m[1][1] * c1 - a.m[1][2] * c0) * s;
+	m[3][1] = ( a.m[0][0] * c3 - a.m[0][1] * c1 + a.m[0][2] * c0) * s;
+	m[3][2] = (-a.m[3][0] * s3 + a.m[3][1] * s1 - a.m[3][2] * s0) * s;
+	m[3][3] = ( a.m[2][0] * s3 - a.m[2][1] * s1 + a.m[2][2] * s0) * s;
+	return true;
+}
+
+/* with the last column being (0, 0, 0, 1), the inverse is the inverse of the
+ * upper 3x3 part A, and the translation t becomes -t * inverse(A)
+ */
+inline bool Mat4::inverse_affine()
+{
+	float c00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+	float c01 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+	float c02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+
+	float det = m[0][0] * c00 + m[0][1] * c01 + m[0][2] * c02;
 	if(!det) return false;
+	float s = 1.0f / det;
+
+	Mat4 a = *this;
+	m[0][0] = c00 * s;
+	m[0][1] = (a.m[0][2] * a.m[2][1] - a.m[0][1] * a.m[2][2]) * s;
+	m[0][2] = (a.m[0][1] * a.m[1][2] - a.m[0][2] * a.m[1][1]) * s;
+	m[1][0] = c01 * s;
+	m[1][1] = (a.m[0][0] * a.m[2][2] - a.m[0][2] * a.m[2][0]) * s;
+	m[1][2] = (a.m[0][2] * a.m[1][0] - a.m[0][0] * a.m[1][2]) * s;
+	m[2][0] = c02 * s;
+	m[2][1] = (a.m[0][1] * a.m[2][0] - a.m[0][0] * a.m[2][1]) * s;
+	m[2][2] = (a.m[0][0] * a.m[1][1] - a.m[0][1] * a.m[1][0]) * s;
+
+	float tx = a.m[3][0], ty = a.m[3][1], tz = a.m[3][2];
+	m[3][0] = -(tx * m[0][0] + ty * m[1][0] + tz * m[2][0]);
+	m[3][1] = -(tx * m[0][1] + ty * m[1][1] + tz * m[2][1]);
+	m[3][2] = -(tx * m[0][2] + ty * m[1][2] + tz * m[2][2]);
 
-	*this = gph::transpose(cofactor_matrix(*this)) * (1.0f / det);
+	m[0][3] = m[1][3] = m[2][3] = 0.0f;
+	m[3][3] = 1.0f;
 	return true;
 }
 
+/* for an orthonormal upper 3x3 part, its inverse is just its transpose */
+inline void Mat4::inverse_rigid()
+{
+	float tx = m[3][0], ty = m[3][1], tz = m[3][2];
+
+	float tmp;
+	tmp = m[0][1]; m[0][1] = m[1][0]; m[1][0] = tmp;
+	tmp = m[0][2]; m[0][2] = m[2][0]; m[2][0] = tmp;
+	tmp = m[1][2]; m[1][2] = m[2][1]; m[2][1] = tmp;
+
+	m[3][0] = -(tx * m[0][0] + ty * m[1][0] + tz * m[2][0]);
+	m[3][1] = -(tx * m[0][1] + ty * m[1][1] + tz * m[2][1]);
+	m[3][2] = -(tx * m[0][2] + ty * m[1][2] + tz * m[2][2]);
+
+	m[0][3] = m[1][3] = m[2][3] = 0.0f;
+	m[3][3] = 1.0f;
+}
+
 inline void Mat4::translation(float x, float y, float z)
 {
 	*this = identity;
@@ -380,7 +493,7 @@ inline void Mat4::rotation(const Vec3 &euler, EulerMode mode)
 
 inline void Mat4::translate(float x, float y, float z)
 {
-	Mat4 mat;
+	Mat4 mat(noinit);
 	mat.translation(x, y, z);
 	*this *= mat;
 }
@@ -397,7 +510,7 @@ inline void Mat4::scale(float s)
 
 inline void Mat4::scale(float x, float y, float z)
 {
-	Mat4 mat;
+	Mat4 mat(noinit);
 	mat.scaling(x, y, z);
 	*this *= mat;
 }
@@ -409,21 +522,21 @@ inline void Mat4::scale(const Vec3 &v)
 
 inline void Mat4::rotate_x(float angle)
 {
-	Mat4 mat;
+	Mat4 mat(noinit);
 	mat.rotation_x(angle);
 	*this *= mat;
 }
 
 inline void Mat4::rotate_y(float angle)
 {
-	Mat4 mat;
+	Mat4 mat(noinit);
 	mat.rotation_y(angle);
 	*this *= mat;
 }
 
 inline void Mat4::rotate_z(float angle)
 {
-	Mat4 mat;
+	Mat4 mat(noinit);
 	mat.rotation_z(angle);
 	*this *= mat;
 }
@@ -437,7 +550,7 @@ inline void Mat4::rotate_axis(int idx, float angle)
 
 inline void Mat4::rotate(float angle, float x, float y, float z)
 {
-	Mat4 mat;
+	Mat4 mat(noinit);
 	mat.rotation(angle, x, y, z);
 	*this *= mat;
 }
@@ -449,7 +562,7 @@ inline void Mat4::rotate(float angle, const Vec3 &axis)
 
 inline void Mat4::rotate(float x, float y, float z, EulerMode mode)
 {
-	Mat4 mat;
+	Mat4 mat(noinit);
 	mat.rotation(x, y, z, mode);
 	*this *= mat;
 }
@@ -461,14 +574,14 @@ inline void Mat4::rotate(const Vec3 &euler, EulerMode mode)
 
 inline void Mat4::rotate(const Quat &q)
 {
-	Mat4 mat;
+	Mat4 mat(noinit);
 	mat.rotation(q);
 	*this *= mat;
 }
 
 inline void Mat4::pre_translate(float x, float y, float z)
 {
-	Mat4 mat;
+	Mat4 mat(noinit);
 	mat.translation(x, y, z);
 	*this = mat * *this;
 }
@@ -485,7 +598,7 @@ inline void Mat4::pre_scale(float s)
 
 inline void Mat4::pre_scale(float x, float y, float z)
 {
-	Mat4 mat;
+	Mat4 mat(noinit);
 	mat.scaling(x, y, z);
 	*this = mat * *this;
 }
@@ -497,21 +610,21 @@ inline void Mat4::pre_scale(const Vec3 &v)
 
 inline void Mat4::pre_rotate_x(float angle)
 {
-	Mat4 mat;
+	Mat4 mat(noinit);
 	mat.rotation_x(angle);
 	*this = mat * *this;
 }
 
 inline void Mat4::pre_rotate_y(float angle)
 {
-	Mat4 mat;
+	Mat4 mat(noinit);
 	mat.rotation_y(angle);
 	*this = mat * *this;
 }
 
 inline void Mat4::pre_rotate_z(float angle)
 {
-	Mat4 mat;
+	Mat4 mat(noinit);
 	mat.rotation_z(angle);
 	*this = mat * *this;
 }
@@ -525,7 +638,7 @@ inline void Mat4::pre_rotate_axis(int idx, float angle)
 
 inline void Mat4::pre_rotate(float angle, float x, float y, float z)
 {
-	Mat4 mat;
+	Mat4 mat(noinit);
 	mat.rotation(angle, x, y, z);
 	*this = mat * *this;
 }
@@ -537,7 +650,7 @@ inline void Mat4::pre_rotate(float angle, const Vec3 &axis)
 
 inline void Mat4::pre_rotate(float x, float y, float z, EulerMode mode)
 {
-	Mat4 mat;
+	Mat4 mat(noinit);
 	mat.rotation(x, y, z, mode);
 	*this = mat * *this;
 }
@@ -549,12 +662,12 @@ inline void Mat4::pre_rotate(const Vec3 &euler, EulerMode mode)
 
 inline void Mat4::pre_rotate(const Quat &q)
 {
-	Mat4 mat;
+	Mat4 mat(noinit);
 	mat.rotation(q);
 	*this = mat * *this;
 }
 
-inline Vec3 Mat4::get_translation() const
+constexpr Vec3 Mat4::get_translation() const
 {
 	return Vec3(m[3][0], m[3][1], m[3][2]);
 }
@@ -573,15 +686,15 @@ inline Vec4 Mat4::get_frustum_plane(int p) const
 	int idx = p >> 1;
 
 	if((p & 1) == 0) {
-		plane[0] = m[3][0] + m[idx][0];
-		plane[1] = m[3][1] + m[idx][1];
-		plane[2] = m[3][2] + m[idx][2];
-		plane[3] = m[3][3] + m[idx][3];
+		plane[0] = m[0][3] + m[0][idx];
+		plane[1] = m[1][3] + m[1][idx];
+		plane[2] = m[2][3] + m[2][idx];
+		plane[3] = m[3][3] + m[3][idx];
 	} else {
-		plane[0] = m[3][0] - m[idx][0];
-		plane[1] = m[3][1] - m[idx][1];
-		plane[2] = m[3][2] - m[idx][2];
-		plane[3] = m[3][3] - m[idx][3];
+		plane[0] = m[0][3] - m[0][idx];
+		plane[1] = m[1][3] - m[1][idx];
+		plane[2] = m[2][3] - m[2][idx];
+		plane[3] = m[3][3] - m[3][idx];
 	}
 	return Vec4(plane[0], plane[1], plane[2], plane[3]);
 }
@@ -597,7 +710,7 @@ inline void Mat4::lookat(const Vec3 &pos, const Vec3 &targ, const Vec3 &up)
 	rot.set_row(1, vup);
 	rot.set_row(2, -dir);
 
-	Mat4 trans;
+	Mat4 trans(noinit);
 	trans.translation(pos);
 
 	*this = rot * trans;
@@ -614,7 +727,7 @@ inline void Mat4::inv_lookat(const Vec3 &pos, const Vec3 &targ, const Vec3 &up)
 	rot.set_column(1, vup);
 	rot.set_column(2, -dir);
 
-	Mat4 trans;
+	Mat4 trans(noinit);
 	trans.translation(-pos);
 
 	*this = trans * rot;
@@ -698,15 +811,61 @@ inline void Mat4::print(FILE *fp) const
 	fputc('\n', fp);
 }
 
+/* each row of the result is a linear combination of the rows of b, weighted
+ * by the elements of the corresponding row of a. The SIMD paths compute
+ * exactly that, one (or two with AVX) rows at a time.
+ */
 inline Mat4 operator *(const Mat4 &a, const Mat4 &b)
 {
-	Mat4 res;
+	Mat4 res(noinit);
+#if defined(GPH_SIMD_AVX)
+	__m256 b0 = _mm256_broadcast_ps((const __m128*)b.m[0]);
+	__m256 b1 = _mm256_broadcast_ps((const __m128*)b.m[1]);
+	__m256 b2 = _mm256_broadcast_ps((const __m128*)b.m[2]);
+	__m256 b3 = _mm256_broadcast_ps((const __m128*)b.m[3]);
+
+	for(int i=0; i<4; i+=2) {
+		__m256 arows = _mm256_loadu_ps(a.m[i]);
+		__m256 r = _mm256_mul_ps(_mm256_shuffle_ps(arows, arows, 0x00), b0);
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(arows, arows, 0x55), b1));
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(arows, arows, 0xaa), b2));
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(arows, arows, 0xff), b3));
+		_mm256_storeu_ps(res.m[i], r);
+	}
+#elif defined(GPH_SIMD_SSE)
+	__m128 b0 = _mm_loadu_ps(b.m[0]);
+	__m128 b1 = _mm_loadu_ps(b.m[1]);
+	__m128 b2 = _mm_loadu_ps(b.m[2]);
+	__m128 b3 = _mm_loadu_ps(b.m[3]);
+
+	for(int i=0; i<4; i++) {
+		__m128 r = _mm_mul_ps(_mm_set1_ps(a.m[i][0]), b0);
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a.m[i][1]), b1));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a.m[i][2]), b2));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a.m[i][3]), b3));
+		_mm_storeu_ps(res.m[i], r);
+	}
+#elif defined(GPH_SIMD_NEON)
+	float32x4_t b0 = vld1q_f32(b.m[0]);
+	float32x4_t b1 = vld1q_f32(b.m[1]);
+	float32x4_t b2 = vld1q_f32(b.m[2]);
+	float32x4_t b3 = vld1q_f32(b.m[3]);
+
+	for(int i=0; i<4; i++) {
+		float32x4_t r = vmulq_n_f32(b0, a.m[i][0]);
+		r = vaddq_f32(r, vmulq_n_f32(b1, a.m[i][1]));
+		r = vaddq_f32(r, vmulq_n_f32(b2, a.m[i][2]));
+		r = vaddq_f32(r, vmulq_n_f32(b3, a.m[i][3]));
+		vst1q_f32(res.m[i], r);
+	}
+#else
 	for(int i=0; i<4; i++) {
 		for(int j=0; j<4; j++) {
 			res.m[i][j] = a.m[i][0] * b.m[0][j] + a.m[i][1] * b.m[1][j] +
 				a.m[i][2] * b.m[2][j] + a.m[i][3] * b.m[3][j];
 		}
 	}
+#endif
 	return res;
 }
 
@@ -718,7 +877,7 @@ inline Mat4 &operator *=(Mat4 &a, const Mat4 &b)
 
 inline Mat4 operator *(const Mat4 &m, float s)
 {
-	Mat4 res;
+	Mat4 res(noinit);
 	for(int j=0; j<4; j++) {
 		for(int i=0; i<4; i++) {
 			res.m[i][j] = m.m[i][j] * s;
@@ -737,20 +896,17 @@ inline float determinant(const Mat4 &m)
 	return m.determinant();
 }
 
-inline Mat4 transpose(const Mat4 &m)
+constexpr Mat4 transpose(const Mat4 &m)
 {
-	Mat4 res;
-	for(int i=0; i<4; i++) {
-		for(int j=0; j<4; j++) {
-			res.m[i][j] = m.m[j][i];
-		}
-	}
-	return res;
+	return Mat4(m.m[0][0], m.m[1][0], m.m[2][0], m.m[3][0],
+			m.m[0][1], m.m[1][1], m.m[2][1], m.m[3][1],
+			m.m[0][2], m.m[1][2], m.m[2][2], m.m[3][2],
+			m.m[0][3], m.m[1][3], m.m[2][3], m.m[3][3]);
 }
 
 inline Mat4 cofactor_matrix(const Mat4 &m)
 {
-	Mat4 res;
+	Mat4 res(noinit);
 	for(int i=0; i<4; i++) {
 		for(int j=0; j<4; j++) {
 			res.m[i][j] = m.cofactor(i, j);
@@ -761,10 +917,23 @@ inline Mat4 cofactor_matrix(const Mat4 &m)
 
 inline Mat4 inverse(const Mat4 &m)
 {
-	float det = m.determinant();
-	if(!det) return Mat4::identity;
+	Mat4 res = m;
+	if(!res.inverse()) return Mat4::identity;
+	return res;
+}
 
-	return transpose(cofactor_matrix(m)) * (1.0f / det);
+inline Mat4 inverse_affine(const Mat4 &m)
+{
+	Mat4 res = m;
+	if(!res.inverse_affine()) return Mat4::identity;
+	return res;
+}
+
+inline Mat4 inverse_rigid(const Mat4 &m)
+{
+	Mat4 res = m;
+	res.inverse_rigid();
+	return res;
 }
 
 inline Vec4 normalize_plane(const Vec4 &p)
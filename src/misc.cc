@@ -1,32 +1,25 @@
-#include <stdlib.h>
 #include "matrix.h"
 #include "vector.h"
 #include "ray.h"
+#include "random.h"
 #include "misc.h"
 
 namespace gph {
 
-/* Generates a random vector on the disc */
+/* Generates a random vector on the disc, using the generator of the calling
+ * thread
+ */
 Vec2 discrand(float rad)
 {
-	float theta = 2.0 * M_PI * (float)rand() / RAND_MAX;
-	float r = sqrt((float)rand() / RAND_MAX) * rad;
-	return Vec2(cos(theta) * r, sin(theta) * r);
+	return discrand(thread_rng(), rad);
 }
 
-/* Generates a random vector on the surface of a sphere */
+/* Generates a random vector on the surface of a sphere, using the generator of
+ * the calling thread
+ */
 Vec3 sphrand(float rad)
 {
-	float u = (float)rand() / RAND_MAX;
-	float v = (float)rand() / RAND_MAX;
-
-	float theta = 2.0 * M_PI * u;
-	float phi = acos(2.0 * v - 1.0);
-
-	float x = rad * cos(theta) * sin(phi);
-	float y = rad * sin(theta) * sin(phi);
-	float z = rad * cos(phi);
-	return Vec3(x, y, z);
+	return sphrand(thread_rng(), rad);
 }
 
 }	// namespace gph
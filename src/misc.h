@@ -60,7 +60,7 @@ inline GPH_MATH_API float bezier(float a, float b, float c, float d, float t)
 
 inline GPH_MATH_API float bspline(float a, float b, float c, float d, float t)
 {
-	static const Mat4 mat = Mat4(-1, 3, -3, 1, 3, -6, 0, 4, -3, 3, 3, 1, 1, 0, 0, 0);
+	static constexpr Mat4 mat = Mat4(-1, 3, -3, 1, 3, -6, 0, 4, -3, 3, 3, 1, 1, 0, 0, 0);
 	float tsq = t * t;
 	Vec4 qfact = Vec4(tsq * t, tsq, t, 1.0f);
 	Vec4 tmp = mat * Vec4(a, b, c, d) * (1.0f / 6.0f);
@@ -69,7 +69,7 @@ inline GPH_MATH_API float bspline(float a, float b, float c, float d, float t)
 
 inline GPH_MATH_API float spline(float a, float b, float c, float d, float t)
 {
-	static const Mat4 mat = Mat4(-1, 2, -1, 0, 3, -5, 0, 2, -3, 4, 1, 0, 1, -1, 0, 0);
+	static constexpr Mat4 mat = Mat4(-1, 2, -1, 0, 3, -5, 0, 2, -3, 4, 1, 0, 1, -1, 0, 0);
 	float tsq = t * t;
 	Vec4 qfact = Vec4(tsq * t, tsq, t, 1.0f);
 	Vec4 tmp = mat * Vec4(a, b, c, d) * (1.0f / 6.0f);
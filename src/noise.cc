@@ -1,4 +1,7 @@
 #include <stdlib.h>
+#include <vector>
+#include <atomic>
+#include <thread>
 #include "gmath.h"
 #include "noise.h"
 
@@ -32,41 +35,67 @@ namespace gph {
 	} while(0)
 
 
-static int perm[B + B + 2];			/* permuted index from g_n onto themselves */
-static Vec3 grad3[B + B + 2];		/* 3D random gradients */
-static Vec2 grad2[B + B + 2];		/* 2D random gradients */
-static float grad1[B + B + 2];		/* 1D random ... slopes */
-static bool tables_valid;
+/* xorshift32, used instead of rand() to make the tables depend only on the
+ * seed. Returns non-negative ints, like rand.
+ */
+static int rand_next(unsigned int *state)
+{
+	unsigned int x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return (int)(x >> 1);
+}
 
-#define init_once()	if(!tables_valid) init_noise()
+/* scrambles the seed, so that nearby seeds produce unrelated sequences */
+static unsigned int hash_seed(unsigned int x)
+{
+	x = (x ^ 61) ^ (x >> 16);
+	x *= 9;
+	x ^= x >> 4;
+	x *= 0x27d4eb2d;
+	x ^= x >> 15;
+	return x ? x : 1;	/* xorshift gets stuck at 0 */
+}
 
-static void init_noise()
+NoiseContext::NoiseContext(unsigned int seed)
 {
+	unsigned int rng = hash_seed(seed);
+
 	/* calculate random gradients */
 	for(int i=0; i<B; i++) {
 		perm[i] = i;	/* .. and initialize permutation mapping to identity */
 
-		grad1[i] = (float)((rand() % (B + B)) - B) / B;
+		grad1[i] = (float)((rand_next(&rng) % (B + B)) - B) / B;
 
-		grad2[i].x = (float)((rand() % (B + B)) - B) / B;
-		grad2[i].y = (float)((rand() % (B + B)) - B) / B;
+		grad2[i].x = (float)((rand_next(&rng) % (B + B)) - B) / B;
+		grad2[i].y = (float)((rand_next(&rng) % (B + B)) - B) / B;
 		grad2[i] = normalize(grad2[i]);
 
-		grad3[i].x = (float)((rand() % (B + B)) - B) / B;
-		grad3[i].y = (float)((rand() % (B + B)) - B) / B;
-		grad3[i].z = (float)((rand() % (B + B)) - B) / B;
+		grad3[i].x = (float)((rand_next(&rng) % (B + B)) - B) / B;
+		grad3[i].y = (float)((rand_next(&rng) % (B + B)) - B) / B;
+		grad3[i].z = (float)((rand_next(&rng) % (B + B)) - B) / B;
 		grad3[i] = normalize(grad3[i]);
 	}
 
 	/* permute indices by swapping them randomly */
 	for(int i=0; i<B; i++) {
-		int rand_idx = rand() % B;
+		int rand_idx = rand_next(&rng) % B;
 
 		int tmp = perm[i];
 		perm[i] = perm[rand_idx];
 		perm[rand_idx] = tmp;
 	}
 
+	for(int i=0; i<B; i++) {
+		grad4[i].x = (float)((rand_next(&rng) % (B + B)) - B) / B;
+		grad4[i].y = (float)((rand_next(&rng) % (B + B)) - B) / B;
+		grad4[i].z = (float)((rand_next(&rng) % (B + B)) - B) / B;
+		grad4[i].w = (float)((rand_next(&rng) % (B + B)) - B) / B;
+		grad4[i] = normalize(grad4[i]);
+	}
+
 	/* fill up the rest of the arrays by duplicating the existing gradients */
 	/* and permutations */
 	for(int i=0; i<B+2; i++) {
@@ -74,19 +103,15 @@ static void init_noise()
 		grad1[B + i] = grad1[i];
 		grad2[B + i] = grad2[i];
 		grad3[B + i] = grad3[i];
+		grad4[B + i] = grad4[i];
 	}
-
-	tables_valid = true;
 }
 
-
-float noise(float x)
+float NoiseContext::noise(float x) const
 {
 	int bx0, bx1;
 	float rx0, rx1, sx, u, v;
 
-	init_once();
-
 	setup(x, bx0, bx1, rx0, rx1);
 	sx = s_curve(rx0);
 	u = rx0 * grad1[perm[bx0]];
@@ -94,15 +119,13 @@ float noise(float x)
 	return lerp(u, v, sx);
 }
 
-float noise(float x, float y)
+float NoiseContext::noise(float x, float y) const
 {
 	int i, j, b00, b10, b01, b11;
 	int bx0, bx1, by0, by1;
 	float rx0, rx1, ry0, ry1;
 	float sx, sy, u, v, a, b;
 
-	init_once();
-
 	setup(x, bx0, bx1, rx0, rx1);
 	setup(y, by0, by1, ry0, ry1);
 
@@ -132,7 +155,7 @@ float noise(float x, float y)
 	return lerp(a, b, sy);
 }
 
-float noise(float x, float y, float z)
+float NoiseContext::noise(float x, float y, float z) const
 {
 	int i, j;
 	int bx0, bx1, by0, by1, bz0, bz1;
@@ -141,8 +164,6 @@ float noise(float x, float y, float z)
 	float sx, sy, sz;
 	float u, v, a, b, c, d;
 
-	init_once();
-
 	setup(x, bx0, bx1, rx0, rx1);
 	setup(y, by0, by1, ry0, ry1);
 	setup(z, bz0, bz1, rz0, rz1);
@@ -186,19 +207,341 @@ float noise(float x, float y, float z)
 	return lerp(c, d, sz);
 }
 
-float noise(float x, float y, float z, float w)
+/* ---- noise with analytic derivatives ----
+ * The noise value is a multilinear interpolation, with weights s(r), of the
+ * dot products of the corner gradients with the offsets from each corner.
+ * Differentiating it yields the interpolated corner gradients, plus the
+ * derivative of the interpolation weights, ds(r) = 6r(1 - r), times the
+ * differences between the corner values along each axis.
+ */
+#define ds_curve(t) (6.0f * t * (1.0f - t))
+
+float NoiseContext::noise_d(float x, float y, Vec2 *grad) const
+{
+	int i, j, b00, b10, b01, b11;
+	int bx0, bx1, by0, by1;
+	float rx0, rx1, ry0, ry1;
+
+	setup(x, bx0, bx1, rx0, rx1);
+	setup(y, by0, by1, ry0, ry1);
+
+	i = perm[bx0];
+	j = perm[bx1];
+
+	b00 = perm[i + by0];
+	b10 = perm[j + by0];
+	b01 = perm[i + by1];
+	b11 = perm[j + by1];
+
+	float sx = s_curve(rx0);
+	float sy = s_curve(ry0);
+	float dsx = ds_curve(rx0);
+	float dsy = ds_curve(ry0);
+
+	const Vec2 &g00 = grad2[b00];
+	const Vec2 &g10 = grad2[b10];
+	const Vec2 &g01 = grad2[b01];
+	const Vec2 &g11 = grad2[b11];
+
+	float n00 = dot(g00, Vec2(rx0, ry0));
+	float n10 = dot(g10, Vec2(rx1, ry0));
+	float n01 = dot(g01, Vec2(rx0, ry1));
+	float n11 = dot(g11, Vec2(rx1, ry1));
+
+	float a = lerp(n00, n10, sx);
+	float b = lerp(n01, n11, sx);
+
+	Vec2 ga = lerp(g00, g10, sx);
+	Vec2 gb = lerp(g01, g11, sx);
+	*grad = lerp(ga, gb, sy);
+	grad->x += dsx * lerp(n10 - n00, n11 - n01, sy);
+	grad->y += dsy * (b - a);
+
+	return lerp(a, b, sy);
+}
+
+float NoiseContext::noise_d(float x, float y, float z, Vec3 *grad) const
 {
-	return 0;	/* TODO */
+	int i, j;
+	int bx0, bx1, by0, by1, bz0, bz1;
+	int b00, b10, b01, b11;
+	float rx0, rx1, ry0, ry1, rz0, rz1;
+
+	setup(x, bx0, bx1, rx0, rx1);
+	setup(y, by0, by1, ry0, ry1);
+	setup(z, bz0, bz1, rz0, rz1);
+
+	i = perm[bx0];
+	j = perm[bx1];
+
+	b00 = perm[i + by0];
+	b10 = perm[j + by0];
+	b01 = perm[i + by1];
+	b11 = perm[j + by1];
+
+	float sx = s_curve(rx0);
+	float sy = s_curve(ry0);
+	float sz = s_curve(rz0);
+	float dsx = ds_curve(rx0);
+	float dsy = ds_curve(ry0);
+	float dsz = ds_curve(rz0);
+
+	const Vec3 &g000 = grad3[b00 + bz0];
+	const Vec3 &g100 = grad3[b10 + bz0];
+	const Vec3 &g010 = grad3[b01 + bz0];
+	const Vec3 &g110 = grad3[b11 + bz0];
+	const Vec3 &g001 = grad3[b00 + bz1];
+	const Vec3 &g101 = grad3[b10 + bz1];
+	const Vec3 &g011 = grad3[b01 + bz1];
+	const Vec3 &g111 = grad3[b11 + bz1];
+
+	float n000 = dot(g000, Vec3(rx0, ry0, rz0));
+	float n100 = dot(g100, Vec3(rx1, ry0, rz0));
+	float n010 = dot(g010, Vec3(rx0, ry1, rz0));
+	float n110 = dot(g110, Vec3(rx1, ry1, rz0));
+	float n001 = dot(g001, Vec3(rx0, ry0, rz1));
+	float n101 = dot(g101, Vec3(rx1, ry0, rz1));
+	float n011 = dot(g011, Vec3(rx0, ry1, rz1));
+	float n111 = dot(g111, Vec3(rx1, ry1, rz1));
+
+	/* same interpolation order as noise, to produce the same values */
+	float a0 = lerp(n000, n100, sx);
+	float b0 = lerp(n010, n110, sx);
+	float c = lerp(a0, b0, sy);
+	float a1 = lerp(n001, n101, sx);
+	float b1 = lerp(n011, n111, sx);
+	float d = lerp(a1, b1, sy);
+
+	/* interpolated gradients */
+	Vec3 gc = lerp(lerp(g000, g100, sx), lerp(g010, g110, sx), sy);
+	Vec3 gd = lerp(lerp(g001, g101, sx), lerp(g011, g111, sx), sy);
+	*grad = lerp(gc, gd, sz);
+
+	/* derivatives of the interpolation weights */
+	float dx0 = lerp(n100 - n000, n110 - n010, sy);
+	float dx1 = lerp(n101 - n001, n111 - n011, sy);
+	grad->x += dsx * lerp(dx0, dx1, sz);
+	grad->y += dsy * lerp(b0 - a0, b1 - a1, sz);
+	grad->z += dsz * (d - c);
+
+	return lerp(c, d, sz);
 }
 
+/* ---- simplex noise, after Stefan Gustavson's "Simplex noise demystified" ----
+ * The simplex lattice touches N + 1 corners per sample in N dimensions, instead
+ * of the 2^N corners of the hypercube lattice.
+ */
+#define F2	0.366025404f	/* (sqrt(3) - 1) / 2 */
+#define G2	0.211324865f	/* (3 - sqrt(3)) / 6 */
+#define F3	0.333333333f	/* 1 / 3 */
+#define G3	0.166666667f	/* 1 / 6 */
+#define F4	0.309016994f	/* (sqrt(5) - 1) / 4 */
+#define G4	0.138196601f	/* (5 - sqrt(5)) / 20 */
+
+/* gradients towards the midpoints of the edges of a cube, also used for 2D */
+static const float sgrad3[12][3] = {
+	{1, 1, 0}, {-1, 1, 0}, {1, -1, 0}, {-1, -1, 0},
+	{1, 0, 1}, {-1, 0, 1}, {1, 0, -1}, {-1, 0, -1},
+	{0, 1, 1}, {0, -1, 1}, {0, 1, -1}, {0, -1, -1}
+};
+
+/* gradients towards the midpoints of the edges of a 4D hypercube */
+static const float sgrad4[32][4] = {
+	{0, 1, 1, 1}, {0, 1, 1, -1}, {0, 1, -1, 1}, {0, 1, -1, -1},
+	{0, -1, 1, 1}, {0, -1, 1, -1}, {0, -1, -1, 1}, {0, -1, -1, -1},
+	{1, 0, 1, 1}, {1, 0, 1, -1}, {1, 0, -1, 1}, {1, 0, -1, -1},
+	{-1, 0, 1, 1}, {-1, 0, 1, -1}, {-1, 0, -1, 1}, {-1, 0, -1, -1},
+	{1, 1, 0, 1}, {1, 1, 0, -1}, {1, -1, 0, 1}, {1, -1, 0, -1},
+	{-1, 1, 0, 1}, {-1, 1, 0, -1}, {-1, -1, 0, 1}, {-1, -1, 0, -1},
+	{1, 1, 1, 0}, {1, 1, -1, 0}, {1, -1, 1, 0}, {1, -1, -1, 0},
+	{-1, 1, 1, 0}, {-1, 1, -1, 0}, {-1, -1, 1, 0}, {-1, -1, -1, 0}
+};
+
+static inline int fast_floor(float x)
+{
+	int i = (int)x;
+	return x < (float)i ? i - 1 : i;
+}
 
-float pnoise(float x, int period)
+/* contribution of a single simplex corner, with offset (x, y, ...) from the
+ * sample point, and gradient index gi
+ */
+static inline float corner2(int gi, float x, float y)
+{
+	float t = 0.5f - x * x - y * y;
+	if(t < 0.0f) return 0.0f;
+
+	const float *g = sgrad3[gi % 12];
+	t *= t;
+	return t * t * (g[0] * x + g[1] * y);
+}
+
+static inline float corner3(int gi, float x, float y, float z)
+{
+	float t = 0.6f - x * x - y * y - z * z;
+	if(t < 0.0f) return 0.0f;
+
+	const float *g = sgrad3[gi % 12];
+	t *= t;
+	return t * t * (g[0] * x + g[1] * y + g[2] * z);
+}
+
+static inline float corner4(int gi, float x, float y, float z, float w)
+{
+	float t = 0.6f - x * x - y * y - z * z - w * w;
+	if(t < 0.0f) return 0.0f;
+
+	const float *g = sgrad4[gi & 31];
+	t *= t;
+	return t * t * (g[0] * x + g[1] * y + g[2] * z + g[3] * w);
+}
+
+float NoiseContext::snoise(float x, float y) const
+{
+	/* skew the input space to find which cell of the simplex lattice we're in */
+	float s = (x + y) * F2;
+	int i = fast_floor(x + s);
+	int j = fast_floor(y + s);
+
+	/* unskew the cell origin back, and get the offset from it */
+	float t = (i + j) * G2;
+	float x0 = x - (i - t);
+	float y0 = y - (j - t);
+
+	/* each cell is split into two triangles, along the diagonal */
+	int i1 = x0 > y0;
+	int j1 = !i1;
+
+	int ii = i & BM;
+	int jj = j & BM;
+
+	float n = corner2(perm[ii + perm[jj]], x0, y0);
+	n += corner2(perm[ii + i1 + perm[jj + j1]], x0 - i1 + G2, y0 - j1 + G2);
+	n += corner2(perm[ii + 1 + perm[jj + 1]], x0 - 1.0f + 2.0f * G2, y0 - 1.0f + 2.0f * G2);
+
+	/* scale the result to about [-1, 1] */
+	return 70.0f * n;
+}
+
+float NoiseContext::snoise(float x, float y, float z) const
+{
+	/* skew the input space to find which cell of the simplex lattice we're in */
+	float s = (x + y + z) * F3;
+	int i = fast_floor(x + s);
+	int j = fast_floor(y + s);
+	int k = fast_floor(z + s);
+
+	/* unskew the cell origin back, and get the offset from it */
+	float t = (i + j + k) * G3;
+	float x0 = x - (i - t);
+	float y0 = y - (j - t);
+	float z0 = z - (k - t);
+
+	/* each cell is split into six tetrahedra, determined by the magnitude
+	 * ordering of the offsets. Find the offsets of the second and third corners.
+	 */
+	int i1, j1, k1, i2, j2, k2;
+	if(x0 >= y0) {
+		if(y0 >= z0) {
+			i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 1; k2 = 0;
+		} else if(x0 >= z0) {
+			i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 0; k2 = 1;
+		} else {
+			i1 = 0; j1 = 0; k1 = 1; i2 = 1; j2 = 0; k2 = 1;
+		}
+	} else {
+		if(y0 < z0) {
+			i1 = 0; j1 = 0; k1 = 1; i2 = 0; j2 = 1; k2 = 1;
+		} else if(x0 < z0) {
+			i1 = 0; j1 = 1; k1 = 0; i2 = 0; j2 = 1; k2 = 1;
+		} else {
+			i1 = 0; j1 = 1; k1 = 0; i2 = 1; j2 = 1; k2 = 0;
+		}
+	}
+
+	int ii = i & BM;
+	int jj = j & BM;
+	int kk = k & BM;
+
+	float n = corner3(perm[ii + perm[jj + perm[kk]]], x0, y0, z0);
+	n += corner3(perm[ii + i1 + perm[jj + j1 + perm[kk + k1]]],
+			x0 - i1 + G3, y0 - j1 + G3, z0 - k1 + G3);
+	n += corner3(perm[ii + i2 + perm[jj + j2 + perm[kk + k2]]],
+			x0 - i2 + 2.0f * G3, y0 - j2 + 2.0f * G3, z0 - k2 + 2.0f * G3);
+	n += corner3(perm[ii + 1 + perm[jj + 1 + perm[kk + 1]]],
+			x0 - 1.0f + 3.0f * G3, y0 - 1.0f + 3.0f * G3, z0 - 1.0f + 3.0f * G3);
+
+	/* scale the result to about [-1, 1] */
+	return 32.0f * n;
+}
+
+float NoiseContext::snoise(float x, float y, float z, float w) const
+{
+	/* skew the input space to find which cell of the simplex lattice we're in */
+	float s = (x + y + z + w) * F4;
+	int i = fast_floor(x + s);
+	int j = fast_floor(y + s);
+	int k = fast_floor(z + s);
+	int l = fast_floor(w + s);
+
+	/* unskew the cell origin back, and get the offset from it */
+	float t = (i + j + k + l) * G4;
+	float x0 = x - (i - t);
+	float y0 = y - (j - t);
+	float z0 = z - (k - t);
+	float w0 = w - (l - t);
+
+	/* the simplex we're in is determined by the magnitude ordering of the
+	 * offsets. Rank each coordinate by how many of the others it exceeds.
+	 */
+	int rank_x = 0, rank_y = 0, rank_z = 0, rank_w = 0;
+	if(x0 > y0) rank_x++; else rank_y++;
+	if(x0 > z0) rank_x++; else rank_z++;
+	if(x0 > w0) rank_x++; else rank_w++;
+	if(y0 > z0) rank_y++; else rank_z++;
+	if(y0 > w0) rank_y++; else rank_w++;
+	if(z0 > w0) rank_z++; else rank_w++;
+
+	/* offsets of the second, third and fourth corners in lattice coordinates */
+	int i1 = rank_x >= 3, j1 = rank_y >= 3, k1 = rank_z >= 3, l1 = rank_w >= 3;
+	int i2 = rank_x >= 2, j2 = rank_y >= 2, k2 = rank_z >= 2, l2 = rank_w >= 2;
+	int i3 = rank_x >= 1, j3 = rank_y >= 1, k3 = rank_z >= 1, l3 = rank_w >= 1;
+
+	int ii = i & BM;
+	int jj = j & BM;
+	int kk = k & BM;
+	int ll = l & BM;
+
+	float n = corner4(perm[ii + perm[jj + perm[kk + perm[ll]]]],
+			x0, y0, z0, w0);
+	n += corner4(perm[ii + i1 + perm[jj + j1 + perm[kk + k1 + perm[ll + l1]]]],
+			x0 - i1 + G4, y0 - j1 + G4, z0 - k1 + G4, w0 - l1 + G4);
+	n += corner4(perm[ii + i2 + perm[jj + j2 + perm[kk + k2 + perm[ll + l2]]]],
+			x0 - i2 + 2.0f * G4, y0 - j2 + 2.0f * G4, z0 - k2 + 2.0f * G4, w0 - l2 + 2.0f * G4);
+	n += corner4(perm[ii + i3 + perm[jj + j3 + perm[kk + k3 + perm[ll + l3]]]],
+			x0 - i3 + 3.0f * G4, y0 - j3 + 3.0f * G4, z0 - k3 + 3.0f * G4, w0 - l3 + 3.0f * G4);
+	n += corner4(perm[ii + 1 + perm[jj + 1 + perm[kk + 1 + perm[ll + 1]]]],
+			x0 - 1.0f + 4.0f * G4, y0 - 1.0f + 4.0f * G4, z0 - 1.0f + 4.0f * G4, w0 - 1.0f + 4.0f * G4);
+
+	/* scale the result to about [-1, 1] */
+	return 27.0f * n;
+}
+
+/* 4D noise is simplex noise, see above. pnoise in 4D is still hypercube
+ * gradient noise, because the skewed simplex lattice can't be made to repeat
+ * along the coordinate axes with arbitrary periods.
+ */
+float NoiseContext::noise(float x, float y, float z, float w) const
+{
+	return snoise(x, y, z, w);
+}
+
+
+float NoiseContext::pnoise(float x, int period) const
 {
 	int bx0, bx1;
 	float rx0, rx1, sx, u, v;
 
-	init_once();
-
 	setup_p(x, bx0, bx1, rx0, rx1, period);
 	sx = s_curve(rx0);
 	u = rx0 * grad1[perm[bx0]];
@@ -206,15 +549,13 @@ float pnoise(float x, int period)
 	return lerp(u, v, sx);
 }
 
-float pnoise(float x, float y, int per_x, int per_y)
+float NoiseContext::pnoise(float x, float y, int per_x, int per_y) const
 {
 	int i, j, b00, b10, b01, b11;
 	int bx0, bx1, by0, by1;
 	float rx0, rx1, ry0, ry1;
 	float sx, sy, u, v, a, b;
 
-	init_once();
-
 	setup_p(x, bx0, bx1, rx0, rx1, per_x);
 	setup_p(y, by0, by1, ry0, ry1, per_y);
 
@@ -244,7 +585,7 @@ float pnoise(float x, float y, int per_x, int per_y)
 	return lerp(a, b, sy);
 }
 
-float pnoise(float x, float y, float z, int per_x, int per_y, int per_z)
+float NoiseContext::pnoise(float x, float y, float z, int per_x, int per_y, int per_z) const
 {
 	int i, j;
 	int bx0, bx1, by0, by1, bz0, bz1;
@@ -253,8 +594,6 @@ float pnoise(float x, float y, float z, int per_x, int per_y, int per_z)
 	float sx, sy, sz;
 	float u, v, a, b, c, d;
 
-	init_once();
-
 	setup_p(x, bx0, bx1, rx0, rx1, per_x);
 	setup_p(y, by0, by1, ry0, ry1, per_y);
 	setup_p(z, bz0, bz1, rz0, rz1, per_z);
@@ -298,163 +637,676 @@ float pnoise(float x, float y, float z, int per_x, int per_y, int per_z)
 	return lerp(c, d, sz);
 }
 
-float pnoise(float x, float y, float z, float w, int per_x, int per_y, int per_z, int per_w)
+/* bilinear interpolation of the gradients over the xy face of a 4D cell, at
+ * the lattice z and w coordinates bz and bw
+ */
+static inline float face4(const int *perm, const Vec4 *grad4, int b00, int b10, int b01, int b11,
+		int bz, int bw, float rx0, float rx1, float ry0, float ry1, float rz, float rw, float sx, float sy)
 {
-	return 0;
-}
+	float u, v, a, b;
 
+	u = dot(grad4[perm[b00 + bz] + bw], Vec4(rx0, ry0, rz, rw));
+	v = dot(grad4[perm[b10 + bz] + bw], Vec4(rx1, ry0, rz, rw));
+	a = lerp(u, v, sx);
 
-float fbm(float x, int octaves)
+	u = dot(grad4[perm[b01 + bz] + bw], Vec4(rx0, ry1, rz, rw));
+	v = dot(grad4[perm[b11 + bz] + bw], Vec4(rx1, ry1, rz, rw));
+	b = lerp(u, v, sx);
+
+	return lerp(a, b, sy);
+}
+
+float NoiseContext::pnoise(float x, float y, float z, float w, int per_x, int per_y, int per_z, int per_w) const
 {
-	float res = 0.0f, freq = 1.0f;
-	for(int i=0; i<octaves; i++) {
-		res += noise(x * freq) / freq;
-		freq *= 2.0f;
-	}
-	return res;
+	int i, j;
+	int bx0, bx1, by0, by1, bz0, bz1, bw0, bw1;
+	int b00, b10, b01, b11;
+	float rx0, rx1, ry0, ry1, rz0, rz1, rw0, rw1;
+	float sx, sy, sz, sw;
+	float a, b, c, d;
+
+	setup_p(x, bx0, bx1, rx0, rx1, per_x);
+	setup_p(y, by0, by1, ry0, ry1, per_y);
+	setup_p(z, bz0, bz1, rz0, rz1, per_z);
+	setup_p(w, bw0, bw1, rw0, rw1, per_w);
+
+	i = perm[bx0];
+	j = perm[bx1];
+
+	b00 = perm[i + by0];
+	b10 = perm[j + by0];
+	b01 = perm[i + by1];
+	b11 = perm[j + by1];
+
+	/* calculate hermite interpolating factors */
+	sx = s_curve(rx0);
+	sy = s_curve(ry0);
+	sz = s_curve(rz0);
+	sw = s_curve(rw0);
+
+	/* interpolate between the two z slices of the first w slice */
+	a = face4(perm, grad4, b00, b10, b01, b11, bz0, bw0, rx0, rx1, ry0, ry1, rz0, rw0, sx, sy);
+	b = face4(perm, grad4, b00, b10, b01, b11, bz1, bw0, rx0, rx1, ry0, ry1, rz1, rw0, sx, sy);
+	c = lerp(a, b, sz);
+
+	/* ... and the second w slice */
+	a = face4(perm, grad4, b00, b10, b01, b11, bz0, bw1, rx0, rx1, ry0, ry1, rz0, rw1, sx, sy);
+	b = face4(perm, grad4, b00, b10, b01, b11, bz1, bw1, rx0, rx1, ry0, ry1, rz1, rw1, sx, sy);
+	d = lerp(a, b, sz);
+
+	/* interpolate between w slices */
+	return lerp(c, d, sw);
 }
 
-float fbm(float x, float y, int octaves)
+
+/* ---- batched noise, 4 points at a time ----
+ * The lattice setup and permutation lookups are done per lane, since there are
+ * no gathers to speak of, and everything else in SIMD. For grids too sparse
+ * for the method below, the lattice setup along x is done once for the whole
+ * grid, and along y and z once per row.
+ */
+struct Lattice4 {
+	int b0[4], b1[4];
+	Float4 r0, r1, s;
+};
+
+static void setup4(const float *elem, Lattice4 *lat)
 {
-	float res = 0.0f, freq = 1.0f;
-	for(int i=0; i<octaves; i++) {
-		res += noise(x * freq, y * freq) / freq;
-		freq *= 2.0f;
+	float r0[4], r1[4];
+	for(int i=0; i<4; i++) {
+		setup(elem[i], lat->b0[i], lat->b1[i], r0[i], r1[i]);
 	}
-	return res;
+	lat->r0 = Float4(r0);
+	lat->r1 = Float4(r1);
+	lat->s = s_curve(lat->r0);
 }
 
-float fbm(float x, float y, float z, int octaves)
+#ifndef GPH_SIMD_AVX2
+// same lattice for all lanes
+static void setup4(float elem, Lattice4 *lat)
 {
-	float res = 0.0f, freq = 1.0f;
-	for(int i=0; i<octaves; i++) {
-		res += noise(x * freq, y * freq, z * freq) / freq;
-		freq *= 2.0f;
+	float r0, r1;
+	setup(elem, lat->b0[0], lat->b1[0], r0, r1);
+	for(int i=1; i<4; i++) {
+		lat->b0[i] = lat->b0[0];
+		lat->b1[i] = lat->b1[0];
 	}
-	return res;
-
+	lat->r0 = Float4(r0);
+	lat->r1 = Float4(r1);
+	lat->s = s_curve(lat->r0);
 }
+#endif
 
-float fbm(float x, float y, float z, float w, int octaves)
+static inline Float4 grad2_dot(const Vec2 *grad2, const int *b, const Float4 &rx, const Float4 &ry)
 {
-	float res = 0.0f, freq = 1.0f;
-	for(int i=0; i<octaves; i++) {
-		res += noise(x * freq, y * freq, z * freq, w * freq) / freq;
-		freq *= 2.0f;
-	}
-	return res;
+	Float4 gx = Float4(grad2[b[0]].x, grad2[b[1]].x, grad2[b[2]].x, grad2[b[3]].x);
+	Float4 gy = Float4(grad2[b[0]].y, grad2[b[1]].y, grad2[b[2]].y, grad2[b[3]].y);
+	return gx * rx + gy * ry;
 }
 
+static inline Float4 grad3_dot(const Vec3 *grad3, const int *b, const int *bz, const Vec3x4 &r)
+{
+	Vec3x4 g = Vec3x4(grad3[b[0] + bz[0]], grad3[b[1] + bz[1]],
+			grad3[b[2] + bz[2]], grad3[b[3] + bz[3]]);
+	return dot(g, r);
+}
 
-float pfbm(float x, int per, int octaves)
+static Float4 noise4(const int *perm, const Vec2 *grad2, const Lattice4 &lx, const Lattice4 &ly)
 {
-	float res = 0.0f, freq = 1.0f;
-	for(int i=0; i<octaves; i++) {
-		res += pnoise(x * freq, per) / freq;
-		freq *= 2.0f;
-		per *= 2;
+	int b00[4], b10[4], b01[4], b11[4];
+	for(int k=0; k<4; k++) {
+		int i = perm[lx.b0[k]];
+		int j = perm[lx.b1[k]];
+		b00[k] = perm[i + ly.b0[k]];
+		b10[k] = perm[j + ly.b0[k]];
+		b01[k] = perm[i + ly.b1[k]];
+		b11[k] = perm[j + ly.b1[k]];
 	}
-	return res;
+
+	Float4 u = grad2_dot(grad2, b00, lx.r0, ly.r0);
+	Float4 v = grad2_dot(grad2, b10, lx.r1, ly.r0);
+	Float4 a = lerp(u, v, lx.s);
+
+	u = grad2_dot(grad2, b01, lx.r0, ly.r1);
+	v = grad2_dot(grad2, b11, lx.r1, ly.r1);
+	Float4 b = lerp(u, v, lx.s);
+
+	return lerp(a, b, ly.s);
 }
 
-float pfbm(float x, float y, int per_x, int per_y, int octaves)
+static Float4 noise4(const int *perm, const Vec3 *grad3, const Lattice4 &lx,
+		const Lattice4 &ly, const Lattice4 &lz)
 {
-	float res = 0.0f, freq = 1.0f;
-	for(int i=0; i<octaves; i++) {
-		res += pnoise(x * freq, y * freq, per_x, per_y) / freq;
-		freq *= 2.0f;
-		per_x *= 2;
-		per_y *= 2;
+	int b00[4], b10[4], b01[4], b11[4];
+	for(int k=0; k<4; k++) {
+		int i = perm[lx.b0[k]];
+		int j = perm[lx.b1[k]];
+		b00[k] = perm[i + ly.b0[k]];
+		b10[k] = perm[j + ly.b0[k]];
+		b01[k] = perm[i + ly.b1[k]];
+		b11[k] = perm[j + ly.b1[k]];
 	}
-	return res;
+
+	Float4 u = grad3_dot(grad3, b00, lz.b0, Vec3x4(lx.r0, ly.r0, lz.r0));
+	Float4 v = grad3_dot(grad3, b10, lz.b0, Vec3x4(lx.r1, ly.r0, lz.r0));
+	Float4 a = lerp(u, v, lx.s);
+
+	u = grad3_dot(grad3, b01, lz.b0, Vec3x4(lx.r0, ly.r1, lz.r0));
+	v = grad3_dot(grad3, b11, lz.b0, Vec3x4(lx.r1, ly.r1, lz.r0));
+	Float4 b = lerp(u, v, lx.s);
+
+	Float4 c = lerp(a, b, ly.s);
+
+	u = grad3_dot(grad3, b00, lz.b1, Vec3x4(lx.r0, ly.r0, lz.r1));
+	v = grad3_dot(grad3, b10, lz.b1, Vec3x4(lx.r1, ly.r0, lz.r1));
+	a = lerp(u, v, lx.s);
+
+	u = grad3_dot(grad3, b01, lz.b1, Vec3x4(lx.r0, ly.r1, lz.r1));
+	v = grad3_dot(grad3, b11, lz.b1, Vec3x4(lx.r1, ly.r1, lz.r1));
+	b = lerp(u, v, lx.s);
+
+	Float4 d = lerp(a, b, ly.s);
+
+	return lerp(c, d, lz.s);
 }
 
-float pfbm(float x, float y, float z, int per_x, int per_y, int per_z, int octaves)
+/* writes the first count (at most 4) lanes of res to dest */
+static inline void store4(float *dest, const Float4 &res, int count)
 {
-	float res = 0.0f, freq = 1.0f;
-	for(int i=0; i<octaves; i++) {
-		res += pnoise(x * freq, y * freq, z * freq, per_x, per_y, per_z) / freq;
-		freq *= 2.0f;
-		per_x *= 2;
-		per_y *= 2;
-		per_z *= 2;
+	if(count >= 4) {
+		res.store(dest);
+	} else {
+		float tmp[4];
+		res.store(tmp);
+		for(int i=0; i<count; i++) {
+			dest[i] = tmp[i];
+		}
 	}
-	return res;
 }
 
-float pfbm(float x, float y, float z, float w, int per_x, int per_y, int per_z, int per_w, int octaves)
+#ifndef GPH_SIMD_AVX2
+/* lattice setup for the x coordinates of a grid row, in groups of 4. The last
+ * group is padded by repeating the last coordinate.
+ */
+static void setup_grid_x(std::vector<Lattice4> &lat, int xsz, float origin, float step)
 {
-	float res = 0.0f, freq = 1.0f;
-	for(int i=0; i<octaves; i++) {
-		res += pnoise(x * freq, y * freq, z * freq, w * freq,
-				per_x, per_y, per_z, per_w) / freq;
-		freq *= 2.0f;
-		per_x *= 2;
-		per_y *= 2;
-		per_z *= 2;
-		per_w *= 2;
+	lat.resize((xsz + 3) / 4);
+	for(size_t i=0; i<lat.size(); i++) {
+		float x[4];
+		for(int j=0; j<4; j++) {
+			int col = i * 4 + j;
+			if(col >= xsz) col = xsz - 1;
+			x[j] = origin + step * col;
+		}
+		setup4(x, &lat[i]);
 	}
-	return res;
 }
+#endif
+
+/* ---- grids sampled more densely than the lattice ----
+ * Along a grid row only x changes. Interpolating the corner contributions of a
+ * lattice cell along y (and z) first, what's left at each of the two lattice
+ * points along x is a linear function of the offset from it: g * rx + c, which
+ * only depends on the lattice point and the row. So g and c are calculated
+ * once per lattice point spanned by the row, and each sample just interpolates
+ * between the two lattice points around it, instead of hashing and
+ * interpolating 4 or 8 corners. The results differ from noise only by
+ * rounding, since the interpolations are done in a different order.
+ */
+struct GridCols {
+	int first;				// first lattice point spanned by the row
+	int num_points;			// number of lattice points spanned
+	std::vector<int> idx;	// lattice point left of each sample, relative to first
+	std::vector<float> r, s;	// offset from it and interpolation factor
+};
+
+/* Sets up the lattice points and offsets of the samples along x, which are the
+ * same for every row. Returns false if there are too few samples per lattice
+ * point for this to be worth it.
+ */
+static bool setup_grid_cols(GridCols *gc, int xsz, float origin, float step)
+{
+	gc->idx.resize(xsz);
+	gc->r.resize(xsz);
+	gc->s.resize(xsz);
+
+	int cmin = 0, cmax = 0;
+	for(int i=0; i<xsz; i++) {
+		float t = origin + step * i + N;
+		int c = (int)t;
+		gc->idx[i] = c;
+		gc->r[i] = t - c;
+		gc->s[i] = s_curve(gc->r[i]);
+
+		if(i == 0 || c < cmin) cmin = c;
+		if(i == 0 || c > cmax) cmax = c;
+	}
 
+	gc->first = cmin;
+	gc->num_points = cmax - cmin + 2;
+	if(gc->num_points * 2 > xsz) {
+		return false;
+	}
 
-float turbulence(float x, int octaves)
-{
-	float res = 0.0f, freq = 1.0f;
-	for(int i=0; i<octaves; i++) {
-		res += fabs(noise(x * freq) / freq);
-		freq *= 2.0f;
+	for(int i=0; i<xsz; i++) {
+		gc->idx[i] -= cmin;
 	}
-	return res;
+	return true;
 }
 
-float turbulence(float x, float y, int octaves)
+static void grid_coef(const int *perm, const Vec2 *grad2, const GridCols &gc, float y,
+		float *coef_g, float *coef_c)
 {
-	float res = 0.0f, freq = 1.0f;
-	for(int i=0; i<octaves; i++) {
-		res += fabs(noise(x * freq, y * freq) / freq);
-		freq *= 2.0f;
+	int by0, by1;
+	float ry0, ry1;
+	setup(y, by0, by1, ry0, ry1);
+	float sy = s_curve(ry0);
+
+	for(int i=0; i<gc.num_points; i++) {
+		int b = perm[(gc.first + i) & BM];
+		const Vec2 &g0 = grad2[perm[b + by0]];
+		const Vec2 &g1 = grad2[perm[b + by1]];
+
+		coef_g[i] = lerp(g0.x, g1.x, sy);
+		coef_c[i] = lerp(g0.y * ry0, g1.y * ry1, sy);
 	}
-	return res;
 }
 
-float turbulence(float x, float y, float z, int octaves)
+static void grid_coef(const int *perm, const Vec3 *grad3, const GridCols &gc, float y, float z,
+		float *coef_g, float *coef_c)
 {
-	float res = 0.0f, freq = 1.0f;
-	for(int i=0; i<octaves; i++) {
-		res += fabs(noise(x * freq, y * freq, z * freq) / freq);
-		freq *= 2.0f;
+	int by0, by1, bz0, bz1;
+	float ry0, ry1, rz0, rz1;
+	setup(y, by0, by1, ry0, ry1);
+	setup(z, bz0, bz1, rz0, rz1);
+	float sy = s_curve(ry0);
+	float sz = s_curve(rz0);
+
+	for(int i=0; i<gc.num_points; i++) {
+		int b = perm[(gc.first + i) & BM];
+		int b0 = perm[b + by0];
+		int b1 = perm[b + by1];
+		const Vec3 &g00 = grad3[b0 + bz0];
+		const Vec3 &g10 = grad3[b1 + bz0];
+		const Vec3 &g01 = grad3[b0 + bz1];
+		const Vec3 &g11 = grad3[b1 + bz1];
+
+		coef_g[i] = lerp(lerp(g00.x, g10.x, sy), lerp(g01.x, g11.x, sy), sz);
+		coef_c[i] = lerp(lerp(g00.y * ry0 + g00.z * rz0, g10.y * ry1 + g10.z * rz0, sy),
+				lerp(g01.y * ry0 + g01.z * rz1, g11.y * ry1 + g11.z * rz1, sy), sz);
 	}
-	return res;
 }
 
-float turbulence(float x, float y, float z, float w, int octaves)
+static void grid_row(float *dest, const GridCols &gc, const float *coef_g, const float *coef_c)
 {
-	float res = 0.0f, freq = 1.0f;
-	for(int i=0; i<octaves; i++) {
-		res += fabs(noise(x * freq, y * freq, z * freq, w * freq) / freq);
-		freq *= 2.0f;
+	int xsz = (int)gc.idx.size();
+	for(int i=0; i<xsz; i++) {
+		int c = gc.idx[i];
+		float r = gc.r[i];
+		float a = coef_g[c] * r + coef_c[c];
+		float b = coef_g[c + 1] * (r - 1.0f) + coef_c[c + 1];
+		dest[i] = lerp(a, b, gc.s[i]);
 	}
-	return res;
 }
 
+#ifdef GPH_SIMD_AVX2
+/* ---- batched noise, 8 points at a time with AVX2 ----
+ * Same as above, but the lattice setup is done in SIMD as well, and the
+ * permutation and gradient lookups use gathers. Gradients are gathered one
+ * component at a time, straight from the Vec2/Vec3 arrays, by scaling the
+ * indices by the array stride.
+ */
+struct Lattice8 {
+	__m256i b0, b1;
+	Float8 r0, r1, s;
+};
+
+static inline void setup8(const Float8 &elem, Lattice8 *lat)
+{
+	__m256 t = _mm256_add_ps(elem.v, _mm256_set1_ps((float)N));
+	__m256i ti = _mm256_cvttps_epi32(t);
+	__m256i bm = _mm256_set1_epi32(BM);
+	lat->b0 = _mm256_and_si256(ti, bm);
+	lat->b1 = _mm256_and_si256(_mm256_add_epi32(lat->b0, _mm256_set1_epi32(1)), bm);
+	lat->r0 = Float8(_mm256_sub_ps(t, _mm256_cvtepi32_ps(ti)));
+	lat->r1 = lat->r0 - Float8(1.0f);
+	lat->s = s_curve(lat->r0);
+}
 
-float pturbulence(float x, int per, int octaves)
+static inline __m256i perm8(const int *perm, __m256i idx)
 {
-	float res = 0.0f, freq = 1.0f;
-	for(int i=0; i<octaves; i++) {
-		res += fabs(pnoise(x * freq, per) / freq);
-		freq *= 2.0f;
-		per *= 2;
-	}
-	return res;
+	return _mm256_i32gather_epi32(perm, idx, 4);
 }
 
-float pturbulence(float x, float y, int per_x, int per_y, int octaves)
+static inline Float8 grad2_dot8(const Vec2 *grad2, __m256i b, const Float8 &rx, const Float8 &ry)
 {
-	float res = 0.0f, freq = 1.0f;
-	for(int i=0; i<octaves; i++) {
-		res += fabs(pnoise(x * freq, y * freq, per_x, per_y) / freq);
+	Float8 gx = _mm256_i32gather_ps(&grad2->x, b, 8);
+	Float8 gy = _mm256_i32gather_ps(&grad2->y, b, 8);
+	return gx * rx + gy * ry;
+}
+
+static inline Float8 grad3_dot8(const Vec3 *grad3, __m256i b, __m256i bz, const Float8 &rx,
+		const Float8 &ry, const Float8 &rz)
+{
+	__m256i idx = _mm256_add_epi32(b, bz);
+	idx = _mm256_add_epi32(idx, _mm256_add_epi32(idx, idx));	// * 3 floats per Vec3
+	Float8 gx = _mm256_i32gather_ps(&grad3->x, idx, 4);
+	Float8 gy = _mm256_i32gather_ps(&grad3->y, idx, 4);
+	Float8 gz = _mm256_i32gather_ps(&grad3->z, idx, 4);
+	return gx * rx + gy * ry + gz * rz;
+}
+
+static Float8 noise8(const int *perm, const Vec2 *grad2, const Lattice8 &lx, const Lattice8 &ly)
+{
+	__m256i i = perm8(perm, lx.b0);
+	__m256i j = perm8(perm, lx.b1);
+	__m256i b00 = perm8(perm, _mm256_add_epi32(i, ly.b0));
+	__m256i b10 = perm8(perm, _mm256_add_epi32(j, ly.b0));
+	__m256i b01 = perm8(perm, _mm256_add_epi32(i, ly.b1));
+	__m256i b11 = perm8(perm, _mm256_add_epi32(j, ly.b1));
+
+	Float8 u = grad2_dot8(grad2, b00, lx.r0, ly.r0);
+	Float8 v = grad2_dot8(grad2, b10, lx.r1, ly.r0);
+	Float8 a = lerp(u, v, lx.s);
+
+	u = grad2_dot8(grad2, b01, lx.r0, ly.r1);
+	v = grad2_dot8(grad2, b11, lx.r1, ly.r1);
+	Float8 b = lerp(u, v, lx.s);
+
+	return lerp(a, b, ly.s);
+}
+
+static Float8 noise8(const int *perm, const Vec3 *grad3, const Lattice8 &lx,
+		const Lattice8 &ly, const Lattice8 &lz)
+{
+	__m256i i = perm8(perm, lx.b0);
+	__m256i j = perm8(perm, lx.b1);
+	__m256i b00 = perm8(perm, _mm256_add_epi32(i, ly.b0));
+	__m256i b10 = perm8(perm, _mm256_add_epi32(j, ly.b0));
+	__m256i b01 = perm8(perm, _mm256_add_epi32(i, ly.b1));
+	__m256i b11 = perm8(perm, _mm256_add_epi32(j, ly.b1));
+
+	Float8 u = grad3_dot8(grad3, b00, lz.b0, lx.r0, ly.r0, lz.r0);
+	Float8 v = grad3_dot8(grad3, b10, lz.b0, lx.r1, ly.r0, lz.r0);
+	Float8 a = lerp(u, v, lx.s);
+
+	u = grad3_dot8(grad3, b01, lz.b0, lx.r0, ly.r1, lz.r0);
+	v = grad3_dot8(grad3, b11, lz.b0, lx.r1, ly.r1, lz.r0);
+	Float8 b = lerp(u, v, lx.s);
+
+	Float8 c = lerp(a, b, ly.s);
+
+	u = grad3_dot8(grad3, b00, lz.b1, lx.r0, ly.r0, lz.r1);
+	v = grad3_dot8(grad3, b10, lz.b1, lx.r1, ly.r0, lz.r1);
+	a = lerp(u, v, lx.s);
+
+	u = grad3_dot8(grad3, b01, lz.b1, lx.r0, ly.r1, lz.r1);
+	v = grad3_dot8(grad3, b11, lz.b1, lx.r1, ly.r1, lz.r1);
+	b = lerp(u, v, lx.s);
+
+	Float8 d = lerp(a, b, ly.s);
+
+	return lerp(c, d, lz.s);
+}
+
+/* writes the first count (at most 8) lanes of res to dest */
+static inline void store8(float *dest, const Float8 &res, int count)
+{
+	if(count >= 8) {
+		res.store(dest);
+	} else {
+		float tmp[8];
+		res.store(tmp);
+		for(int i=0; i<count; i++) {
+			dest[i] = tmp[i];
+		}
+	}
+}
+
+/* x coordinates of a grid row, padded to a multiple of 8 by repeating the
+ * last one. The lattice setup is cheap enough in SIMD to redo for every row,
+ * which avoids keeping 32-byte aligned lattices in a vector.
+ */
+static void setup_grid_x8(std::vector<float> &xcoord, int xsz, float origin, float step)
+{
+	xcoord.resize((xsz + 7) & ~7);
+	for(size_t i=0; i<xcoord.size(); i++) {
+		int col = (int)i < xsz ? (int)i : xsz - 1;
+		xcoord[i] = origin + step * col;
+	}
+}
+#endif	// GPH_SIMD_AVX2
+
+void NoiseContext::noise_batch(float *dest, const Vec2 *pos, int count) const
+{
+#ifdef GPH_SIMD_AVX2
+	for(int i=0; i<count; i+=8) {
+		float x[8], y[8];
+		for(int j=0; j<8; j++) {
+			const Vec2 &p = pos[i + j < count ? i + j : count - 1];
+			x[j] = p.x;
+			y[j] = p.y;
+		}
+		Lattice8 lx, ly;
+		setup8(Float8(x), &lx);
+		setup8(Float8(y), &ly);
+		store8(dest + i, noise8(perm, grad2, lx, ly), count - i);
+	}
+#else
+	for(int i=0; i<count; i+=4) {
+		float x[4], y[4];
+		for(int j=0; j<4; j++) {
+			const Vec2 &p = pos[i + j < count ? i + j : count - 1];
+			x[j] = p.x;
+			y[j] = p.y;
+		}
+		Lattice4 lx, ly;
+		setup4(x, &lx);
+		setup4(y, &ly);
+		store4(dest + i, noise4(perm, grad2, lx, ly), count - i);
+	}
+#endif
+}
+
+void NoiseContext::noise_batch(float *dest, const Vec3 *pos, int count) const
+{
+#ifdef GPH_SIMD_AVX2
+	for(int i=0; i<count; i+=8) {
+		float x[8], y[8], z[8];
+		for(int j=0; j<8; j++) {
+			const Vec3 &p = pos[i + j < count ? i + j : count - 1];
+			x[j] = p.x;
+			y[j] = p.y;
+			z[j] = p.z;
+		}
+		Lattice8 lx, ly, lz;
+		setup8(Float8(x), &lx);
+		setup8(Float8(y), &ly);
+		setup8(Float8(z), &lz);
+		store8(dest + i, noise8(perm, grad3, lx, ly, lz), count - i);
+	}
+#else
+	for(int i=0; i<count; i+=4) {
+		float x[4], y[4], z[4];
+		for(int j=0; j<4; j++) {
+			const Vec3 &p = pos[i + j < count ? i + j : count - 1];
+			x[j] = p.x;
+			y[j] = p.y;
+			z[j] = p.z;
+		}
+		Lattice4 lx, ly, lz;
+		setup4(x, &lx);
+		setup4(y, &ly);
+		setup4(z, &lz);
+		store4(dest + i, noise4(perm, grad3, lx, ly, lz), count - i);
+	}
+#endif
+}
+
+void NoiseContext::noise_grid(float *dest, int xsz, int ysz, const Vec2 &origin, const Vec2 &step) const
+{
+	if(xsz <= 0 || ysz <= 0) return;
+
+	GridCols gc;
+	if(setup_grid_cols(&gc, xsz, origin.x, step.x)) {
+		std::vector<float> coef(gc.num_points * 2);
+		for(int i=0; i<ysz; i++) {
+			grid_coef(perm, grad2, gc, origin.y + step.y * i, &coef[0], &coef[gc.num_points]);
+			grid_row(dest, gc, &coef[0], &coef[gc.num_points]);
+			dest += xsz;
+		}
+		return;
+	}
+
+#ifdef GPH_SIMD_AVX2
+	std::vector<float> xcoord;
+	setup_grid_x8(xcoord, xsz, origin.x, step.x);
+
+	for(int i=0; i<ysz; i++) {
+		Lattice8 ly;
+		setup8(Float8(origin.y + step.y * i), &ly);
+
+		for(int j=0; j<xsz; j+=8) {
+			Lattice8 lx;
+			setup8(Float8(&xcoord[j]), &lx);
+			store8(dest + j, noise8(perm, grad2, lx, ly), xsz - j);
+		}
+		dest += xsz;
+	}
+#else
+	std::vector<Lattice4> lx;
+	setup_grid_x(lx, xsz, origin.x, step.x);
+
+	for(int i=0; i<ysz; i++) {
+		Lattice4 ly;
+		setup4(origin.y + step.y * i, &ly);
+
+		for(size_t j=0; j<lx.size(); j++) {
+			store4(dest + j * 4, noise4(perm, grad2, lx[j], ly), xsz - j * 4);
+		}
+		dest += xsz;
+	}
+#endif
+}
+
+void NoiseContext::noise_grid(float *dest, int xsz, int ysz, int zsz, const Vec3 &origin, const Vec3 &step) const
+{
+	if(xsz <= 0 || ysz <= 0 || zsz <= 0) return;
+
+	GridCols gc;
+	if(setup_grid_cols(&gc, xsz, origin.x, step.x)) {
+		std::vector<float> coef(gc.num_points * 2);
+		for(int i=0; i<zsz; i++) {
+			float z = origin.z + step.z * i;
+			for(int j=0; j<ysz; j++) {
+				grid_coef(perm, grad3, gc, origin.y + step.y * j, z, &coef[0], &coef[gc.num_points]);
+				grid_row(dest, gc, &coef[0], &coef[gc.num_points]);
+				dest += xsz;
+			}
+		}
+		return;
+	}
+
+#ifdef GPH_SIMD_AVX2
+	std::vector<float> xcoord;
+	setup_grid_x8(xcoord, xsz, origin.x, step.x);
+
+	for(int i=0; i<zsz; i++) {
+		Lattice8 lz;
+		setup8(Float8(origin.z + step.z * i), &lz);
+
+		for(int j=0; j<ysz; j++) {
+			Lattice8 ly;
+			setup8(Float8(origin.y + step.y * j), &ly);
+
+			for(int k=0; k<xsz; k+=8) {
+				Lattice8 lx;
+				setup8(Float8(&xcoord[k]), &lx);
+				store8(dest + k, noise8(perm, grad3, lx, ly, lz), xsz - k);
+			}
+			dest += xsz;
+		}
+	}
+#else
+	std::vector<Lattice4> lx;
+	setup_grid_x(lx, xsz, origin.x, step.x);
+
+	for(int i=0; i<zsz; i++) {
+		Lattice4 lz;
+		setup4(origin.z + step.z * i, &lz);
+
+		for(int j=0; j<ysz; j++) {
+			Lattice4 ly;
+			setup4(origin.y + step.y * j, &ly);
+
+			for(size_t k=0; k<lx.size(); k++) {
+				store4(dest + k * 4, noise4(perm, grad3, lx[k], ly, lz), xsz - k * 4);
+			}
+			dest += xsz;
+		}
+	}
+#endif
+}
+
+
+float NoiseContext::fbm(float x, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	for(int i=0; i<octaves; i++) {
+		res += noise(x * freq) / freq;
+		freq *= 2.0f;
+	}
+	return res;
+}
+
+float NoiseContext::fbm(float x, float y, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	for(int i=0; i<octaves; i++) {
+		res += noise(x * freq, y * freq) / freq;
+		freq *= 2.0f;
+	}
+	return res;
+}
+
+float NoiseContext::fbm(float x, float y, float z, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	for(int i=0; i<octaves; i++) {
+		res += noise(x * freq, y * freq, z * freq) / freq;
+		freq *= 2.0f;
+	}
+	return res;
+
+}
+
+float NoiseContext::fbm(float x, float y, float z, float w, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	for(int i=0; i<octaves; i++) {
+		res += noise(x * freq, y * freq, z * freq, w * freq) / freq;
+		freq *= 2.0f;
+	}
+	return res;
+}
+
+
+float NoiseContext::pfbm(float x, int per, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	for(int i=0; i<octaves; i++) {
+		res += pnoise(x * freq, per) / freq;
+		freq *= 2.0f;
+		per *= 2;
+	}
+	return res;
+}
+
+float NoiseContext::pfbm(float x, float y, int per_x, int per_y, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	for(int i=0; i<octaves; i++) {
+		res += pnoise(x * freq, y * freq, per_x, per_y) / freq;
 		freq *= 2.0f;
 		per_x *= 2;
 		per_y *= 2;
@@ -462,7 +1314,100 @@ float pturbulence(float x, float y, int per_x, int per_y, int octaves)
 	return res;
 }
 
-float pturbulence(float x, float y, float z, int per_x, int per_y, int per_z, int octaves)
+float NoiseContext::pfbm(float x, float y, float z, int per_x, int per_y, int per_z, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	for(int i=0; i<octaves; i++) {
+		res += pnoise(x * freq, y * freq, z * freq, per_x, per_y, per_z) / freq;
+		freq *= 2.0f;
+		per_x *= 2;
+		per_y *= 2;
+		per_z *= 2;
+	}
+	return res;
+}
+
+float NoiseContext::pfbm(float x, float y, float z, float w, int per_x, int per_y, int per_z, int per_w, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	for(int i=0; i<octaves; i++) {
+		res += pnoise(x * freq, y * freq, z * freq, w * freq,
+				per_x, per_y, per_z, per_w) / freq;
+		freq *= 2.0f;
+		per_x *= 2;
+		per_y *= 2;
+		per_z *= 2;
+		per_w *= 2;
+	}
+	return res;
+}
+
+
+float NoiseContext::turbulence(float x, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	for(int i=0; i<octaves; i++) {
+		res += fabs(noise(x * freq) / freq);
+		freq *= 2.0f;
+	}
+	return res;
+}
+
+float NoiseContext::turbulence(float x, float y, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	for(int i=0; i<octaves; i++) {
+		res += fabs(noise(x * freq, y * freq) / freq);
+		freq *= 2.0f;
+	}
+	return res;
+}
+
+float NoiseContext::turbulence(float x, float y, float z, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	for(int i=0; i<octaves; i++) {
+		res += fabs(noise(x * freq, y * freq, z * freq) / freq);
+		freq *= 2.0f;
+	}
+	return res;
+}
+
+float NoiseContext::turbulence(float x, float y, float z, float w, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	for(int i=0; i<octaves; i++) {
+		res += fabs(noise(x * freq, y * freq, z * freq, w * freq) / freq);
+		freq *= 2.0f;
+	}
+	return res;
+}
+
+
+float NoiseContext::pturbulence(float x, int per, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	for(int i=0; i<octaves; i++) {
+		res += fabs(pnoise(x * freq, per) / freq);
+		freq *= 2.0f;
+		per *= 2;
+	}
+	return res;
+}
+
+float NoiseContext::pturbulence(float x, float y, int per_x, int per_y, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	for(int i=0; i<octaves; i++) {
+		res += fabs(pnoise(x * freq, y * freq, per_x, per_y) / freq);
+		freq *= 2.0f;
+		per_x *= 2;
+		per_y *= 2;
+	}
+	return res;
+}
+
+float NoiseContext::pturbulence(float x, float y, float z, int per_x, int per_y, int per_z, int octaves) const
 {
 	float res = 0.0f, freq = 1.0f;
 	for(int i=0; i<octaves; i++) {
@@ -475,7 +1420,7 @@ float pturbulence(float x, float y, float z, int per_x, int per_y, int per_z, in
 	return res;
 }
 
-float pturbulence(float x, float y, float z, float w, int per_x, int per_y, int per_z, int per_w, int octaves)
+float NoiseContext::pturbulence(float x, float y, float z, float w, int per_x, int per_y, int per_z, int per_w, int octaves) const
 {
 	float res = 0.0f, freq = 1.0f;
 	for(int i=0; i<octaves; i++) {
@@ -490,4 +1435,830 @@ float pturbulence(float x, float y, float z, float w, int per_x, int per_y, int
 	return res;
 }
 
+
+float NoiseContext::sfbm(float x, float y, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	for(int i=0; i<octaves; i++) {
+		res += snoise(x * freq, y * freq) / freq;
+		freq *= 2.0f;
+	}
+	return res;
+}
+
+float NoiseContext::sfbm(float x, float y, float z, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	for(int i=0; i<octaves; i++) {
+		res += snoise(x * freq, y * freq, z * freq) / freq;
+		freq *= 2.0f;
+	}
+	return res;
+}
+
+float NoiseContext::sfbm(float x, float y, float z, float w, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	for(int i=0; i<octaves; i++) {
+		res += snoise(x * freq, y * freq, z * freq, w * freq) / freq;
+		freq *= 2.0f;
+	}
+	return res;
+}
+
+
+float NoiseContext::sturbulence(float x, float y, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	for(int i=0; i<octaves; i++) {
+		res += fabs(snoise(x * freq, y * freq) / freq);
+		freq *= 2.0f;
+	}
+	return res;
+}
+
+float NoiseContext::sturbulence(float x, float y, float z, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	for(int i=0; i<octaves; i++) {
+		res += fabs(snoise(x * freq, y * freq, z * freq) / freq);
+		freq *= 2.0f;
+	}
+	return res;
+}
+
+float NoiseContext::sturbulence(float x, float y, float z, float w, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	for(int i=0; i<octaves; i++) {
+		res += fabs(snoise(x * freq, y * freq, z * freq, w * freq) / freq);
+		freq *= 2.0f;
+	}
+	return res;
+}
+
+
+/* the gradient of each octave, noise(p * freq) / freq, is just the gradient
+ * of noise at p * freq, so octave gradients are added up unscaled
+ */
+float NoiseContext::fbm_d(float x, float y, Vec2 *grad, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	*grad = Vec2(0.0f, 0.0f);
+	for(int i=0; i<octaves; i++) {
+		Vec2 g;
+		res += noise_d(x * freq, y * freq, &g) / freq;
+		*grad += g;
+		freq *= 2.0f;
+	}
+	return res;
+}
+
+float NoiseContext::fbm_d(float x, float y, float z, Vec3 *grad, int octaves) const
+{
+	float res = 0.0f, freq = 1.0f;
+	*grad = Vec3(0.0f, 0.0f, 0.0f);
+	for(int i=0; i<octaves; i++) {
+		Vec3 g;
+		res += noise_d(x * freq, y * freq, z * freq, &g) / freq;
+		*grad += g;
+		freq *= 2.0f;
+	}
+	return res;
+}
+
+
+/* ---- fractal noise with arbitrary octave parameters ----
+ * All octaves are evaluated first, 4 at a time in the 2D and 3D cases, and
+ * then combined by the different fractal functions. 4D noise has no SIMD path,
+ * so 4D octaves are evaluated one by one.
+ */
+#define MAX_OCTAVES	32
+
+FractalParams::FractalParams(float octaves, float lacunarity, float gain, float offset)
+{
+	this->octaves = octaves;
+	this->lacunarity = lacunarity;
+	this->gain = gain;
+	this->offset = offset;
+}
+
+/* calculates the frequency of each octave, returns the number of octaves, and
+ * the weight of the last (fractional) one. Unused entries of the frequency
+ * array, up to the next multiple of 4, are set to 0.
+ */
+static int octave_freq(const FractalParams &fp, float *freq, float *last_weight)
+{
+	*last_weight = 1.0f;
+	if(fp.octaves <= 0.0f) return 0;
+
+	int count = (int)fp.octaves;
+	*last_weight = fp.octaves - (float)count;
+	if(*last_weight > 0.0f) {
+		count++;
+	} else {
+		*last_weight = 1.0f;
+	}
+	if(count > MAX_OCTAVES) {
+		count = MAX_OCTAVES;
+		*last_weight = 1.0f;
+	}
+
+	float f = 1.0f;
+	for(int i=0; i<count; i++) {
+		freq[i] = f;
+		f *= fp.lacunarity;
+	}
+	for(int i=count; i & 3; i++) {
+		freq[i] = 0.0f;
+	}
+	return count;
+}
+
+static int octave_noise(const int *perm, const Vec2 *grad2, float x, float y,
+		const FractalParams &fp, float *res, float *last_weight)
+{
+	float freq[MAX_OCTAVES];
+	int count = octave_freq(fp, freq, last_weight);
+
+	for(int i=0; i<count; i+=4) {
+		float px[4], py[4];
+		for(int j=0; j<4; j++) {
+			px[j] = x * freq[i + j];
+			py[j] = y * freq[i + j];
+		}
+		Lattice4 lx, ly;
+		setup4(px, &lx);
+		setup4(py, &ly);
+		noise4(perm, grad2, lx, ly).store(res + i);
+	}
+	return count;
+}
+
+static int octave_noise(const int *perm, const Vec3 *grad3, float x, float y, float z,
+		const FractalParams &fp, float *res, float *last_weight)
+{
+	float freq[MAX_OCTAVES];
+	int count = octave_freq(fp, freq, last_weight);
+
+	for(int i=0; i<count; i+=4) {
+		float px[4], py[4], pz[4];
+		for(int j=0; j<4; j++) {
+			px[j] = x * freq[i + j];
+			py[j] = y * freq[i + j];
+			pz[j] = z * freq[i + j];
+		}
+		Lattice4 lx, ly, lz;
+		setup4(px, &lx);
+		setup4(py, &ly);
+		setup4(pz, &lz);
+		noise4(perm, grad3, lx, ly, lz).store(res + i);
+	}
+	return count;
+}
+
+static float sum_fbm(const float *val, int count, float last_weight, const FractalParams &fp)
+{
+	float res = 0.0f, amp = 1.0f;
+	for(int i=0; i<count; i++) {
+		float n = val[i] * amp;
+		res += i == count - 1 ? n * last_weight : n;
+		amp *= fp.gain;
+	}
+	return res;
+}
+
+static float sum_turbulence(const float *val, int count, float last_weight, const FractalParams &fp)
+{
+	float res = 0.0f, amp = 1.0f;
+	for(int i=0; i<count; i++) {
+		float n = fabs(val[i]) * amp;
+		res += i == count - 1 ? n * last_weight : n;
+		amp *= fp.gain;
+	}
+	return res;
+}
+
+/* Musgrave's ridged multifractal: inverted absolute noise, squared to sharpen
+ * the ridges, with each octave weighted by the previous one, so that detail
+ * accumulates on the ridges and the valleys stay smooth.
+ */
+static float sum_ridged(const float *val, int count, float last_weight, const FractalParams &fp)
+{
+	float res = 0.0f, amp = 1.0f, weight = 1.0f;
+	for(int i=0; i<count; i++) {
+		float signal = fp.offset - fabs(val[i]);
+		signal *= signal * weight;
+
+		weight = signal * 2.0f;
+		if(weight > 1.0f) weight = 1.0f;
+		if(weight < 0.0f) weight = 0.0f;
+
+		float n = signal * amp;
+		res += i == count - 1 ? n * last_weight : n;
+		amp *= fp.gain;
+	}
+	return res;
+}
+
+/* Musgrave's hybrid multifractal: octaves are weighted by the accumulated
+ * value of the previous ones, so low areas stay smooth and high areas get
+ * rough. The first octave has a weight of 1, and then sets the weight to its
+ * own value.
+ */
+static float sum_hybrid(const float *val, int count, float last_weight, const FractalParams &fp)
+{
+	float res = 0.0f, amp = 1.0f, weight = 1.0f;
+	for(int i=0; i<count; i++) {
+		if(weight > 1.0f) weight = 1.0f;
+
+		float signal = (val[i] + fp.offset) * amp;
+		res += weight * (i == count - 1 ? signal * last_weight : signal);
+		weight *= signal;
+		amp *= fp.gain;
+	}
+	return res;
+}
+
+float NoiseContext::fbm(float x, float y, const FractalParams &fp) const
+{
+	float val[MAX_OCTAVES], last_weight;
+	int count = octave_noise(perm, grad2, x, y, fp, val, &last_weight);
+	return sum_fbm(val, count, last_weight, fp);
+}
+
+float NoiseContext::fbm(float x, float y, float z, const FractalParams &fp) const
+{
+	float val[MAX_OCTAVES], last_weight;
+	int count = octave_noise(perm, grad3, x, y, z, fp, val, &last_weight);
+	return sum_fbm(val, count, last_weight, fp);
+}
+
+float NoiseContext::fbm(float x, float y, float z, float w, const FractalParams &fp) const
+{
+	float val[MAX_OCTAVES], freq[MAX_OCTAVES], last_weight;
+	int count = octave_freq(fp, freq, &last_weight);
+	for(int i=0; i<count; i++) {
+		val[i] = snoise(x * freq[i], y * freq[i], z * freq[i], w * freq[i]);
+	}
+	return sum_fbm(val, count, last_weight, fp);
+}
+
+float NoiseContext::turbulence(float x, float y, const FractalParams &fp) const
+{
+	float val[MAX_OCTAVES], last_weight;
+	int count = octave_noise(perm, grad2, x, y, fp, val, &last_weight);
+	return sum_turbulence(val, count, last_weight, fp);
+}
+
+float NoiseContext::turbulence(float x, float y, float z, const FractalParams &fp) const
+{
+	float val[MAX_OCTAVES], last_weight;
+	int count = octave_noise(perm, grad3, x, y, z, fp, val, &last_weight);
+	return sum_turbulence(val, count, last_weight, fp);
+}
+
+float NoiseContext::turbulence(float x, float y, float z, float w, const FractalParams &fp) const
+{
+	float val[MAX_OCTAVES], freq[MAX_OCTAVES], last_weight;
+	int count = octave_freq(fp, freq, &last_weight);
+	for(int i=0; i<count; i++) {
+		val[i] = snoise(x * freq[i], y * freq[i], z * freq[i], w * freq[i]);
+	}
+	return sum_turbulence(val, count, last_weight, fp);
+}
+
+float NoiseContext::ridged_mf(float x, float y, const FractalParams &fp) const
+{
+	float val[MAX_OCTAVES], last_weight;
+	int count = octave_noise(perm, grad2, x, y, fp, val, &last_weight);
+	return sum_ridged(val, count, last_weight, fp);
+}
+
+float NoiseContext::ridged_mf(float x, float y, float z, const FractalParams &fp) const
+{
+	float val[MAX_OCTAVES], last_weight;
+	int count = octave_noise(perm, grad3, x, y, z, fp, val, &last_weight);
+	return sum_ridged(val, count, last_weight, fp);
+}
+
+float NoiseContext::ridged_mf(float x, float y, float z, float w, const FractalParams &fp) const
+{
+	float val[MAX_OCTAVES], freq[MAX_OCTAVES], last_weight;
+	int count = octave_freq(fp, freq, &last_weight);
+	for(int i=0; i<count; i++) {
+		val[i] = snoise(x * freq[i], y * freq[i], z * freq[i], w * freq[i]);
+	}
+	return sum_ridged(val, count, last_weight, fp);
+}
+
+float NoiseContext::hybrid_mf(float x, float y, const FractalParams &fp) const
+{
+	float val[MAX_OCTAVES], last_weight;
+	int count = octave_noise(perm, grad2, x, y, fp, val, &last_weight);
+	return sum_hybrid(val, count, last_weight, fp);
+}
+
+float NoiseContext::hybrid_mf(float x, float y, float z, const FractalParams &fp) const
+{
+	float val[MAX_OCTAVES], last_weight;
+	int count = octave_noise(perm, grad3, x, y, z, fp, val, &last_weight);
+	return sum_hybrid(val, count, last_weight, fp);
+}
+
+float NoiseContext::hybrid_mf(float x, float y, float z, float w, const FractalParams &fp) const
+{
+	float val[MAX_OCTAVES], freq[MAX_OCTAVES], last_weight;
+	int count = octave_freq(fp, freq, &last_weight);
+	for(int i=0; i<count; i++) {
+		val[i] = snoise(x * freq[i], y * freq[i], z * freq[i], w * freq[i]);
+	}
+	return sum_hybrid(val, count, last_weight, fp);
+}
+
+
+/* ---- multithreaded noise baking ---- */
+#define CACHE_LINE		64
+#define ROWS_PER_TASK	4
+
+struct BakeJob {
+	const NoiseContext *ctx;
+	const NoiseBake *nb;
+	float *dest;
+	int xsz, ysz, zsz, pitch;
+	int per[3];
+	std::atomic<int> next_row;
+};
+
+NoiseBake::NoiseBake()
+{
+	func = BAKE_FBM;
+	origin = Vec3(0, 0, 0);
+	size = Vec3(1, 1, 1);
+	tileable = false;
+}
+
+int noise_bake_pitch(int xsz)
+{
+	int line = CACHE_LINE / sizeof(float);
+	return (xsz + line - 1) / line * line;
+}
+
+/* fractal noise built from periodic noise. Every octave frequency is an
+ * integer, so that all octaves repeat with the periods of the first.
+ */
+static float bake_pfractal(const BakeJob *job, float x, float y, float z)
+{
+	const NoiseBake *nb = job->nb;
+	const int *per = job->per;
+	float freq[MAX_OCTAVES], val[MAX_OCTAVES], last_weight;
+
+	int count = octave_freq(nb->fractal, freq, &last_weight);
+	for(int i=0; i<count; i++) {
+		int f = (int)(freq[i] + 0.5f);
+		if(job->zsz) {
+			val[i] = job->ctx->pnoise(x * f, y * f, z * f, per[0] * f, per[1] * f, per[2] * f);
+		} else {
+			val[i] = job->ctx->pnoise(x * f, y * f, per[0] * f, per[1] * f);
+		}
+	}
+
+	switch(nb->func) {
+	case BAKE_TURBULENCE:
+		return sum_turbulence(val, count, last_weight, nb->fractal);
+	case BAKE_RIDGED_MF:
+		return sum_ridged(val, count, last_weight, nb->fractal);
+	case BAKE_HYBRID_MF:
+		return sum_hybrid(val, count, last_weight, nb->fractal);
+	default:
+		break;
+	}
+	return sum_fbm(val, count, last_weight, nb->fractal);
+}
+
+static void bake_row(const BakeJob *job, float *dest, float y, float z)
+{
+	const NoiseContext *ctx = job->ctx;
+	const NoiseBake *nb = job->nb;
+	bool is3d = job->zsz > 0;
+	float xstep = nb->size.x / job->xsz;
+
+	if(nb->func == BAKE_NOISE && !nb->tileable) {
+		if(is3d) {
+			ctx->noise_grid(dest, job->xsz, 1, 1, Vec3(nb->origin.x, y, z), Vec3(xstep, 0, 0));
+		} else {
+			ctx->noise_grid(dest, job->xsz, 1, Vec2(nb->origin.x, y), Vec2(xstep, 0));
+		}
+		return;
+	}
+
+	for(int i=0; i<job->xsz; i++) {
+		float x = nb->origin.x + xstep * i;
+		float res;
+
+		if(nb->tileable) {
+			if(nb->func == BAKE_NOISE) {
+				res = is3d ? ctx->pnoise(x, y, z, job->per[0], job->per[1], job->per[2]) :
+					ctx->pnoise(x, y, job->per[0], job->per[1]);
+			} else {
+				res = bake_pfractal(job, x, y, z);
+			}
+		} else {
+			switch(nb->func) {
+			case BAKE_SNOISE:
+				res = is3d ? ctx->snoise(x, y, z) : ctx->snoise(x, y);
+				break;
+			case BAKE_TURBULENCE:
+				res = is3d ? ctx->turbulence(x, y, z, nb->fractal) : ctx->turbulence(x, y, nb->fractal);
+				break;
+			case BAKE_RIDGED_MF:
+				res = is3d ? ctx->ridged_mf(x, y, z, nb->fractal) : ctx->ridged_mf(x, y, nb->fractal);
+				break;
+			case BAKE_HYBRID_MF:
+				res = is3d ? ctx->hybrid_mf(x, y, z, nb->fractal) : ctx->hybrid_mf(x, y, nb->fractal);
+				break;
+			case BAKE_FBM:
+			default:
+				res = is3d ? ctx->fbm(x, y, z, nb->fractal) : ctx->fbm(x, y, nb->fractal);
+			}
+		}
+		dest[i] = res;
+	}
+}
+
+static void bake_thread(BakeJob *job)
+{
+	const NoiseBake *nb = job->nb;
+	int ysz = job->ysz;
+	int num_rows = ysz * (job->zsz > 0 ? job->zsz : 1);
+	float ystep = nb->size.y / ysz;
+	float zstep = job->zsz > 0 ? nb->size.z / job->zsz : 0.0f;
+
+	for(;;) {
+		int start = job->next_row.fetch_add(ROWS_PER_TASK);
+		if(start >= num_rows) break;
+
+		int end = start + ROWS_PER_TASK;
+		if(end > num_rows) end = num_rows;
+
+		for(int row=start; row<end; row++) {
+			float y = nb->origin.y + ystep * (row % ysz);
+			float z = nb->origin.z + zstep * (row / ysz);
+			bake_row(job, job->dest + (size_t)row * job->pitch, y, z);
+		}
+	}
+}
+
+static bool bake(const NoiseContext *ctx, float *dest, int xsz, int ysz, int zsz, int pitch,
+		const NoiseBake &nb, int num_threads)
+{
+	if(!dest || xsz <= 0 || ysz <= 0 || zsz < 0) return false;
+	if(nb.tileable && nb.func == BAKE_SNOISE) return false;
+
+	BakeJob job;
+	job.ctx = ctx;
+	job.nb = &nb;
+	job.dest = dest;
+	job.xsz = xsz;
+	job.ysz = ysz;
+	job.zsz = zsz;
+	job.pitch = pitch > 0 ? pitch : xsz;
+	job.next_row = 0;
+
+	if(nb.tileable) {
+		for(int i=0; i<3; i++) {
+			job.per[i] = (int)(nb.size[i] + 0.5f);
+			if(job.per[i] < 1) job.per[i] = 1;
+		}
+	}
+
+	if(num_threads <= 0) {
+		num_threads = std::thread::hardware_concurrency();
+		if(num_threads <= 0) num_threads = 1;
+	}
+
+	std::vector<std::thread> threads;
+	for(int i=1; i<num_threads; i++) {
+		threads.push_back(std::thread(bake_thread, &job));
+	}
+	bake_thread(&job);
+
+	for(size_t i=0; i<threads.size(); i++) {
+		threads[i].join();
+	}
+	return true;
+}
+
+bool NoiseContext::noise_bake(float *dest, int xsz, int ysz, int pitch, const NoiseBake &nb,
+		int num_threads) const
+{
+	return bake(this, dest, xsz, ysz, 0, pitch, nb, num_threads);
+}
+
+bool NoiseContext::noise_bake(float *dest, int xsz, int ysz, int zsz, int pitch, const NoiseBake &nb,
+		int num_threads) const
+{
+	if(zsz <= 0) return false;
+	return bake(this, dest, xsz, ysz, zsz, pitch, nb, num_threads);
+}
+
+
+/* ---- free functions, using the default noise context ----
+ * Function-local statics are initialized in a thread-safe manner, so the
+ * default context may be first used concurrently from multiple threads.
+ */
+static const NoiseContext &default_context()
+{
+	static const NoiseContext ctx;
+	return ctx;
+}
+
+float noise(float x)
+{
+	return default_context().noise(x);
+}
+
+float noise(float x, float y)
+{
+	return default_context().noise(x, y);
+}
+
+float noise(float x, float y, float z)
+{
+	return default_context().noise(x, y, z);
+}
+
+float noise(float x, float y, float z, float w)
+{
+	return default_context().noise(x, y, z, w);
+}
+
+
+float pnoise(float x, int period)
+{
+	return default_context().pnoise(x, period);
+}
+
+float pnoise(float x, float y, int per_x, int per_y)
+{
+	return default_context().pnoise(x, y, per_x, per_y);
+}
+
+float pnoise(float x, float y, float z, int per_x, int per_y, int per_z)
+{
+	return default_context().pnoise(x, y, z, per_x, per_y, per_z);
+}
+
+float pnoise(float x, float y, float z, float w, int per_x, int per_y, int per_z, int per_w)
+{
+	return default_context().pnoise(x, y, z, w, per_x, per_y, per_z, per_w);
+}
+
+
+float fbm(float x, int octaves)
+{
+	return default_context().fbm(x, octaves);
+}
+
+float fbm(float x, float y, int octaves)
+{
+	return default_context().fbm(x, y, octaves);
+}
+
+float fbm(float x, float y, float z, int octaves)
+{
+	return default_context().fbm(x, y, z, octaves);
+}
+
+float fbm(float x, float y, float z, float w, int octaves)
+{
+	return default_context().fbm(x, y, z, w, octaves);
+}
+
+
+float pfbm(float x, int per, int octaves)
+{
+	return default_context().pfbm(x, per, octaves);
+}
+
+float pfbm(float x, float y, int per_x, int per_y, int octaves)
+{
+	return default_context().pfbm(x, y, per_x, per_y, octaves);
+}
+
+float pfbm(float x, float y, float z, int per_x, int per_y, int per_z, int octaves)
+{
+	return default_context().pfbm(x, y, z, per_x, per_y, per_z, octaves);
+}
+
+float pfbm(float x, float y, float z, float w, int per_x, int per_y, int per_z, int per_w, int octaves)
+{
+	return default_context().pfbm(x, y, z, w, per_x, per_y, per_z, per_w, octaves);
+}
+
+
+float turbulence(float x, int octaves)
+{
+	return default_context().turbulence(x, octaves);
+}
+
+float turbulence(float x, float y, int octaves)
+{
+	return default_context().turbulence(x, y, octaves);
+}
+
+float turbulence(float x, float y, float z, int octaves)
+{
+	return default_context().turbulence(x, y, z, octaves);
+}
+
+float turbulence(float x, float y, float z, float w, int octaves)
+{
+	return default_context().turbulence(x, y, z, w, octaves);
+}
+
+
+float pturbulence(float x, int per, int octaves)
+{
+	return default_context().pturbulence(x, per, octaves);
+}
+
+float pturbulence(float x, float y, int per_x, int per_y, int octaves)
+{
+	return default_context().pturbulence(x, y, per_x, per_y, octaves);
+}
+
+float pturbulence(float x, float y, float z, int per_x, int per_y, int per_z, int octaves)
+{
+	return default_context().pturbulence(x, y, z, per_x, per_y, per_z, octaves);
+}
+
+float pturbulence(float x, float y, float z, float w, int per_x, int per_y, int per_z, int per_w, int octaves)
+{
+	return default_context().pturbulence(x, y, z, w, per_x, per_y, per_z, per_w, octaves);
+}
+
+
+float snoise(float x, float y)
+{
+	return default_context().snoise(x, y);
+}
+
+float snoise(float x, float y, float z)
+{
+	return default_context().snoise(x, y, z);
+}
+
+float snoise(float x, float y, float z, float w)
+{
+	return default_context().snoise(x, y, z, w);
+}
+
+
+float sfbm(float x, float y, int octaves)
+{
+	return default_context().sfbm(x, y, octaves);
+}
+
+float sfbm(float x, float y, float z, int octaves)
+{
+	return default_context().sfbm(x, y, z, octaves);
+}
+
+float sfbm(float x, float y, float z, float w, int octaves)
+{
+	return default_context().sfbm(x, y, z, w, octaves);
+}
+
+
+float sturbulence(float x, float y, int octaves)
+{
+	return default_context().sturbulence(x, y, octaves);
+}
+
+float sturbulence(float x, float y, float z, int octaves)
+{
+	return default_context().sturbulence(x, y, z, octaves);
+}
+
+float sturbulence(float x, float y, float z, float w, int octaves)
+{
+	return default_context().sturbulence(x, y, z, w, octaves);
+}
+
+
+void noise_batch(float *dest, const Vec2 *pos, int count)
+{
+	default_context().noise_batch(dest, pos, count);
+}
+
+void noise_batch(float *dest, const Vec3 *pos, int count)
+{
+	default_context().noise_batch(dest, pos, count);
+}
+
+
+void noise_grid(float *dest, int xsz, int ysz, const Vec2 &origin, const Vec2 &step)
+{
+	default_context().noise_grid(dest, xsz, ysz, origin, step);
+}
+
+void noise_grid(float *dest, int xsz, int ysz, int zsz, const Vec3 &origin, const Vec3 &step)
+{
+	default_context().noise_grid(dest, xsz, ysz, zsz, origin, step);
+}
+
+
+float fbm(float x, float y, const FractalParams &fp)
+{
+	return default_context().fbm(x, y, fp);
+}
+
+float fbm(float x, float y, float z, const FractalParams &fp)
+{
+	return default_context().fbm(x, y, z, fp);
+}
+
+float fbm(float x, float y, float z, float w, const FractalParams &fp)
+{
+	return default_context().fbm(x, y, z, w, fp);
+}
+
+float turbulence(float x, float y, const FractalParams &fp)
+{
+	return default_context().turbulence(x, y, fp);
+}
+
+float turbulence(float x, float y, float z, const FractalParams &fp)
+{
+	return default_context().turbulence(x, y, z, fp);
+}
+
+float turbulence(float x, float y, float z, float w, const FractalParams &fp)
+{
+	return default_context().turbulence(x, y, z, w, fp);
+}
+
+float ridged_mf(float x, float y, const FractalParams &fp)
+{
+	return default_context().ridged_mf(x, y, fp);
+}
+
+float ridged_mf(float x, float y, float z, const FractalParams &fp)
+{
+	return default_context().ridged_mf(x, y, z, fp);
+}
+
+float ridged_mf(float x, float y, float z, float w, const FractalParams &fp)
+{
+	return default_context().ridged_mf(x, y, z, w, fp);
+}
+
+float hybrid_mf(float x, float y, const FractalParams &fp)
+{
+	return default_context().hybrid_mf(x, y, fp);
+}
+
+float hybrid_mf(float x, float y, float z, const FractalParams &fp)
+{
+	return default_context().hybrid_mf(x, y, z, fp);
+}
+
+float hybrid_mf(float x, float y, float z, float w, const FractalParams &fp)
+{
+	return default_context().hybrid_mf(x, y, z, w, fp);
+}
+
+
+float noise_d(float x, float y, Vec2 *grad)
+{
+	return default_context().noise_d(x, y, grad);
+}
+
+float noise_d(float x, float y, float z, Vec3 *grad)
+{
+	return default_context().noise_d(x, y, z, grad);
+}
+
+float fbm_d(float x, float y, Vec2 *grad, int octaves)
+{
+	return default_context().fbm_d(x, y, grad, octaves);
+}
+
+float fbm_d(float x, float y, float z, Vec3 *grad, int octaves)
+{
+	return default_context().fbm_d(x, y, z, grad, octaves);
+}
+
+
+bool noise_bake(float *dest, int xsz, int ysz, int pitch, const NoiseBake &nb, int num_threads)
+{
+	return default_context().noise_bake(dest, xsz, ysz, pitch, nb, num_threads);
+}
+
+bool noise_bake(float *dest, int xsz, int ysz, int zsz, int pitch, const NoiseBake &nb, int num_threads)
+{
+	return default_context().noise_bake(dest, xsz, ysz, zsz, pitch, nb, num_threads);
+}
+
 }	// namespace gph
@@ -1,8 +1,191 @@
 #ifndef NOISE_H_
 #define NOISE_H_
 
+#include "vector.h"
+
 namespace gph {
 
+/* Parameters of the generalized fractal noise functions (fbm, turbulence,
+ * ridged_mf, and hybrid_mf taking a FractalParams).
+ * - octaves: number of noise octaves to add up. A fractional part adds a last
+ *   octave, scaled by it, to allow smooth transitions between octave counts.
+ * - lacunarity: frequency multiplier between successive octaves.
+ * - gain: amplitude multiplier between successive octaves.
+ * - offset: added to the noise in the ridged and hybrid multifractals.
+ *   Typically around 1 for ridged_mf, and 0.7 for hybrid_mf.
+ */
+struct GPH_MATH_API FractalParams {
+	float octaves;
+	float lacunarity;
+	float gain;
+	float offset;
+
+	explicit FractalParams(float octaves = 8.0f, float lacunarity = 2.0f, float gain = 0.5f, float offset = 1.0f);
+};
+
+/* noise function used by noise_bake */
+enum NoiseBakeFunc {
+	BAKE_NOISE,			// noise, or pnoise for tileable output
+	BAKE_SNOISE,		// snoise, can't be tileable
+	BAKE_FBM,
+	BAKE_TURBULENCE,
+	BAKE_RIDGED_MF,
+	BAKE_HYBRID_MF
+};
+
+/* Description of a noise image or volume for noise_bake. Sample i along each
+ * axis is taken at origin + size * i / num_samples, so the buffer covers the
+ * region from origin to origin + size in noise space.
+ *
+ * For tileable output, the periodic noise functions are used, with periods
+ * equal to size, which is rounded to integers. The periods should divide 256.
+ * The frequency of each octave (lacunarity^i) is also rounded to an integer,
+ * so that every octave repeats along with the first. With a non-integer
+ * lacunarity, successive octaves are then only approximately lacunarity
+ * apart.
+ */
+struct GPH_MATH_API NoiseBake {
+	NoiseBakeFunc func;
+	FractalParams fractal;	// used by the fractal functions
+	Vec3 origin;
+	Vec3 size;
+	bool tileable;
+
+	NoiseBake();
+};
+
+/* Noise generator state: permutation and gradient tables, generated from a
+ * seed. A NoiseContext is immutable after construction, so it can be shared
+ * between threads freely, and always produces the same noise for the same
+ * seed.
+ *
+ * The free noise functions below use a default context, constructed with
+ * seed 0 on first use.
+ */
+class GPH_MATH_API NoiseContext {
+private:
+	int perm[0x202];		// permuted indices, doubled to avoid wrapping
+	float grad1[0x202];		// 1D random slopes
+	Vec2 grad2[0x202];		// 2D random gradients
+	Vec3 grad3[0x202];		// 3D random gradients
+	Vec4 grad4[0x202];		// 4D random gradients
+
+public:
+	explicit NoiseContext(unsigned int seed = 0);
+
+	float noise(float x) const;
+	float noise(float x, float y) const;
+	float noise(float x, float y, float z) const;
+	float noise(float x, float y, float z, float w) const;
+
+	float pnoise(float x, int period) const;
+	float pnoise(float x, float y, int per_x, int per_y) const;
+	float pnoise(float x, float y, float z, int per_x, int per_y, int per_z) const;
+	float pnoise(float x, float y, float z, float w, int per_x, int per_y, int per_z, int per_w) const;
+
+	float fbm(float x, int octaves) const;
+	float fbm(float x, float y, int octaves) const;
+	float fbm(float x, float y, float z, int octaves) const;
+	float fbm(float x, float y, float z, float w, int octaves) const;
+
+	float pfbm(float x, int per, int octaves) const;
+	float pfbm(float x, float y, int per_x, int per_y, int octaves) const;
+	float pfbm(float x, float y, float z, int per_x, int per_y, int per_z, int octaves) const;
+	float pfbm(float x, float y, float z, float w, int per_x, int per_y, int per_z, int per_w, int octaves) const;
+
+	float turbulence(float x, int octaves) const;
+	float turbulence(float x, float y, int octaves) const;
+	float turbulence(float x, float y, float z, int octaves) const;
+	float turbulence(float x, float y, float z, float w, int octaves) const;
+
+	float pturbulence(float x, int per, int octaves) const;
+	float pturbulence(float x, float y, int per_x, int per_y, int octaves) const;
+	float pturbulence(float x, float y, float z, int per_x, int per_y, int per_z, int octaves) const;
+	float pturbulence(float x, float y, float z, float w, int per_x, int per_y, int per_z, int per_w, int octaves) const;
+
+	/* simplex noise. Cheaper than noise in higher dimensions, with fewer
+	 * directional artifacts, and in the range [-1, 1]
+	 */
+	float snoise(float x, float y) const;
+	float snoise(float x, float y, float z) const;
+	float snoise(float x, float y, float z, float w) const;
+
+	float sfbm(float x, float y, int octaves) const;
+	float sfbm(float x, float y, float z, int octaves) const;
+	float sfbm(float x, float y, float z, float w, int octaves) const;
+
+	float sturbulence(float x, float y, int octaves) const;
+	float sturbulence(float x, float y, float z, int octaves) const;
+	float sturbulence(float x, float y, float z, float w, int octaves) const;
+
+	/* noise and fbm, also returning their gradient through grad, which must
+	 * not be null. Much cheaper than finite differences.
+	 */
+	float noise_d(float x, float y, Vec2 *grad) const;
+	float noise_d(float x, float y, float z, Vec3 *grad) const;
+	float fbm_d(float x, float y, Vec2 *grad, int octaves) const;
+	float fbm_d(float x, float y, float z, Vec3 *grad, int octaves) const;
+
+	/* fractal noise with arbitrary octave count, lacunarity, and gain. All
+	 * octaves are evaluated in one pass, 4 at a time with SIMD in 2D and 3D.
+	 * Built on noise in 2D and 3D, and snoise in 4D.
+	 */
+	float fbm(float x, float y, const FractalParams &fp) const;
+	float fbm(float x, float y, float z, const FractalParams &fp) const;
+	float fbm(float x, float y, float z, float w, const FractalParams &fp) const;
+
+	float turbulence(float x, float y, const FractalParams &fp) const;
+	float turbulence(float x, float y, float z, const FractalParams &fp) const;
+	float turbulence(float x, float y, float z, float w, const FractalParams &fp) const;
+
+	float ridged_mf(float x, float y, const FractalParams &fp) const;
+	float ridged_mf(float x, float y, float z, const FractalParams &fp) const;
+	float ridged_mf(float x, float y, float z, float w, const FractalParams &fp) const;
+
+	float hybrid_mf(float x, float y, const FractalParams &fp) const;
+	float hybrid_mf(float x, float y, float z, const FractalParams &fp) const;
+	float hybrid_mf(float x, float y, float z, float w, const FractalParams &fp) const;
+
+	/* Batched noise evaluation. These produce the same values as calling
+	 * noise for each point, up to float rounding.
+	 *
+	 * noise_batch writes noise(pos[i]) to dest[i], for count points.
+	 * noise_grid fills dest with noise sampled at a regular grid of xsz by ysz
+	 * (by zsz) points, starting from origin with spacing step along each axis.
+	 * Samples are stored in x-major order: dest[(z * ysz + y) * xsz + x].
+	 *
+	 * Grids with at least 2 samples per lattice cell along x (step.x <= 0.5)
+	 * hash each lattice point only once per row, and are about 5-14 times
+	 * faster than calling noise. Sparser grids and arbitrary points evaluate 4
+	 * points at a time with SIMD, or 8 with gathers in AVX2 builds, which is
+	 * about 2-3 times faster for grids, but only 1-1.6 times for arbitrary
+	 * points, since the table lookups dominate.
+	 */
+	void noise_batch(float *dest, const Vec2 *pos, int count) const;
+	void noise_batch(float *dest, const Vec3 *pos, int count) const;
+
+	void noise_grid(float *dest, int xsz, int ysz, const Vec2 &origin, const Vec2 &step) const;
+	void noise_grid(float *dest, int xsz, int ysz, int zsz, const Vec3 &origin, const Vec3 &step) const;
+
+	/* Fill a 2D or 3D float buffer with noise, as described by nb, in
+	 * parallel. Rows are distributed dynamically among num_threads threads
+	 * (0 means as many as the hardware supports), including the calling
+	 * thread. pitch is the distance between rows in floats, or 0 for
+	 * tightly packed rows. Rows starting on cache line boundaries (see
+	 * noise_bake_pitch) are never shared between threads. In 3D, slices are
+	 * ysz rows apart.
+	 * Returns false for invalid arguments, or tileable simplex noise.
+	 */
+	bool noise_bake(float *dest, int xsz, int ysz, int pitch, const NoiseBake &nb,
+			int num_threads = 0) const;
+	bool noise_bake(float *dest, int xsz, int ysz, int zsz, int pitch, const NoiseBake &nb,
+			int num_threads = 0) const;
+};
+
+/* row pitch in floats, for rows of xsz floats starting on cache line boundaries */
+int noise_bake_pitch(int xsz);
+
+/* the same functions, using the default context */
 float noise(float x);
 float noise(float x, float y);
 float noise(float x, float y, float z);
@@ -33,6 +216,47 @@ float pturbulence(float x, float y, int per_x, int per_y, int octaves);
 float pturbulence(float x, float y, float z, int per_x, int per_y, int per_z, int octaves);
 float pturbulence(float x, float y, float z, float w, int per_x, int per_y, int per_z, int per_w, int octaves);
 
+float snoise(float x, float y);
+float snoise(float x, float y, float z);
+float snoise(float x, float y, float z, float w);
+
+float sfbm(float x, float y, int octaves);
+float sfbm(float x, float y, float z, int octaves);
+float sfbm(float x, float y, float z, float w, int octaves);
+
+float sturbulence(float x, float y, int octaves);
+float sturbulence(float x, float y, float z, int octaves);
+float sturbulence(float x, float y, float z, float w, int octaves);
+
+float noise_d(float x, float y, Vec2 *grad);
+float noise_d(float x, float y, float z, Vec3 *grad);
+float fbm_d(float x, float y, Vec2 *grad, int octaves);
+float fbm_d(float x, float y, float z, Vec3 *grad, int octaves);
+
+float fbm(float x, float y, const FractalParams &fp);
+float fbm(float x, float y, float z, const FractalParams &fp);
+float fbm(float x, float y, float z, float w, const FractalParams &fp);
+
+float turbulence(float x, float y, const FractalParams &fp);
+float turbulence(float x, float y, float z, const FractalParams &fp);
+float turbulence(float x, float y, float z, float w, const FractalParams &fp);
+
+float ridged_mf(float x, float y, const FractalParams &fp);
+float ridged_mf(float x, float y, float z, const FractalParams &fp);
+float ridged_mf(float x, float y, float z, float w, const FractalParams &fp);
+
+float hybrid_mf(float x, float y, const FractalParams &fp);
+float hybrid_mf(float x, float y, float z, const FractalParams &fp);
+float hybrid_mf(float x, float y, float z, float w, const FractalParams &fp);
+
+bool noise_bake(float *dest, int xsz, int ysz, int pitch, const NoiseBake &nb, int num_threads = 0);
+bool noise_bake(float *dest, int xsz, int ysz, int zsz, int pitch, const NoiseBake &nb, int num_threads = 0);
+
+void noise_batch(float *dest, const Vec2 *pos, int count);
+void noise_batch(float *dest, const Vec3 *pos, int count);
+
+void noise_grid(float *dest, int xsz, int ysz, const Vec2 &origin, const Vec2 &step);
+void noise_grid(float *dest, int xsz, int ysz, int zsz, const Vec3 &origin, const Vec3 &step);
 
 }	// namespace gph
 
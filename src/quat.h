@@ -21,11 +21,12 @@ class GPH_MATH_API Quat {
 public:
 	float x, y, z, w;	// w + xi + yj + zk
 
-	static Quat identity;
+	static const Quat identity;
 
-	Quat() : x(0), y(0), z(0), w(1) {}
-	Quat(float x_, float y_, float z_, float w_) : x(x_), y(y_), z(z_), w(w_) {}
-	Quat(const Vec3 &v, float s) : x(v.x), y(v.y), z(v.z), w(s) {}
+	constexpr Quat() : x(0), y(0), z(0), w(1) {}
+	constexpr Quat(float x_, float y_, float z_, float w_) : x(x_), y(y_), z(z_), w(w_) {}
+	constexpr Quat(const Vec3 &v, float s) : x(v.x), y(v.y), z(v.z), w(s) {}
+	explicit Quat(NoInit) {}
 
 	inline void normalize();
 	inline void conjugate();
@@ -39,25 +40,59 @@ public:
 	inline Mat4 calc_matrix() const;
 };
 
-inline GPH_MATH_API Quat operator -(const Quat &q);
-inline GPH_MATH_API Quat operator +(const Quat &a, const Quat &b);
-inline GPH_MATH_API Quat operator -(const Quat &a, const Quat &b);
-inline GPH_MATH_API Quat operator *(const Quat &a, const Quat &b);
+constexpr GPH_MATH_API Quat operator -(const Quat &q);
+constexpr GPH_MATH_API Quat operator +(const Quat &a, const Quat &b);
+constexpr GPH_MATH_API Quat operator -(const Quat &a, const Quat &b);
+constexpr GPH_MATH_API Quat operator *(const Quat &a, const Quat &b);
 
 inline GPH_MATH_API Quat &operator +=(Quat &a, const Quat &b);
 inline GPH_MATH_API Quat &operator -=(Quat &a, const Quat &b);
 inline GPH_MATH_API Quat &operator *=(Quat &a, const Quat &b);
 
 inline GPH_MATH_API float length(const Quat &q);
-inline GPH_MATH_API float length_sq(const Quat &q);
+constexpr GPH_MATH_API float length_sq(const Quat &q);
+constexpr GPH_MATH_API float dot(const Quat &a, const Quat &b);
 
 inline GPH_MATH_API Quat normalize(const Quat &q);
-inline GPH_MATH_API Quat conjugate(const Quat &q);
+constexpr GPH_MATH_API Quat conjugate(const Quat &q);
 inline GPH_MATH_API Quat inverse(const Quat &q);
 
 Quat GPH_MATH_API slerp(const Quat &a, const Quat &b, float t);
 inline GPH_MATH_API Quat lerp(const Quat &a, const Quat &b, float t);
 
+/* cheaper alternatives to slerp, for unit quaternions, both interpolating
+ * across the shortest arc:
+ * - slerp_approx: polynomial approximation of slerp, without trigonometric
+ *   functions or divisions. The error in each component stays below 3e-5.
+ * - nlerp: normalized linear interpolation. Follows the same path as slerp,
+ *   but not at constant angular velocity; the error in the angle is about 1
+ *   degree for rotations 90 degrees apart, and falls off quickly for closer
+ *   ones, which is fine for blending between nearby animation keyframes.
+ */
+inline GPH_MATH_API Quat slerp_approx(const Quat &a, const Quat &b, float t);
+inline GPH_MATH_API Quat nlerp(const Quat &a, const Quat &b, float t);
+
+/* batch interpolation of arrays of quaternion pairs, equivalent to
+ * dest[i] = slerp_approx(a[i], b[i], t[i]) (or nlerp) for each one of them,
+ * 4 at a time with SIMD. dest may be the same buffer as a or b.
+ */
+GPH_MATH_API void slerp_approx(Quat *dest, const Quat *a, const Quat *b, const float *t, int count);
+GPH_MATH_API void nlerp(Quat *dest, const Quat *a, const Quat *b, const float *t, int count);
+
+/* rotate v by the unit quaternion q, as v + 2w (q x v) + 2q x (q x v), where q
+ * stands for the vector part. Cheaper than rotate(v, q) from vector.h, which
+ * also works for quaternions that are not normalized.
+ */
+inline GPH_MATH_API Vec3 rotate_unit(const Vec3 &v, const Quat &q);
+
+/* batch rotation of arrays of vectors by the unit quaternion q, equivalent to
+ * dest[i] = rotate_unit(src[i], q) for each one of them. Strides and overlap
+ * work the same as for transform_vectors.
+ */
+GPH_MATH_API void rotate_vectors(Vec3 *dest, const Vec3 *src, int count, const Quat &q);
+GPH_MATH_API void rotate_vectors(float *dest, int dest_stride, const float *src, int src_stride,
+		int count, const Quat &q);
+
 #include "quat.inl"
 
 }	// namespace gph
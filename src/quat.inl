@@ -7,29 +7,30 @@ it under the terms of the MIT/X11 license. See LICENSE for details.
 If you intend to redistribute parts of the code without the LICENSE file
 replace this paragraph with the full contents of the LICENSE file.
 */
-inline Quat operator -(const Quat &q)
+constexpr Quat operator -(const Quat &q)
 {
 	return Quat(-q.x, -q.y, -q.z, -q.w);
 }
 
-inline Quat operator +(const Quat &a, const Quat &b)
+constexpr Quat operator +(const Quat &a, const Quat &b)
 {
 	return Quat(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
 }
 
-inline Quat operator -(const Quat &a, const Quat &b)
+constexpr Quat operator -(const Quat &a, const Quat &b)
 {
 	return Quat(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w);
 }
 
-inline Quat operator *(const Quat &a, const Quat &b)
+/* w = a.w * b.w - dot(a.xyz, b.xyz)
+ * xyz = a.w * b.xyz + b.w * a.xyz + cross(a.xyz, b.xyz)
+ */
+constexpr Quat operator *(const Quat &a, const Quat &b)
 {
-	Vec3 a_im = Vec3(a.x, a.y, a.z);
-	Vec3 b_im = Vec3(b.x, b.y, b.z);
-
-	float w = a.w * b.w - dot(a_im, b_im);
-	Vec3 im = a.w * b_im + b.w * a_im + cross(a_im, b_im);
-	return Quat(im.x, im.y, im.z, w);
+	return Quat(a.w * b.x + b.w * a.x + a.y * b.z - a.z * b.y,
+			a.w * b.y + b.w * a.y + a.z * b.x - a.x * b.z,
+			a.w * b.z + b.w * a.z + a.x * b.y - a.y * b.x,
+			a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z);
 }
 
 inline Quat &operator +=(Quat &a, const Quat &b)
@@ -66,11 +67,16 @@ inline float length(const Quat &q)
 	return (float)sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
 }
 
-inline float length_sq(const Quat &q)
+constexpr float length_sq(const Quat &q)
 {
 	return q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w;
 }
 
+constexpr float dot(const Quat &a, const Quat &b)
+{
+	return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
 inline void Quat::normalize()
 {
 	float len = length(*this);
@@ -98,7 +104,7 @@ inline void Quat::conjugate()
 	z = -z;
 }
 
-inline Quat conjugate(const Quat &q)
+constexpr Quat conjugate(const Quat &q)
 {
 	return Quat(-q.x, -q.y, -q.z, q.w);
 }
@@ -137,7 +143,7 @@ inline void Quat::set_rotation(const Vec3 &axis, float angle)
 
 inline void Quat::rotate(const Vec3 &axis, float angle)
 {
-	Quat q;
+	Quat q(noinit);
 	float half_angle = angle * 0.5f;
 	q.w = cos(half_angle);
 	float sin_ha = sin(half_angle);
@@ -180,24 +186,17 @@ inline Quat slerp(const Quat &quat1, const Quat &q2, float t)
 		dot = -dot;
 	}
 
-	/* clamp dot to [-1, 1] in order to avoid domain errors in acos due to
-	 * floating point imprecisions
+	/* for nearly identical rotations sin(angle) is tiny, and dividing by it
+	 * loses all precision, while nlerp is practically exact
 	 */
-	if(dot < -1.0) dot = -1.0;
-	if(dot > 1.0) dot = 1.0;
+	if(dot > 0.9995f) {
+		return nlerp(q1, q2, t);
+	}
 
 	float angle = acos(dot);
-	float a, b;
-
-	float sin_angle = sin(angle);
-	if(sin_angle == 0.0f) {
-		// use linear interpolation to avoid div/zero
-		a = 1.0f - t;
-		b = t;
-	} else {
-		a = sin((1.0f - t) * angle) / sin_angle;
-		b = sin(t * angle) / sin_angle;
-	}
+	float inv_sin = 1.0f / sin(angle);
+	float a = sin((1.0f - t) * angle) * inv_sin;
+	float b = sin(t * angle) * inv_sin;
 
 	float x = q1.x * a + q2.x * b;
 	float y = q1.y * a + q2.y * b;
@@ -207,7 +206,67 @@ inline Quat slerp(const Quat &quat1, const Quat &q2, float t)
 	return Quat(x, y, z, w);
 }
 
+/* Eberly, "A fast and accurate algorithm for computing SLERP". The slerp
+ * weights sin(t angle) / sin(angle) are expanded as a series in (dot - 1),
+ * truncated to 8 terms, with the last term scaled by 1 + mu to minimize the
+ * maximum error.
+ */
+inline Quat slerp_approx(const Quat &q1, const Quat &q2, float t)
+{
+	static const float one_plus_mu = 1.85298109240830f;
+	const float u[] = {
+		1.0f / (1 * 3), 1.0f / (2 * 5), 1.0f / (3 * 7), 1.0f / (4 * 9),
+		1.0f / (5 * 11), 1.0f / (6 * 13), 1.0f / (7 * 15), one_plus_mu / (8 * 17)
+	};
+	const float v[] = {
+		1.0f / 3, 2.0f / 5, 3.0f / 7, 4.0f / 9,
+		5.0f / 11, 6.0f / 13, 7.0f / 15, one_plus_mu * 8 / 17
+	};
+
+	float dot = q1.w * q2.w + q1.x * q2.x + q1.y * q2.y + q1.z * q2.z;
+	float sign = 1.0f;
+	if(dot < 0.0f) {
+		dot = -dot;
+		sign = -1.0f;
+	}
+
+	float xm1 = dot - 1.0f;
+	float d = 1.0f - t;
+	float sqt = t * t;
+	float sqd = d * d;
+
+	float ft = 1.0f, fd = 1.0f;
+	for(int i=7; i>=0; i--) {
+		ft = 1.0f + (u[i] * sqt - v[i]) * xm1 * ft;
+		fd = 1.0f + (u[i] * sqd - v[i]) * xm1 * fd;
+	}
+	float a = d * fd;
+	float b = sign * t * ft;
+
+	return Quat(q1.x * a + q2.x * b, q1.y * a + q2.y * b, q1.z * a + q2.z * b,
+			q1.w * a + q2.w * b);
+}
+
+inline Quat nlerp(const Quat &q1, const Quat &q2, float t)
+{
+	float dot = q1.w * q2.w + q1.x * q2.x + q1.y * q2.y + q1.z * q2.z;
+	float b = dot < 0.0f ? -t : t;
+	float a = 1.0f - t;
+
+	Quat res = Quat(q1.x * a + q2.x * b, q1.y * a + q2.y * b, q1.z * a + q2.z * b,
+			q1.w * a + q2.w * b);
+	res.normalize();
+	return res;
+}
+
 inline Quat lerp(const Quat &a, const Quat &b, float t)
 {
 	return slerp(a, b, t);
 }
+
+inline Vec3 rotate_unit(const Vec3 &v, const Quat &q)
+{
+	Vec3 u = Vec3(q.x, q.y, q.z);
+	Vec3 t = cross(u, v) * 2.0f;
+	return v + t * q.w + cross(u, t);
+}
@@ -0,0 +1,216 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+inline Quatx4::Quatx4(const Quat &q)
+	: x(q.x), y(q.y), z(q.z), w(q.w)
+{
+}
+
+/* Quat has the same layout as 4 floats, so the array conversions can load
+ * (or store) whole quaternions and transpose them in registers
+ */
+#if defined(GPH_SIMD_SSE)
+inline Quatx4::Quatx4(const Quat *arr)
+{
+	__m128 q0 = _mm_loadu_ps(&arr[0].x);
+	__m128 q1 = _mm_loadu_ps(&arr[1].x);
+	__m128 q2 = _mm_loadu_ps(&arr[2].x);
+	__m128 q3 = _mm_loadu_ps(&arr[3].x);
+	_MM_TRANSPOSE4_PS(q0, q1, q2, q3);
+	x = Float4(q0);
+	y = Float4(q1);
+	z = Float4(q2);
+	w = Float4(q3);
+}
+
+inline void Quatx4::store(Quat *arr) const
+{
+	__m128 q0 = x.v, q1 = y.v, q2 = z.v, q3 = w.v;
+	_MM_TRANSPOSE4_PS(q0, q1, q2, q3);
+	_mm_storeu_ps(&arr[0].x, q0);
+	_mm_storeu_ps(&arr[1].x, q1);
+	_mm_storeu_ps(&arr[2].x, q2);
+	_mm_storeu_ps(&arr[3].x, q3);
+}
+
+#elif defined(GPH_SIMD_NEON)
+inline Quatx4::Quatx4(const Quat *arr)
+{
+	float32x4x4_t q = vld4q_f32(&arr->x);
+	x = Float4(q.val[0]);
+	y = Float4(q.val[1]);
+	z = Float4(q.val[2]);
+	w = Float4(q.val[3]);
+}
+
+inline void Quatx4::store(Quat *arr) const
+{
+	float32x4x4_t q;
+	q.val[0] = x.v;
+	q.val[1] = y.v;
+	q.val[2] = z.v;
+	q.val[3] = w.v;
+	vst4q_f32(&arr->x, q);
+}
+
+#else
+inline Quatx4::Quatx4(const Quat *arr)
+	: x(arr[0].x, arr[1].x, arr[2].x, arr[3].x),
+	y(arr[0].y, arr[1].y, arr[2].y, arr[3].y),
+	z(arr[0].z, arr[1].z, arr[2].z, arr[3].z),
+	w(arr[0].w, arr[1].w, arr[2].w, arr[3].w)
+{
+}
+
+inline void Quatx4::store(Quat *arr) const
+{
+	float tx[4], ty[4], tz[4], tw[4];
+	x.store(tx);
+	y.store(ty);
+	z.store(tz);
+	w.store(tw);
+	for(int i=0; i<4; i++) {
+		arr[i] = Quat(tx[i], ty[i], tz[i], tw[i]);
+	}
+}
+#endif
+
+inline Quat Quatx4::operator [](int idx) const
+{
+	return Quat(x[idx], y[idx], z[idx], w[idx]);
+}
+
+inline Quatx4 operator -(const Quatx4 &q)
+{
+	return Quatx4(-q.x, -q.y, -q.z, -q.w);
+}
+
+inline Quatx4 operator +(const Quatx4 &a, const Quatx4 &b)
+{
+	return Quatx4(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
+}
+
+inline Quatx4 operator -(const Quatx4 &a, const Quatx4 &b)
+{
+	return Quatx4(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w);
+}
+
+inline Quatx4 operator *(const Quatx4 &a, const Quatx4 &b)
+{
+	Vec3x4 a_im = Vec3x4(a.x, a.y, a.z);
+	Vec3x4 b_im = Vec3x4(b.x, b.y, b.z);
+
+	Float4 w = a.w * b.w - dot(a_im, b_im);
+	Vec3x4 im = a.w * b_im + b.w * a_im + cross(a_im, b_im);
+	return Quatx4(im.x, im.y, im.z, w);
+}
+
+inline Quatx4 &operator +=(Quatx4 &a, const Quatx4 &b)
+{
+	a.x += b.x;
+	a.y += b.y;
+	a.z += b.z;
+	a.w += b.w;
+	return a;
+}
+
+inline Quatx4 &operator -=(Quatx4 &a, const Quatx4 &b)
+{
+	a.x -= b.x;
+	a.y -= b.y;
+	a.z -= b.z;
+	a.w -= b.w;
+	return a;
+}
+
+inline Quatx4 &operator *=(Quatx4 &a, const Quatx4 &b)
+{
+	a = a * b;
+	return a;
+}
+
+inline Quatx4 select(const Float4 &mask, const Quatx4 &a, const Quatx4 &b)
+{
+	return Quatx4(select(mask, a.x, b.x), select(mask, a.y, b.y),
+			select(mask, a.z, b.z), select(mask, a.w, b.w));
+}
+
+inline Float4 length(const Quatx4 &q)
+{
+	return vsqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+}
+
+inline Float4 length_sq(const Quatx4 &q)
+{
+	return q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w;
+}
+
+inline Quatx4 normalize(const Quatx4 &q)
+{
+	Float4 len = length(q);
+	len = select(len != Float4(0.0f), len, Float4(1.0f));
+	return Quatx4(q.x / len, q.y / len, q.z / len, q.w / len);
+}
+
+inline Quatx4 conjugate(const Quatx4 &q)
+{
+	return Quatx4(-q.x, -q.y, -q.z, q.w);
+}
+
+inline Quatx4 slerp_approx(const Quatx4 &q1, const Quatx4 &q2, const Float4 &t)
+{
+	// same coefficients as the scalar slerp_approx in quat.inl
+	static const float one_plus_mu = 1.85298109240830f;
+	const float u[] = {
+		1.0f / (1 * 3), 1.0f / (2 * 5), 1.0f / (3 * 7), 1.0f / (4 * 9),
+		1.0f / (5 * 11), 1.0f / (6 * 13), 1.0f / (7 * 15), one_plus_mu / (8 * 17)
+	};
+	const float v[] = {
+		1.0f / 3, 2.0f / 5, 3.0f / 7, 4.0f / 9,
+		5.0f / 11, 6.0f / 13, 7.0f / 15, one_plus_mu * 8 / 17
+	};
+
+	Float4 dot = q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+	Float4 sign = select(dot < Float4(0.0f), Float4(-1.0f), Float4(1.0f));
+
+	Float4 xm1 = vabs(dot) - Float4(1.0f);
+	Float4 d = Float4(1.0f) - t;
+	Float4 sqt = t * t;
+	Float4 sqd = d * d;
+
+	Float4 ft = Float4(1.0f), fd = Float4(1.0f);
+	for(int i=7; i>=0; i--) {
+		Float4 ui = Float4(u[i]);
+		Float4 vi = Float4(v[i]);
+		ft = Float4(1.0f) + (ui * sqt - vi) * xm1 * ft;
+		fd = Float4(1.0f) + (ui * sqd - vi) * xm1 * fd;
+	}
+	Float4 a = d * fd;
+	Float4 b = sign * t * ft;
+
+	return Quatx4(q1.x * a + q2.x * b, q1.y * a + q2.y * b, q1.z * a + q2.z * b,
+			q1.w * a + q2.w * b);
+}
+
+inline Quatx4 nlerp(const Quatx4 &q1, const Quatx4 &q2, const Float4 &t)
+{
+	Float4 dot = q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+	Float4 b = select(dot < Float4(0.0f), -t, t);
+	Float4 a = Float4(1.0f) - t;
+
+	return normalize(Quatx4(q1.x * a + q2.x * b, q1.y * a + q2.y * b,
+				q1.z * a + q2.z * b, q1.w * a + q2.w * b));
+}
+
+inline Vec3x4 rotate_unit(const Vec3x4 &v, const Quatx4 &q)
+{
+	Vec3x4 u = Vec3x4(q.x, q.y, q.z);
+	Vec3x4 t = cross(u, v) * Float4(2.0f);
+	return v + t * q.w + cross(u, t);
+}
@@ -0,0 +1,346 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#include <atomic>
+#include "random.h"
+#include "sampling.h"
+
+#if defined(GPH_SIMD_SSE) && (defined(__SSE2__) || defined(_M_X64))
+#define RNG4_SSE2
+#include <emmintrin.h>
+#endif
+
+/* number of uniform random numbers generated at once by the array samplers */
+#define SAMPLE_BLOCK	256
+
+namespace gph {
+
+// ---- Rng ----
+
+Rng::Rng(uint64_t seed, uint64_t stream)
+{
+	this->seed(seed, stream);
+}
+
+void Rng::seed(uint64_t seed, uint64_t stream)
+{
+	state = 0;
+	inc = (stream << 1) | 1;
+	next();
+	state += seed;
+	next();
+}
+
+Rng &thread_rng()
+{
+	static std::atomic<unsigned int> num_streams;
+	thread_local Rng rng(0, num_streams++);
+	return rng;
+}
+
+// ---- Rng4 ----
+
+/* splitmix64, to expand a single seed into the state of all lanes */
+static uint64_t splitmix64(uint64_t *x)
+{
+	uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+Rng4::Rng4(uint64_t seed)
+{
+	this->seed(seed);
+}
+
+void Rng4::seed(uint64_t seed)
+{
+	for(int i=0; i<4; i++) {
+		for(int j=0; j<4; j+=2) {
+			uint64_t r = splitmix64(&seed);
+			s[j][i] = (uint32_t)r;
+			s[j + 1][i] = (uint32_t)(r >> 32);
+		}
+	}
+}
+
+#if defined(RNG4_SSE2)
+struct RngState4 {
+	__m128i s0, s1, s2, s3;
+};
+
+static inline void load_state(RngState4 *st, uint32_t (*s)[4])
+{
+	st->s0 = _mm_loadu_si128((const __m128i*)s[0]);
+	st->s1 = _mm_loadu_si128((const __m128i*)s[1]);
+	st->s2 = _mm_loadu_si128((const __m128i*)s[2]);
+	st->s3 = _mm_loadu_si128((const __m128i*)s[3]);
+}
+
+static inline void store_state(uint32_t (*s)[4], const RngState4 *st)
+{
+	_mm_storeu_si128((__m128i*)s[0], st->s0);
+	_mm_storeu_si128((__m128i*)s[1], st->s1);
+	_mm_storeu_si128((__m128i*)s[2], st->s2);
+	_mm_storeu_si128((__m128i*)s[3], st->s3);
+}
+
+// one xoshiro128+ step for all lanes
+static inline __m128i step(RngState4 *st)
+{
+	__m128i res = _mm_add_epi32(st->s0, st->s3);
+	__m128i t = _mm_slli_epi32(st->s1, 9);
+
+	st->s2 = _mm_xor_si128(st->s2, st->s0);
+	st->s3 = _mm_xor_si128(st->s3, st->s1);
+	st->s1 = _mm_xor_si128(st->s1, st->s2);
+	st->s0 = _mm_xor_si128(st->s0, st->s3);
+	st->s2 = _mm_xor_si128(st->s2, t);
+	st->s3 = _mm_or_si128(_mm_slli_epi32(st->s3, 11), _mm_srli_epi32(st->s3, 21));
+	return res;
+}
+
+static inline Float4 to_float(__m128i x)
+{
+	__m128 f = _mm_cvtepi32_ps(_mm_srli_epi32(x, 8));
+	return Float4(_mm_mul_ps(f, _mm_set1_ps(1.0f / 16777216.0f)));
+}
+
+static inline void store_uint(uint32_t *res, __m128i x)
+{
+	_mm_storeu_si128((__m128i*)res, x);
+}
+
+#elif defined(GPH_SIMD_NEON)
+struct RngState4 {
+	uint32x4_t s0, s1, s2, s3;
+};
+
+static inline void load_state(RngState4 *st, uint32_t (*s)[4])
+{
+	st->s0 = vld1q_u32(s[0]);
+	st->s1 = vld1q_u32(s[1]);
+	st->s2 = vld1q_u32(s[2]);
+	st->s3 = vld1q_u32(s[3]);
+}
+
+static inline void store_state(uint32_t (*s)[4], const RngState4 *st)
+{
+	vst1q_u32(s[0], st->s0);
+	vst1q_u32(s[1], st->s1);
+	vst1q_u32(s[2], st->s2);
+	vst1q_u32(s[3], st->s3);
+}
+
+static inline uint32x4_t step(RngState4 *st)
+{
+	uint32x4_t res = vaddq_u32(st->s0, st->s3);
+	uint32x4_t t = vshlq_n_u32(st->s1, 9);
+
+	st->s2 = veorq_u32(st->s2, st->s0);
+	st->s3 = veorq_u32(st->s3, st->s1);
+	st->s1 = veorq_u32(st->s1, st->s2);
+	st->s0 = veorq_u32(st->s0, st->s3);
+	st->s2 = veorq_u32(st->s2, t);
+	st->s3 = vorrq_u32(vshlq_n_u32(st->s3, 11), vshrq_n_u32(st->s3, 21));
+	return res;
+}
+
+static inline Float4 to_float(uint32x4_t x)
+{
+	float32x4_t f = vcvtq_f32_u32(vshrq_n_u32(x, 8));
+	return Float4(vmulq_n_f32(f, 1.0f / 16777216.0f));
+}
+
+static inline void store_uint(uint32_t *res, uint32x4_t x)
+{
+	vst1q_u32(res, x);
+}
+
+#else
+struct RngState4 {
+	uint32_t s[4][4];
+};
+
+struct Uint4 {
+	uint32_t v[4];
+};
+
+static inline void load_state(RngState4 *st, uint32_t (*s)[4])
+{
+	for(int i=0; i<4; i++) {
+		for(int j=0; j<4; j++) {
+			st->s[i][j] = s[i][j];
+		}
+	}
+}
+
+static inline void store_state(uint32_t (*s)[4], const RngState4 *st)
+{
+	for(int i=0; i<4; i++) {
+		for(int j=0; j<4; j++) {
+			s[i][j] = st->s[i][j];
+		}
+	}
+}
+
+static inline Uint4 step(RngState4 *st)
+{
+	uint32_t (*s)[4] = st->s;
+	Uint4 res;
+	for(int i=0; i<4; i++) {
+		res.v[i] = s[0][i] + s[3][i];
+		uint32_t t = s[1][i] << 9;
+
+		s[2][i] ^= s[0][i];
+		s[3][i] ^= s[1][i];
+		s[1][i] ^= s[2][i];
+		s[0][i] ^= s[3][i];
+		s[2][i] ^= t;
+		s[3][i] = (s[3][i] << 11) | (s[3][i] >> 21);
+	}
+	return res;
+}
+
+static inline Float4 to_float(const Uint4 &x)
+{
+	const float scale = 1.0f / 16777216.0f;
+	return Float4((float)(x.v[0] >> 8) * scale, (float)(x.v[1] >> 8) * scale,
+			(float)(x.v[2] >> 8) * scale, (float)(x.v[3] >> 8) * scale);
+}
+
+static inline void store_uint(uint32_t *res, const Uint4 &x)
+{
+	for(int i=0; i<4; i++) {
+		res[i] = x.v[i];
+	}
+}
+#endif
+
+void Rng4::next(uint32_t *res)
+{
+	RngState4 st;
+	load_state(&st, s);
+	store_uint(res, step(&st));
+	store_state(s, &st);
+}
+
+Float4 Rng4::next_float()
+{
+	RngState4 st;
+	load_state(&st, s);
+	Float4 res = to_float(step(&st));
+	store_state(s, &st);
+	return res;
+}
+
+void Rng4::fill(float *dest, int count)
+{
+	RngState4 st;
+	load_state(&st, s);
+
+	while(count >= 4) {
+		to_float(step(&st)).store(dest);
+		dest += 4;
+		count -= 4;
+	}
+	if(count > 0) {
+		float tmp[4];
+		to_float(step(&st)).store(tmp);
+		for(int i=0; i<count; i++) {
+			dest[i] = tmp[i];
+		}
+	}
+
+	store_state(s, &st);
+}
+
+// ---- sampling ----
+
+Vec2 discrand(Rng &rng, float rad)
+{
+	float u = rng.next_float();
+	return warp_disc(Vec2(u, rng.next_float())) * rad;
+}
+
+Vec3 sphrand(Rng &rng, float rad)
+{
+	float u = rng.next_float();
+	return warp_sphere(Vec2(u, rng.next_float())) * rad;
+}
+
+Vec3 hemirand(Rng &rng, const Vec3 &n)
+{
+	float u = rng.next_float();
+	return warp_hemisphere(Vec2(u, rng.next_float()), n);
+}
+
+Vec3 cosrand(Rng &rng, const Vec3 &n)
+{
+	float u = rng.next_float();
+	return warp_cos_hemisphere(Vec2(u, rng.next_float()), n);
+}
+
+/* the array versions generate uniform numbers in blocks, which are then
+ * warped two at a time
+ */
+void discrand(Rng4 &rng, Vec2 *dest, int count, float rad)
+{
+	float uv[SAMPLE_BLOCK];
+	while(count > 0) {
+		int num = count < SAMPLE_BLOCK / 2 ? count : SAMPLE_BLOCK / 2;
+		rng.fill(uv, num * 2);
+		for(int i=0; i<num; i++) {
+			*dest++ = warp_disc(Vec2(uv[i * 2], uv[i * 2 + 1])) * rad;
+		}
+		count -= num;
+	}
+}
+
+void sphrand(Rng4 &rng, Vec3 *dest, int count, float rad)
+{
+	float uv[SAMPLE_BLOCK];
+	while(count > 0) {
+		int num = count < SAMPLE_BLOCK / 2 ? count : SAMPLE_BLOCK / 2;
+		rng.fill(uv, num * 2);
+		for(int i=0; i<num; i++) {
+			*dest++ = warp_sphere(Vec2(uv[i * 2], uv[i * 2 + 1])) * rad;
+		}
+		count -= num;
+	}
+}
+
+void hemirand(Rng4 &rng, Vec3 *dest, int count, const Vec3 &n)
+{
+	float uv[SAMPLE_BLOCK];
+	while(count > 0) {
+		int num = count < SAMPLE_BLOCK / 2 ? count : SAMPLE_BLOCK / 2;
+		rng.fill(uv, num * 2);
+		for(int i=0; i<num; i++) {
+			*dest++ = warp_hemisphere(Vec2(uv[i * 2], uv[i * 2 + 1]), n);
+		}
+		count -= num;
+	}
+}
+
+void cosrand(Rng4 &rng, Vec3 *dest, int count, const Vec3 &n)
+{
+	float uv[SAMPLE_BLOCK];
+	while(count > 0) {
+		int num = count < SAMPLE_BLOCK / 2 ? count : SAMPLE_BLOCK / 2;
+		rng.fill(uv, num * 2);
+		for(int i=0; i<num; i++) {
+			*dest++ = warp_cos_hemisphere(Vec2(uv[i * 2], uv[i * 2 + 1]), n);
+		}
+		count -= num;
+	}
+}
+
+}	// namespace gph
@@ -0,0 +1,94 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#ifndef GMATH_RANDOM_H_
+#define GMATH_RANDOM_H_
+
+#include "config.h"
+
+#include <stdint.h>
+#include "vector.h"
+#include "wide.h"
+
+/* Pseudo-random number generators and random sampling.
+ *
+ * Generators carry their own state, and are not synchronized; each thread
+ * should use its own generator, either created explicitly, or the one returned
+ * by thread_rng. Generators with the same seed always produce the same
+ * sequence.
+ *
+ * Rng is a PCG32 generator (O'Neill, "PCG: A family of simple fast
+ * space-efficient statistically good algorithms for random number generation"),
+ * producing one number at a time.
+ *
+ * Rng4 runs 4 independent xoshiro128+ generators side by side, producing 4
+ * numbers at a time with SIMD. Use it to fill large arrays of samples.
+ */
+
+namespace gph {
+
+class GPH_MATH_API Rng {
+private:
+	uint64_t state, inc;
+
+public:
+	/* generators with different streams produce different sequences, even
+	 * with the same seed
+	 */
+	explicit Rng(uint64_t seed = 0, uint64_t stream = 0);
+	void seed(uint64_t seed, uint64_t stream = 0);
+
+	inline uint32_t next();
+	inline float next_float();		// uniform in [0, 1)
+	inline int next_int(int n);		// uniform in [0, n)
+};
+
+class GPH_MATH_API Rng4 {
+private:
+	uint32_t s[4][4];	// 4 state words for each of the 4 lanes, s[word][lane]
+
+public:
+	explicit Rng4(uint64_t seed = 0);
+	void seed(uint64_t seed);
+
+	void next(uint32_t *res);	// writes 4 numbers
+	Float4 next_float();		// uniform in [0, 1)
+
+	// fill an array with uniform random numbers in [0, 1)
+	void fill(float *dest, int count);
+};
+
+/* per-thread generator, created on first use in each thread. Each thread gets
+ * a different stream, in order of first use.
+ */
+GPH_MATH_API Rng &thread_rng();
+
+/* Random sampling. The single-sample versions take an Rng, and the array
+ * versions an Rng4.
+ * - discrand: uniform on a disc of radius rad, centered at the origin.
+ * - sphrand: uniform on the surface of a sphere of radius rad.
+ * - hemirand: uniform on the unit hemisphere around n (unit length).
+ * - cosrand: cosine-weighted on the unit hemisphere around n (unit length),
+ *   with pdf cos(theta) / pi.
+ */
+GPH_MATH_API Vec2 discrand(Rng &rng, float rad = 1.0f);
+GPH_MATH_API Vec3 sphrand(Rng &rng, float rad = 1.0f);
+GPH_MATH_API Vec3 hemirand(Rng &rng, const Vec3 &n);
+GPH_MATH_API Vec3 cosrand(Rng &rng, const Vec3 &n);
+
+GPH_MATH_API void discrand(Rng4 &rng, Vec2 *dest, int count, float rad = 1.0f);
+GPH_MATH_API void sphrand(Rng4 &rng, Vec3 *dest, int count, float rad = 1.0f);
+GPH_MATH_API void hemirand(Rng4 &rng, Vec3 *dest, int count, const Vec3 &n);
+GPH_MATH_API void cosrand(Rng4 &rng, Vec3 *dest, int count, const Vec3 &n);
+
+#include "random.inl"
+
+}	// namespace gph
+
+#endif	// GMATH_RANDOM_H_
@@ -0,0 +1,33 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+
+inline uint32_t Rng::next()
+{
+	uint64_t old = state;
+	state = old * 6364136223846793005ULL + inc;
+
+	uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+	uint32_t rot = (uint32_t)(old >> 59);
+	return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+/* the top 24 bits fit exactly in the float mantissa */
+inline float Rng::next_float()
+{
+	return (float)(next() >> 8) * (1.0f / 16777216.0f);
+}
+
+/* Lemire's multiply and shift range reduction; the bias is negligible for any
+ * n much smaller than 2^32
+ */
+inline int Rng::next_int(int n)
+{
+	return (int)(((uint64_t)next() * (uint64_t)n) >> 32);
+}
@@ -8,3 +8,55 @@ If you intend to redistribute parts of the code without the LICENSE file
 replace this paragraph with the full contents of the LICENSE file.
 */
 #include "ray.h"
+
+namespace gph {
+
+void transform_rays(Ray *dest, const Ray *src, int count, const Mat4 &m)
+{
+	transform_points(&dest->origin.x, sizeof *dest, &src->origin.x, sizeof *src, count, m);
+	transform_vectors(&dest->dir.x, sizeof *dest, &src->dir.x, sizeof *src, count, m);
+}
+
+void transform_rays(RayPacket4 *dest, const RayPacket4 *src, int count, const Mat4 &m)
+{
+	Float4 m00 = m[0][0], m01 = m[0][1], m02 = m[0][2];
+	Float4 m10 = m[1][0], m11 = m[1][1], m12 = m[1][2];
+	Float4 m20 = m[2][0], m21 = m[2][1], m22 = m[2][2];
+	Float4 m30 = m[3][0], m31 = m[3][1], m32 = m[3][2];
+
+	for(int i=0; i<count; i++) {
+		const Vec3x4 &o = src[i].origin;
+		const Vec3x4 &d = src[i].dir;
+
+		Vec3x4 xo = Vec3x4(m00 * o.x + m10 * o.y + m20 * o.z + m30,
+				m01 * o.x + m11 * o.y + m21 * o.z + m31,
+				m02 * o.x + m12 * o.y + m22 * o.z + m32);
+		Vec3x4 xd = Vec3x4(m00 * d.x + m10 * d.y + m20 * d.z,
+				m01 * d.x + m11 * d.y + m21 * d.z,
+				m02 * d.x + m12 * d.y + m22 * d.z);
+		dest[i] = RayPacket4(xo, xd);
+	}
+}
+
+void transform_rays(RayPacket8 *dest, const RayPacket8 *src, int count, const Mat4 &m)
+{
+	Float8 m00 = m[0][0], m01 = m[0][1], m02 = m[0][2];
+	Float8 m10 = m[1][0], m11 = m[1][1], m12 = m[1][2];
+	Float8 m20 = m[2][0], m21 = m[2][1], m22 = m[2][2];
+	Float8 m30 = m[3][0], m31 = m[3][1], m32 = m[3][2];
+
+	for(int i=0; i<count; i++) {
+		const Vec3x8 &o = src[i].origin;
+		const Vec3x8 &d = src[i].dir;
+
+		Vec3x8 xo = Vec3x8(m00 * o.x + m10 * o.y + m20 * o.z + m30,
+				m01 * o.x + m11 * o.y + m21 * o.z + m31,
+				m02 * o.x + m12 * o.y + m22 * o.z + m32);
+		Vec3x8 xd = Vec3x8(m00 * d.x + m10 * d.y + m20 * d.z,
+				m01 * d.x + m11 * d.y + m21 * d.z,
+				m02 * d.x + m12 * d.y + m22 * d.z);
+		dest[i] = RayPacket8(xo, xd);
+	}
+}
+
+}	// namespace gph
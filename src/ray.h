@@ -14,6 +14,7 @@ replace this paragraph with the full contents of the LICENSE file.
 
 #include "vector.h"
 #include "matrix.h"
+#include "wide.h"
 
 namespace gph {
 
@@ -25,19 +26,23 @@ public:
 	Ray(const Vec3 &o, const Vec3 &d) : origin(o), dir(d) {}
 };
 
+/* the direction is transformed by the upper 3x3 part of the matrix only */
 inline GPH_MATH_API Ray operator *(const Ray &r, const Mat4 &m)
 {
-	Mat4 up = m.upper3x3();
-	return Ray(r.origin * m, r.dir * up);
+	const Vec3 &d = r.dir;
+	return Ray(r.origin * m, Vec3(d.x * m[0][0] + d.y * m[0][1] + d.z * m[0][2],
+				d.x * m[1][0] + d.y * m[1][1] + d.z * m[1][2],
+				d.x * m[2][0] + d.y * m[2][1] + d.z * m[2][2]));
 }
 
 inline GPH_MATH_API Ray operator *(const Mat4 &m, const Ray &r)
 {
-	Mat4 up = m.upper3x3();
-	return Ray(m * r.origin, up * r.dir);
+	const Vec3 &d = r.dir;
+	return Ray(m * r.origin, Vec3(m[0][0] * d.x + m[1][0] * d.y + m[2][0] * d.z,
+				m[0][1] * d.x + m[1][1] * d.y + m[2][1] * d.z,
+				m[0][2] * d.x + m[1][2] * d.y + m[2][2] * d.z));
 }
 
-
 inline GPH_MATH_API Ray reflect(const Ray &ray, const Vec3 &n)
 {
 	return Ray(ray.origin, reflect(ray.dir, n));
@@ -53,6 +58,111 @@ inline GPH_MATH_API Ray refract(const Ray &ray, const Vec3 &n, float from_ior, f
 	return Ray(ray.origin, refract(ray.dir, n, from_ior, to_ior));
 }
 
+/* transforms an array of rays by m, same as dest[i] = m * src[i] */
+GPH_MATH_API void transform_rays(Ray *dest, const Ray *src, int count, const Mat4 &m);
+
+
+/* Packets of 4 or 8 rays in SoA layout, for processing coherent rays at SIMD
+ * width. The reciprocal of the direction is calculated whenever a packet is
+ * constructed, for the benefit of slab tests. Direction components which are
+ * zero produce infinities in inv_dir, as intended.
+ */
+class GPH_MATH_API RayPacket4 {
+public:
+	Vec3x4 origin, dir;
+	Vec3x4 inv_dir;
+
+	RayPacket4() : dir(Float4(0.0f), Float4(0.0f), Float4(1.0f)) { calc_inv_dir(); }
+	RayPacket4(const Vec3x4 &o, const Vec3x4 &d) : origin(o), dir(d) { calc_inv_dir(); }
+	// load 4 consecutive rays from an array
+	explicit RayPacket4(const Ray *rays) : origin(&rays[0].origin, sizeof *rays),
+		dir(&rays[0].dir, sizeof *rays) { calc_inv_dir(); }
+
+	void calc_inv_dir() { inv_dir = Vec3x4(Float4(1.0f) / dir.x, Float4(1.0f) / dir.y, Float4(1.0f) / dir.z); }
+
+	// store all rays to 4 consecutive elements of an array
+	inline void store(Ray *rays) const;
+	Ray operator [](int idx) const { return Ray(origin[idx], dir[idx]); }
+};
+
+class GPH_MATH_API RayPacket8 {
+public:
+	Vec3x8 origin, dir;
+	Vec3x8 inv_dir;
+
+	RayPacket8() : dir(Float8(0.0f), Float8(0.0f), Float8(1.0f)) { calc_inv_dir(); }
+	RayPacket8(const Vec3x8 &o, const Vec3x8 &d) : origin(o), dir(d) { calc_inv_dir(); }
+	// load 8 consecutive rays from an array
+	explicit RayPacket8(const Ray *rays) : origin(&rays[0].origin, sizeof *rays),
+		dir(&rays[0].dir, sizeof *rays) { calc_inv_dir(); }
+
+	void calc_inv_dir() { inv_dir = Vec3x8(Float8(1.0f) / dir.x, Float8(1.0f) / dir.y, Float8(1.0f) / dir.z); }
+
+	// store all rays to 8 consecutive elements of an array
+	inline void store(Ray *rays) const;
+	Ray operator [](int idx) const { return Ray(origin[idx], dir[idx]); }
+};
+
+inline void RayPacket4::store(Ray *rays) const
+{
+	for(int i=0; i<4; i++) {
+		rays[i] = Ray(origin[i], dir[i]);
+	}
+}
+
+inline void RayPacket8::store(Ray *rays) const
+{
+	for(int i=0; i<8; i++) {
+		rays[i] = Ray(origin[i], dir[i]);
+	}
+}
+
+inline GPH_MATH_API RayPacket4 operator *(const Mat4 &m, const RayPacket4 &r)
+{
+	return RayPacket4(m * r.origin, transform_vector(m, r.dir));
+}
+
+inline GPH_MATH_API RayPacket8 operator *(const Mat4 &m, const RayPacket8 &r)
+{
+	return RayPacket8(m * r.origin, transform_vector(m, r.dir));
+}
+
+/* transform arrays of packets, broadcasting the matrix elements only once */
+GPH_MATH_API void transform_rays(RayPacket4 *dest, const RayPacket4 *src, int count, const Mat4 &m);
+GPH_MATH_API void transform_rays(RayPacket8 *dest, const RayPacket8 *src, int count, const Mat4 &m);
+
+inline GPH_MATH_API RayPacket4 reflect(const RayPacket4 &ray, const Vec3x4 &n)
+{
+	return RayPacket4(ray.origin, reflect(ray.dir, n));
+}
+
+inline GPH_MATH_API RayPacket4 refract(const RayPacket4 &ray, const Vec3x4 &n, const Float4 &ior)
+{
+	return RayPacket4(ray.origin, refract(ray.dir, n, ior));
+}
+
+inline GPH_MATH_API RayPacket4 refract(const RayPacket4 &ray, const Vec3x4 &n,
+		const Float4 &from_ior, const Float4 &to_ior)
+{
+	return RayPacket4(ray.origin, refract(ray.dir, n, from_ior, to_ior));
+}
+
+inline GPH_MATH_API RayPacket8 reflect(const RayPacket8 &ray, const Vec3x8 &n)
+{
+	return RayPacket8(ray.origin, reflect(ray.dir, n));
+}
+
+inline GPH_MATH_API RayPacket8 refract(const RayPacket8 &ray, const Vec3x8 &n, const Float8 &ior)
+{
+	return RayPacket8(ray.origin, refract(ray.dir, n, ior));
+}
+
+inline GPH_MATH_API RayPacket8 refract(const RayPacket8 &ray, const Vec3x8 &n,
+		const Float8 &from_ior, const Float8 &to_ior)
+{
+	return RayPacket8(ray.origin, refract(ray.dir, n, from_ior, to_ior));
+}
+
 
 }	// namespace gph
 
@@ -0,0 +1,402 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#include <math.h>
+#include <vector>
+#include "sampling.h"
+#include "random.h"
+#include "misc.h"
+
+#define SOBOL_DIMS		4
+#define BLUE_NOISE_SIZE	64
+/* largest float below 1 */
+#define ONE_MINUS_EPS	0.99999994f
+
+namespace gph {
+
+/* top 24 bits of a 0.32 fixed point number, to a float in [0, 1) */
+static inline float fixed_to_float(uint32_t x)
+{
+	return (float)(x >> 8) * (1.0f / 16777216.0f);
+}
+
+static inline uint32_t reverse_bits(uint32_t x)
+{
+	x = (x << 16) | (x >> 16);
+	x = ((x & 0x00ff00ff) << 8) | ((x & 0xff00ff00) >> 8);
+	x = ((x & 0x0f0f0f0f) << 4) | ((x & 0xf0f0f0f0) >> 4);
+	x = ((x & 0x33333333) << 2) | ((x & 0xcccccccc) >> 2);
+	x = ((x & 0x55555555) << 1) | ((x & 0xaaaaaaaa) >> 1);
+	return x;
+}
+
+static inline uint32_t hash(uint32_t x)
+{
+	x ^= x >> 16;
+	x *= 0x7feb352d;
+	x ^= x >> 15;
+	x *= 0x846ca68b;
+	x ^= x >> 16;
+	return x;
+}
+
+// ---- Halton ----
+
+float halton(uint32_t idx, int base)
+{
+	if(base < 2) return 0.0f;
+
+	if(base == 2) {
+		return fixed_to_float(reverse_bits(idx));
+	}
+
+	uint64_t rev = 0, denom = 1;
+	while(idx) {
+		rev = rev * base + idx % base;
+		idx /= base;
+		denom *= base;
+	}
+	float res = (float)((double)rev / (double)denom);
+	return res < ONE_MINUS_EPS ? res : ONE_MINUS_EPS;
+}
+
+Vec2 halton2(uint32_t idx)
+{
+	return Vec2(halton(idx, 2), halton(idx, 3));
+}
+
+Vec3 halton3(uint32_t idx)
+{
+	return Vec3(halton(idx, 2), halton(idx, 3), halton(idx, 5));
+}
+
+// ---- Sobol ----
+
+/* direction numbers for the first few dimensions, from the primitive
+ * polynomials and initial values of Joe and Kuo's new-joe-kuo-6.21201
+ */
+struct SobolMatrices {
+	uint32_t v[SOBOL_DIMS][32];
+
+	SobolMatrices()
+	{
+		static const int deg[] = {0, 1, 2, 3};
+		static const int poly[] = {0, 0, 1, 1};
+		static const uint32_t init[][3] = {{0, 0, 0}, {1, 0, 0}, {1, 3, 0}, {1, 3, 1}};
+
+		// the first dimension is the van der Corput sequence
+		for(int i=0; i<32; i++) {
+			v[0][i] = 1u << (31 - i);
+		}
+
+		for(int d=1; d<SOBOL_DIMS; d++) {
+			int s = deg[d];
+			for(int i=0; i<s; i++) {
+				v[d][i] = init[d][i] << (31 - i);
+			}
+			for(int i=s; i<32; i++) {
+				uint32_t x = v[d][i - s] ^ (v[d][i - s] >> s);
+				for(int j=1; j<s; j++) {
+					if((poly[d] >> (s - 1 - j)) & 1) {
+						x ^= v[d][i - j];
+					}
+				}
+				v[d][i] = x;
+			}
+		}
+	}
+};
+
+static uint32_t sobol_bits(uint32_t idx, int dim)
+{
+	static const SobolMatrices mat;
+
+	uint32_t res = 0;
+	const uint32_t *v = mat.v[dim];
+	while(idx) {
+		if(idx & 1) res ^= *v;
+		idx >>= 1;
+		v++;
+	}
+	return res;
+}
+
+/* Owen scrambling as a hash of the reversed bits (Burley's improvement of the
+ * Laine-Karras permutation)
+ */
+static inline uint32_t owen_scramble(uint32_t x, uint32_t seed)
+{
+	x = reverse_bits(x);
+	x ^= x * 0x3d20adea;
+	x += seed;
+	x *= (seed >> 16) | 1;
+	x ^= x * 0x05526c56;
+	x ^= x * 0x53a22864;
+	return reverse_bits(x);
+}
+
+float sobol(uint32_t idx, int dim, uint32_t seed)
+{
+	if(dim < 0 || dim >= SOBOL_DIMS) return 0.0f;
+
+	if(!seed) {
+		return fixed_to_float(sobol_bits(idx, dim));
+	}
+
+	/* shuffle the sample order as well, so that different seeds don't
+	 * share the same first sample
+	 */
+	idx = owen_scramble(idx, hash(seed));
+	uint32_t bits = sobol_bits(idx, dim);
+	return fixed_to_float(owen_scramble(bits, hash(seed + dim + 1)));
+}
+
+Vec2 sobol2(uint32_t idx, uint32_t seed)
+{
+	return Vec2(sobol(idx, 0, seed), sobol(idx, 1, seed));
+}
+
+Vec3 sobol3(uint32_t idx, uint32_t seed)
+{
+	return Vec3(sobol(idx, 0, seed), sobol(idx, 1, seed), sobol(idx, 2, seed));
+}
+
+// ---- R-sequences ----
+/* x(n) = frac(0.5 + n * a), computed in 0.32 fixed point, where the
+ * multipliers a are the reciprocal powers of the generalized golden ratios:
+ * phi for 1D, the plastic number for 2D, and the root of x^4 = x + 1 for 3D.
+ */
+
+float r1(uint32_t idx)
+{
+	return fixed_to_float(0x80000000u + idx * 2654435769u);
+}
+
+Vec2 r2(uint32_t idx)
+{
+	return Vec2(fixed_to_float(0x80000000u + idx * 3242174889u),
+			fixed_to_float(0x80000000u + idx * 2447445414u));
+}
+
+Vec3 r3(uint32_t idx)
+{
+	return Vec3(fixed_to_float(0x80000000u + idx * 3518319155u),
+			fixed_to_float(0x80000000u + idx * 2882110345u),
+			fixed_to_float(0x80000000u + idx * 2360945575u));
+}
+
+// ---- blue noise ----
+/* Ulichney's void-and-cluster method. The energy of each pixel is the sum of
+ * gaussians, on the torus, centered at each set pixel of a binary pattern.
+ * The tightest cluster is the set pixel with the highest energy, and the
+ * largest void the unset pixel with the lowest.
+ */
+#define VC_SIGMA	1.5f
+
+struct VoidCluster {
+	int size;
+	std::vector<float> kernel;	// gaussian of the toroidal offset
+	std::vector<float> energy;
+	std::vector<char> pattern;
+
+	VoidCluster(int sz) : size(sz), kernel(sz * sz), energy(sz * sz), pattern(sz * sz)
+	{
+		for(int i=0; i<size; i++) {
+			int dy = i < size / 2 ? i : size - i;
+			for(int j=0; j<size; j++) {
+				int dx = j < size / 2 ? j : size - j;
+				kernel[i * size + j] = exp(-(float)(dx * dx + dy * dy) / (2.0f * VC_SIGMA * VC_SIGMA));
+			}
+		}
+	}
+
+	void toggle(int idx)
+	{
+		float s = pattern[idx] ? -1.0f : 1.0f;
+		pattern[idx] = !pattern[idx];
+
+		int px = idx % size, py = idx / size;
+		for(int i=0; i<size; i++) {
+			const float *krow = &kernel[((i - py + size) % size) * size];
+			float *erow = &energy[i * size];
+			for(int j=0; j<size; j++) {
+				erow[j] += s * krow[(j - px + size) % size];
+			}
+		}
+	}
+
+	int tightest_cluster() const
+	{
+		int best = -1;
+		for(int i=0; i<size * size; i++) {
+			if(pattern[i] && (best < 0 || energy[i] > energy[best])) {
+				best = i;
+			}
+		}
+		return best;
+	}
+
+	int largest_void() const
+	{
+		int best = -1;
+		for(int i=0; i<size * size; i++) {
+			if(!pattern[i] && (best < 0 || energy[i] < energy[best])) {
+				best = i;
+			}
+		}
+		return best;
+	}
+};
+
+void gen_blue_noise(float *dest, int size, uint32_t seed)
+{
+	if(size <= 0) return;
+
+	int npix = size * size;
+	VoidCluster vc(size);
+	Rng rng(seed);
+
+	/* initial binary pattern: about a tenth of the pixels at random, then
+	 * moved from the tightest clusters to the largest voids, until that
+	 * doesn't change anything
+	 */
+	int num_init = npix / 10 > 0 ? npix / 10 : 1;
+	for(int i=0; i<num_init; i++) {
+		int idx;
+		do {
+			idx = rng.next_int(npix);
+		} while(vc.pattern[idx]);
+		vc.toggle(idx);
+	}
+	for(int i=0; i<npix; i++) {
+		int cluster = vc.tightest_cluster();
+		vc.toggle(cluster);
+		int hole = vc.largest_void();
+		if(hole == cluster) {
+			vc.toggle(cluster);
+			break;
+		}
+		vc.toggle(hole);
+	}
+
+	std::vector<int> rank(npix);
+	std::vector<char> initial = vc.pattern;
+	std::vector<float> initial_energy = vc.energy;
+
+	/* ranks below the initial pattern size: remove the tightest clusters */
+	for(int r=num_init-1; r>=0; r--) {
+		int idx = vc.tightest_cluster();
+		vc.toggle(idx);
+		rank[idx] = r;
+	}
+
+	/* the rest: fill the largest voids */
+	vc.pattern = initial;
+	vc.energy = initial_energy;
+	for(int r=num_init; r<npix; r++) {
+		int idx = vc.largest_void();
+		vc.toggle(idx);
+		rank[idx] = r;
+	}
+
+	for(int i=0; i<npix; i++) {
+		dest[i] = ((float)rank[i] + 0.5f) / (float)npix;
+	}
+}
+
+struct BlueNoiseTile {
+	float val[BLUE_NOISE_SIZE * BLUE_NOISE_SIZE];
+
+	BlueNoiseTile()
+	{
+		gen_blue_noise(val, BLUE_NOISE_SIZE);
+	}
+};
+
+float blue_noise(int x, int y)
+{
+	static const BlueNoiseTile tile;
+	return tile.val[(y & (BLUE_NOISE_SIZE - 1)) * BLUE_NOISE_SIZE + (x & (BLUE_NOISE_SIZE - 1))];
+}
+
+// ---- warping ----
+
+/* orthonormal basis around the unit vector n, without branches or
+ * normalization (Duff et al. "Building an orthonormal basis, revisited")
+ */
+static inline Vec3 from_basis(const Vec3 &v, const Vec3 &n)
+{
+	float sign = n.z >= 0.0f ? 1.0f : -1.0f;
+	float a = -1.0f / (sign + n.z);
+	float b = n.x * n.y * a;
+	Vec3 tang = Vec3(1.0f + sign * n.x * n.x * a, sign * b, -sign * n.x);
+	Vec3 bitan = Vec3(b, sign + n.y * n.y * a, -n.y);
+	return tang * v.x + bitan * v.y + n * v.z;
+}
+
+Vec2 warp_disc(const Vec2 &u)
+{
+	float a = 2.0f * u.x - 1.0f;
+	float b = 2.0f * u.y - 1.0f;
+	if(a == 0.0f && b == 0.0f) {
+		return Vec2(0.0f, 0.0f);
+	}
+
+	float r, phi;
+	if(fabs(a) > fabs(b)) {
+		r = a;
+		phi = (M_PI / 4.0f) * (b / a);
+	} else {
+		r = b;
+		phi = (M_PI / 2.0f) - (M_PI / 4.0f) * (a / b);
+	}
+	return Vec2(r * cos(phi), r * sin(phi));
+}
+
+Vec3 warp_sphere(const Vec2 &u)
+{
+	float z = 1.0f - 2.0f * u.y;
+	float r = sqrt(z * z < 1.0f ? 1.0f - z * z : 0.0f);
+	float phi = 2.0f * M_PI * u.x;
+	return Vec3(r * cos(phi), r * sin(phi), z);
+}
+
+Vec3 warp_hemisphere(const Vec2 &u, const Vec3 &n)
+{
+	float z = u.y;
+	float r = sqrt(z * z < 1.0f ? 1.0f - z * z : 0.0f);
+	float phi = 2.0f * M_PI * u.x;
+	return from_basis(Vec3(r * cos(phi), r * sin(phi), z), n);
+}
+
+/* Malley's method: project points uniformly distributed on the disc up to the
+ * hemisphere
+ */
+Vec3 warp_cos_hemisphere(const Vec2 &u, const Vec3 &n)
+{
+	Vec2 d = warp_disc(u);
+	float zsq = 1.0f - d.x * d.x - d.y * d.y;
+	return from_basis(Vec3(d.x, d.y, sqrt(zsq > 0.0f ? zsq : 0.0f)), n);
+}
+
+Vec3 warp_triangle(const Vec2 &u)
+{
+	float su = sqrt(u.x);
+	float b0 = 1.0f - su;
+	float b1 = u.y * su;
+	return Vec3(b0, b1, 1.0f - b0 - b1);
+}
+
+Vec3 warp_triangle(const Vec2 &u, const Vec3 &v0, const Vec3 &v1, const Vec3 &v2)
+{
+	Vec3 b = warp_triangle(u);
+	return v0 * b.x + v1 * b.y + v2 * b.z;
+}
+
+}	// namespace gph
@@ -0,0 +1,83 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#ifndef GMATH_SAMPLING_H_
+#define GMATH_SAMPLING_H_
+
+#include "config.h"
+
+#include <stdint.h>
+#include "vector.h"
+
+/* Low-discrepancy sequences and sample warping.
+ *
+ * The sequences return points in [0, 1)^n for a sample index, and cover the
+ * unit square (cube) far more evenly than random points, so Monte Carlo
+ * estimates converge with fewer samples. They are deterministic; use a
+ * different seed per pixel (or a Cranley-Patterson rotation) to decorrelate
+ * them.
+ *
+ * The warping functions map points in [0, 1)^2 to other domains, preserving
+ * uniformity (or producing the stated density), and as much of the
+ * stratification of the input as possible.
+ */
+
+namespace gph {
+
+// ---- sequences ----
+
+/* radical inverse of idx in the given base, which must be 2 or greater (and
+ * normally a prime). Returns 0 for invalid bases.
+ */
+GPH_MATH_API float halton(uint32_t idx, int base);
+GPH_MATH_API Vec2 halton2(uint32_t idx);		// bases 2 and 3
+GPH_MATH_API Vec3 halton3(uint32_t idx);		// bases 2, 3, and 5
+
+/* Sobol sequence, for dimensions 0 to 3, with hash-based Owen scrambling
+ * (Burley, "Practical hash-based Owen scrambling"). Each seed gives a
+ * different scrambling, seed 0 gives the unscrambled sequence.
+ */
+GPH_MATH_API float sobol(uint32_t idx, int dim, uint32_t seed = 0);
+GPH_MATH_API Vec2 sobol2(uint32_t idx, uint32_t seed = 0);
+GPH_MATH_API Vec3 sobol3(uint32_t idx, uint32_t seed = 0);
+
+/* Kronecker sequences (Roberts' R-sequences) based on the generalized golden
+ * ratios. Extremely cheap, with good coverage for any number of samples.
+ */
+GPH_MATH_API float r1(uint32_t idx);
+GPH_MATH_API Vec2 r2(uint32_t idx);
+GPH_MATH_API Vec3 r3(uint32_t idx);
+
+/* Blue noise threshold maps, for dithering and decorrelating per-pixel sample
+ * sequences. gen_blue_noise fills a tileable size x size map with values in
+ * [0, 1) using the void-and-cluster method; generation takes O(size^4) time,
+ * so keep it around 64x64. blue_noise returns values from a 64x64 map, which
+ * is generated once, on first use, and repeats every 64 pixels.
+ */
+GPH_MATH_API void gen_blue_noise(float *dest, int size, uint32_t seed = 0);
+GPH_MATH_API float blue_noise(int x, int y);
+
+// ---- warping ----
+
+/* unit disc, with Shirley's concentric mapping */
+GPH_MATH_API Vec2 warp_disc(const Vec2 &u);
+/* unit sphere */
+GPH_MATH_API Vec3 warp_sphere(const Vec2 &u);
+/* unit hemisphere around the unit vector n, uniform or cosine-weighted */
+GPH_MATH_API Vec3 warp_hemisphere(const Vec2 &u, const Vec3 &n);
+GPH_MATH_API Vec3 warp_cos_hemisphere(const Vec2 &u, const Vec3 &n);
+/* triangle; the first version returns barycentric coordinates: the weights of
+ * v0, v1, and v2 in the x, y, and z components respectively
+ */
+GPH_MATH_API Vec3 warp_triangle(const Vec2 &u);
+GPH_MATH_API Vec3 warp_triangle(const Vec2 &u, const Vec3 &v0, const Vec3 &v1, const Vec3 &v2);
+
+}	// namespace gph
+
+#endif	// GMATH_SAMPLING_H_
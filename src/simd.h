@@ -0,0 +1,49 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#ifndef GMATH_SIMD_H_
+#define GMATH_SIMD_H_
+
+/* Compile-time selection of the SIMD code paths used by the hot functions.
+ * Whatever the compiler is targetting decides which path is used:
+ *  - GPH_SIMD_AVX2: AVX2 integer operations and gathers (implies GPH_SIMD_AVX)
+ *  - GPH_SIMD_AVX: 256bit AVX (implies GPH_SIMD_SSE as well)
+ *  - GPH_SIMD_SSE: 128bit SSE
+ *  - GPH_SIMD_NEON: 128bit ARM NEON
+ * If none of them is defined, the plain scalar code is used. Define
+ * GPH_NO_SIMD before including any gph-math header to force the scalar code.
+ *
+ * The SIMD paths perform the same operations in the same order as the scalar
+ * code, so results are bit-identical to it, unless the compiler decides to
+ * contract the scalar code into fused multiply-adds (-ffp-contract), in which
+ * case they differ by at most 1 ULP per accumulated product.
+ */
+#ifndef GPH_NO_SIMD
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define GPH_SIMD_SSE
+#include <xmmintrin.h>
+
+#ifdef __AVX__
+#define GPH_SIMD_AVX
+#include <immintrin.h>
+
+#ifdef __AVX2__
+#define GPH_SIMD_AVX2
+#endif
+#endif
+
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define GPH_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#endif	/* !GPH_NO_SIMD */
+
+#endif	/* GMATH_SIMD_H_ */
@@ -0,0 +1,39 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#include "transform.h"
+
+namespace gph {
+
+const Mat3x4 Mat3x4::identity(Vec3(1, 0, 0), Vec3(0, 1, 0), Vec3(0, 0, 1), Vec3(0, 0, 0));
+const Transform Transform::identity;
+
+Quat Mat3x4::get_rotation() const
+{
+	// Mat4::get_rotation expects an orthonormal upper 3x3
+	Vec3 s = get_scaling();
+	Mat4 rmat = Mat4(Vec3(m[0][0], m[0][1], m[0][2]) / s.x,
+			Vec3(m[1][0], m[1][1], m[1][2]) / s.y,
+			Vec3(m[2][0], m[2][1], m[2][2]) / s.z);
+	return normalize(rmat.get_rotation());
+}
+
+Transform::Transform(const Mat4 &m)
+{
+	*this = Transform(Mat3x4(m));
+}
+
+Transform::Transform(const Mat3x4 &m)
+{
+	scale = m.get_scaling();
+	rotation = m.get_rotation();
+	translation = m.get_translation();
+}
+
+}	// namespace gph
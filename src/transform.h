@@ -0,0 +1,117 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#ifndef GMATH_TRANSFORM_H_
+#define GMATH_TRANSFORM_H_
+
+#include "config.h"
+
+#include "vector.h"
+#include "matrix.h"
+#include "quat.h"
+
+/* Compact representations of affine transformations, for when the projective
+ * part of Mat4 is not needed.
+ *
+ * Mat3x4 is a Mat4 with the last column (0, 0, 0, 1) dropped: 12 floats, laid
+ * out exactly like the first 3 elements of each row of Mat4, so m[3] is the
+ * translation. It can represent any affine transformation, and all operations
+ * follow the conventions of Mat4, including the order of multiplication:
+ * a * b applies a first and then b.
+ *
+ * Transform is a decomposed scale, rotation, and translation (applied in that
+ * order), which is easier to edit and interpolate. Composition and inversion
+ * of transforms with non-uniform scaling can't be represented exactly, unless
+ * the scaling is only on the leaf (first applied) side of the composition;
+ * use Mat3x4 for those.
+ */
+
+namespace gph {
+
+class Transform;
+
+class GPH_MATH_API Mat3x4 {
+public:
+	float m[4][3];
+
+	static const Mat3x4 identity;
+
+	constexpr Mat3x4();
+	constexpr Mat3x4(const Vec3 &v0, const Vec3 &v1, const Vec3 &v2, const Vec3 &v3 = Vec3(0, 0, 0));
+	constexpr explicit Mat3x4(const Mat4 &mat);
+	inline explicit Mat3x4(NoInit);
+	inline explicit Mat3x4(const Transform &xform);
+
+	inline float *operator [](int idx);
+	constexpr const float *operator [](int idx) const;
+
+	inline float determinant() const;
+
+	inline bool inverse();
+	// assumes the upper 3x3 part is orthonormal (rotation+translation)
+	inline void inverse_rigid();
+
+	inline Vec3 get_translation() const;
+	Quat get_rotation() const;
+	inline Vec3 get_scaling() const;
+
+	inline Mat4 calc_matrix() const;
+};
+
+class GPH_MATH_API Transform {
+public:
+	Vec3 scale;
+	Quat rotation;
+	Vec3 translation;
+
+	static const Transform identity;
+
+	constexpr Transform() : scale(1, 1, 1) {}
+	constexpr Transform(const Vec3 &trans, const Quat &rot, const Vec3 &s = Vec3(1, 1, 1))
+		: scale(s), rotation(rot), translation(trans) {}
+	/* decompose an affine matrix, which should not contain any shearing or
+	 * negative scaling
+	 */
+	explicit Transform(const Mat4 &m);
+	explicit Transform(const Mat3x4 &m);
+
+	inline void invert();
+
+	inline Mat4 calc_matrix() const;
+};
+
+// ---- Mat3x4 functions ----
+inline GPH_MATH_API Mat3x4 operator *(const Mat3x4 &a, const Mat3x4 &b);
+inline GPH_MATH_API Mat3x4 &operator *=(Mat3x4 &a, const Mat3x4 &b);
+
+// transform as a point (w = 1), same as Mat4 * Vec3
+inline GPH_MATH_API Vec3 operator *(const Mat3x4 &m, const Vec3 &v);
+// transform as a vector (w = 0), by the upper 3x3 part of m
+inline GPH_MATH_API Vec3 transform_vector(const Mat3x4 &m, const Vec3 &v);
+
+// ---- Transform functions ----
+// a * b applies a first and then b, like matrices
+inline GPH_MATH_API Transform operator *(const Transform &a, const Transform &b);
+inline GPH_MATH_API Transform &operator *=(Transform &a, const Transform &b);
+
+inline GPH_MATH_API Transform inverse(const Transform &xform);
+
+inline GPH_MATH_API Vec3 transform_point(const Transform &xform, const Vec3 &p);
+inline GPH_MATH_API Vec3 transform_vector(const Transform &xform, const Vec3 &v);
+
+/* interpolation of each part separately: linear for the translation and
+ * scale, and slerp for the rotation
+ */
+inline GPH_MATH_API Transform lerp(const Transform &a, const Transform &b, float t);
+
+#include "transform.inl"
+
+}	// namespace gph
+
+#endif	// GMATH_TRANSFORM_H_
@@ -0,0 +1,276 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+
+// ---- Mat3x4 ----
+
+constexpr Mat3x4::Mat3x4()
+	: m{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {0, 0, 0}}
+{
+}
+
+constexpr Mat3x4::Mat3x4(const Vec3 &v0, const Vec3 &v1, const Vec3 &v2, const Vec3 &v3)
+	: m{{v0.x, v0.y, v0.z}, {v1.x, v1.y, v1.z}, {v2.x, v2.y, v2.z}, {v3.x, v3.y, v3.z}}
+{
+}
+
+constexpr Mat3x4::Mat3x4(const Mat4 &mat)
+	: m{{mat.m[0][0], mat.m[0][1], mat.m[0][2]},
+		{mat.m[1][0], mat.m[1][1], mat.m[1][2]},
+		{mat.m[2][0], mat.m[2][1], mat.m[2][2]},
+		{mat.m[3][0], mat.m[3][1], mat.m[3][2]}}
+{
+}
+
+inline Mat3x4::Mat3x4(NoInit)
+{
+}
+
+inline Mat3x4::Mat3x4(const Transform &xform)
+{
+	const Quat &q = xform.rotation;
+	const Vec3 &s = xform.scale;
+
+	float xsq2 = 2.0f * q.x * q.x;
+	float ysq2 = 2.0f * q.y * q.y;
+	float zsq2 = 2.0f * q.z * q.z;
+
+	m[0][0] = (1.0f - ysq2 - zsq2) * s.x;
+	m[0][1] = (2.0f * q.x * q.y + 2.0f * q.w * q.z) * s.x;
+	m[0][2] = (2.0f * q.z * q.x - 2.0f * q.w * q.y) * s.x;
+	m[1][0] = (2.0f * q.x * q.y - 2.0f * q.w * q.z) * s.y;
+	m[1][1] = (1.0f - xsq2 - zsq2) * s.y;
+	m[1][2] = (2.0f * q.y * q.z + 2.0f * q.w * q.x) * s.y;
+	m[2][0] = (2.0f * q.z * q.x + 2.0f * q.w * q.y) * s.z;
+	m[2][1] = (2.0f * q.y * q.z - 2.0f * q.w * q.x) * s.z;
+	m[2][2] = (1.0f - xsq2 - ysq2) * s.z;
+	m[3][0] = xform.translation.x;
+	m[3][1] = xform.translation.y;
+	m[3][2] = xform.translation.z;
+}
+
+inline float *Mat3x4::operator [](int idx)
+{
+	return m[idx];
+}
+
+constexpr const float *Mat3x4::operator [](int idx) const
+{
+	return m[idx];
+}
+
+inline float Mat3x4::determinant() const
+{
+	return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) +
+		m[0][1] * (m[1][2] * m[2][0] - m[1][0] * m[2][2]) +
+		m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+}
+
+// same as Mat4::inverse_affine
+inline bool Mat3x4::inverse()
+{
+	float c00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+	float c01 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+	float c02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+
+	float det = m[0][0] * c00 + m[0][1] * c01 + m[0][2] * c02;
+	if(!det) return false;
+	float s = 1.0f / det;
+
+	Mat3x4 a = *this;
+	m[0][0] = c00 * s;
+	m[0][1] = (a.m[0][2] * a.m[2][1] - a.m[0][1] * a.m[2][2]) * s;
+	m[0][2] = (a.m[0][1] * a.m[1][2] - a.m[0][2] * a.m[1][1]) * s;
+	m[1][0] = c01 * s;
+	m[1][1] = (a.m[0][0] * a.m[2][2] - a.m[0][2] * a.m[2][0]) * s;
+	m[1][2] = (a.m[0][2] * a.m[1][0] - a.m[0][0] * a.m[1][2]) * s;
+	m[2][0] = c02 * s;
+	m[2][1] = (a.m[0][1] * a.m[2][0] - a.m[0][0] * a.m[2][1]) * s;
+	m[2][2] = (a.m[0][0] * a.m[1][1] - a.m[0][1] * a.m[1][0]) * s;
+
+	float tx = a.m[3][0], ty = a.m[3][1], tz = a.m[3][2];
+	m[3][0] = -(tx * m[0][0] + ty * m[1][0] + tz * m[2][0]);
+	m[3][1] = -(tx * m[0][1] + ty * m[1][1] + tz * m[2][1]);
+	m[3][2] = -(tx * m[0][2] + ty * m[1][2] + tz * m[2][2]);
+	return true;
+}
+
+inline void Mat3x4::inverse_rigid()
+{
+	float tx = m[3][0], ty = m[3][1], tz = m[3][2];
+
+	float tmp;
+	tmp = m[0][1]; m[0][1] = m[1][0]; m[1][0] = tmp;
+	tmp = m[0][2]; m[0][2] = m[2][0]; m[2][0] = tmp;
+	tmp = m[1][2]; m[1][2] = m[2][1]; m[2][1] = tmp;
+
+	m[3][0] = -(tx * m[0][0] + ty * m[1][0] + tz * m[2][0]);
+	m[3][1] = -(tx * m[0][1] + ty * m[1][1] + tz * m[2][1]);
+	m[3][2] = -(tx * m[0][2] + ty * m[1][2] + tz * m[2][2]);
+}
+
+inline Vec3 Mat3x4::get_translation() const
+{
+	return Vec3(m[3][0], m[3][1], m[3][2]);
+}
+
+inline Vec3 Mat3x4::get_scaling() const
+{
+	return Vec3(length(Vec3(m[0][0], m[0][1], m[0][2])),
+			length(Vec3(m[1][0], m[1][1], m[1][2])),
+			length(Vec3(m[2][0], m[2][1], m[2][2])));
+}
+
+inline Mat4 Mat3x4::calc_matrix() const
+{
+	return Mat4(m[0][0], m[0][1], m[0][2], 0.0f,
+			m[1][0], m[1][1], m[1][2], 0.0f,
+			m[2][0], m[2][1], m[2][2], 0.0f,
+			m[3][0], m[3][1], m[3][2], 1.0f);
+}
+
+/* The SSE version loads and stores the 12 floats as 3 whole registers, and
+ * shuffles them to and from one row per register. Loading or storing each row
+ * separately would need overlapping accesses, which defeat store forwarding
+ * when composing chains of transformations.
+ */
+inline Mat3x4 operator *(const Mat3x4 &a, const Mat3x4 &b)
+{
+	Mat3x4 res(noinit);
+#if defined(GPH_SIMD_SSE)
+	__m128 c0 = _mm_loadu_ps(b.m[0]);	// b00 b01 b02 b10
+	__m128 c1 = _mm_loadu_ps(b.m[1] + 1);	// b11 b12 b20 b21
+	__m128 c2 = _mm_loadu_ps(b.m[2] + 2);	// b22 b30 b31 b32
+
+	__m128 t = _mm_shuffle_ps(c0, c1, _MM_SHUFFLE(1, 0, 3, 3));
+	__m128 b0 = c0;
+	__m128 b1 = _mm_shuffle_ps(t, t, _MM_SHUFFLE(3, 3, 2, 0));
+	__m128 b2 = _mm_shuffle_ps(c1, c2, _MM_SHUFFLE(0, 0, 3, 2));
+	__m128 b3 = _mm_shuffle_ps(c2, c2, _MM_SHUFFLE(3, 3, 2, 1));
+
+	__m128 r[4];
+	for(int i=0; i<4; i++) {
+		r[i] = _mm_mul_ps(_mm_set1_ps(a.m[i][0]), b0);
+		r[i] = _mm_add_ps(r[i], _mm_mul_ps(_mm_set1_ps(a.m[i][1]), b1));
+		r[i] = _mm_add_ps(r[i], _mm_mul_ps(_mm_set1_ps(a.m[i][2]), b2));
+	}
+	r[3] = _mm_add_ps(r[3], b3);
+
+	t = _mm_shuffle_ps(r[0], r[1], _MM_SHUFFLE(0, 0, 2, 2));
+	_mm_storeu_ps(res.m[0], _mm_shuffle_ps(r[0], t, _MM_SHUFFLE(2, 0, 1, 0)));
+	_mm_storeu_ps(res.m[1] + 1, _mm_shuffle_ps(r[1], r[2], _MM_SHUFFLE(1, 0, 2, 1)));
+	t = _mm_shuffle_ps(r[2], r[3], _MM_SHUFFLE(0, 0, 2, 2));
+	_mm_storeu_ps(res.m[2] + 2, _mm_shuffle_ps(t, r[3], _MM_SHUFFLE(2, 1, 2, 0)));
+#elif defined(GPH_SIMD_NEON)
+	/* each row loaded with the first element of the next one in the last
+	 * lane, except for the last row, which is loaded from one float earlier
+	 * and shifted into place
+	 */
+	float32x4_t b0 = vld1q_f32(b.m[0]);
+	float32x4_t b1 = vld1q_f32(b.m[1]);
+	float32x4_t b2 = vld1q_f32(b.m[2]);
+	float32x4_t b3 = vld1q_f32(b.m[2] + 2);
+	b3 = vextq_f32(b3, b3, 1);
+
+	float32x4_t r[4];
+	for(int i=0; i<4; i++) {
+		r[i] = vmulq_n_f32(b0, a.m[i][0]);
+		r[i] = vaddq_f32(r[i], vmulq_n_f32(b1, a.m[i][1]));
+		r[i] = vaddq_f32(r[i], vmulq_n_f32(b2, a.m[i][2]));
+	}
+	r[3] = vaddq_f32(r[3], b3);
+
+	// in order, each store overwriting the stray last lane of the previous one
+	vst1q_f32(res.m[0], r[0]);
+	vst1q_f32(res.m[1], r[1]);
+	vst1q_f32(res.m[2], r[2]);
+	vst1_f32(res.m[3], vget_low_f32(r[3]));
+	vst1q_lane_f32(res.m[3] + 2, r[3], 2);
+#else
+	for(int i=0; i<4; i++) {
+		float x = a.m[i][0], y = a.m[i][1], z = a.m[i][2];
+		res.m[i][0] = x * b.m[0][0] + y * b.m[1][0] + z * b.m[2][0];
+		res.m[i][1] = x * b.m[0][1] + y * b.m[1][1] + z * b.m[2][1];
+		res.m[i][2] = x * b.m[0][2] + y * b.m[1][2] + z * b.m[2][2];
+	}
+	res.m[3][0] += b.m[3][0];
+	res.m[3][1] += b.m[3][1];
+	res.m[3][2] += b.m[3][2];
+#endif
+	return res;
+}
+
+inline Mat3x4 &operator *=(Mat3x4 &a, const Mat3x4 &b)
+{
+	a = a * b;
+	return a;
+}
+
+inline Vec3 operator *(const Mat3x4 &m, const Vec3 &v)
+{
+	float x = m[0][0] * v.x + m[1][0] * v.y + m[2][0] * v.z + m[3][0];
+	float y = m[0][1] * v.x + m[1][1] * v.y + m[2][1] * v.z + m[3][1];
+	float z = m[0][2] * v.x + m[1][2] * v.y + m[2][2] * v.z + m[3][2];
+	return Vec3(x, y, z);
+}
+
+inline Vec3 transform_vector(const Mat3x4 &m, const Vec3 &v)
+{
+	float x = m[0][0] * v.x + m[1][0] * v.y + m[2][0] * v.z;
+	float y = m[0][1] * v.x + m[1][1] * v.y + m[2][1] * v.z;
+	float z = m[0][2] * v.x + m[1][2] * v.y + m[2][2] * v.z;
+	return Vec3(x, y, z);
+}
+
+// ---- Transform ----
+
+inline void Transform::invert()
+{
+	*this = inverse(*this);
+}
+
+inline Mat4 Transform::calc_matrix() const
+{
+	return Mat3x4(*this).calc_matrix();
+}
+
+inline Transform operator *(const Transform &a, const Transform &b)
+{
+	return Transform(rotate_unit(a.translation * b.scale, b.rotation) + b.translation,
+			b.rotation * a.rotation, a.scale * b.scale);
+}
+
+inline Transform &operator *=(Transform &a, const Transform &b)
+{
+	a = a * b;
+	return a;
+}
+
+inline Transform inverse(const Transform &xform)
+{
+	Vec3 s = Vec3(1.0f / xform.scale.x, 1.0f / xform.scale.y, 1.0f / xform.scale.z);
+	Quat r = conjugate(xform.rotation);
+	return Transform(-rotate_unit(xform.translation, r) * s, r, s);
+}
+
+inline Vec3 transform_point(const Transform &xform, const Vec3 &p)
+{
+	return rotate_unit(p * xform.scale, xform.rotation) + xform.translation;
+}
+
+inline Vec3 transform_vector(const Transform &xform, const Vec3 &v)
+{
+	return rotate_unit(v * xform.scale, xform.rotation);
+}
+
+inline Transform lerp(const Transform &a, const Transform &b, float t)
+{
+	return Transform(lerp(a.translation, b.translation, t), slerp(a.rotation, b.rotation, t),
+			lerp(a.scale, b.scale, t));
+}
@@ -65,21 +65,25 @@ Vec3 operator *(const Mat4 &m, const Vec3 &v)
 
 Vec3 rotate(const Vec3 &v, const Vec3 &axis, float angle)
 {
-	Mat4 rmat;
+	Mat4 rmat(noinit);
 	rmat.rotation(angle, axis);
 	return rmat * v;
 }
 
+/* q * v * inverse(q) expanded, without the quaternion products. Same as
+ * rotate_unit, but with the cross product scaled by 2 / |q|^2 instead of 2,
+ * which also makes it work for quaternions that are not normalized.
+ */
 Vec3 rotate(const Vec3 &v, const Quat &q)
 {
-	Quat vq = Quat(v.x, v.y, v.z, 0.0f);
-	vq = q * vq * inverse(q);
-	return Vec3(vq.x, vq.y, vq.z);
+	Vec3 u = Vec3(q.x, q.y, q.z);
+	Vec3 t = cross(u, v) * (2.0f / length_sq(q));
+	return v + t * q.w + cross(u, t);
 }
 
 Vec3 rotate(const Vec3 &v, const Vec3 &euler, EulerMode order)
 {
-	Mat4 rmat;
+	Mat4 rmat(noinit);
 	rmat.rotation(euler, order);
 	return rmat * v;
 }
@@ -118,26 +122,70 @@ Vec4::Vec4(const Vec3 &v)
 
 Vec4 operator *(const Vec4 &v, const Mat4 &m)
 {
+#if defined(GPH_SIMD_SSE)
+	__m128 c0 = _mm_loadu_ps(m[0]);
+	__m128 c1 = _mm_loadu_ps(m[1]);
+	__m128 c2 = _mm_loadu_ps(m[2]);
+	__m128 c3 = _mm_loadu_ps(m[3]);
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+	float res[4];
+	__m128 r = _mm_mul_ps(c0, _mm_set1_ps(v.x));
+	r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(v.y)));
+	r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(v.z)));
+	r = _mm_add_ps(r, _mm_mul_ps(c3, _mm_set1_ps(v.w)));
+	_mm_storeu_ps(res, r);
+	return Vec4(res[0], res[1], res[2], res[3]);
+#elif defined(GPH_SIMD_NEON)
+	float32x4x4_t c = vld4q_f32(m[0]);	// de-interleaving load transposes m
+
+	float res[4];
+	float32x4_t r = vmulq_n_f32(c.val[0], v.x);
+	r = vaddq_f32(r, vmulq_n_f32(c.val[1], v.y));
+	r = vaddq_f32(r, vmulq_n_f32(c.val[2], v.z));
+	r = vaddq_f32(r, vmulq_n_f32(c.val[3], v.w));
+	vst1q_f32(res, r);
+	return Vec4(res[0], res[1], res[2], res[3]);
+#else
 	float x = v.x * m[0][0] + v.y * m[0][1] + v.z * m[0][2] + v.w * m[0][3];
 	float y = v.x * m[1][0] + v.y * m[1][1] + v.z * m[1][2] + v.w * m[1][3];
 	float z = v.x * m[2][0] + v.y * m[2][1] + v.z * m[2][2] + v.w * m[2][3];
 	float w = v.x * m[3][0] + v.y * m[3][1] + v.z * m[3][2] + v.w * m[3][3];
 	return Vec4(x, y, z, w);
+#endif
 }
 
 Vec4 operator *(const Mat4 &m, const Vec4 &v)
 {
+#if defined(GPH_SIMD_SSE)
+	float res[4];
+	__m128 r = _mm_mul_ps(_mm_loadu_ps(m[0]), _mm_set1_ps(v.x));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m[1]), _mm_set1_ps(v.y)));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m[2]), _mm_set1_ps(v.z)));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m[3]), _mm_set1_ps(v.w)));
+	_mm_storeu_ps(res, r);
+	return Vec4(res[0], res[1], res[2], res[3]);
+#elif defined(GPH_SIMD_NEON)
+	float res[4];
+	float32x4_t r = vmulq_n_f32(vld1q_f32(m[0]), v.x);
+	r = vaddq_f32(r, vmulq_n_f32(vld1q_f32(m[1]), v.y));
+	r = vaddq_f32(r, vmulq_n_f32(vld1q_f32(m[2]), v.z));
+	r = vaddq_f32(r, vmulq_n_f32(vld1q_f32(m[3]), v.w));
+	vst1q_f32(res, r);
+	return Vec4(res[0], res[1], res[2], res[3]);
+#else
 	float x = m[0][0] * v.x + m[1][0] * v.y + m[2][0] * v.z + m[3][0] * v.w;
 	float y = m[0][1] * v.x + m[1][1] * v.y + m[2][1] * v.z + m[3][1] * v.w;
 	float z = m[0][2] * v.x + m[1][2] * v.y + m[2][2] * v.z + m[3][2] * v.w;
 	float w = m[0][3] * v.x + m[1][3] * v.y + m[2][3] * v.z + m[3][3] * v.w;
 	return Vec4(x, y, z, w);
+#endif
 }
 
 
 Vec4 rotate(const Vec4 &v, const Vec3 &axis, float angle)
 {
-	Mat4 rmat;
+	Mat4 rmat(noinit);
 	rmat.rotation(angle, axis);
 	return rmat * v;
 }
@@ -150,7 +198,7 @@ Vec4 rotate(const Vec4 &v, const Quat &q)
 
 Vec4 rotate(const Vec4 &v, const Vec3 &euler, EulerMode order)
 {
-	Mat4 rmat;
+	Mat4 rmat(noinit);
 	rmat.rotation(euler, order);
 	return rmat * v;
 }
@@ -31,6 +31,12 @@ class Vec4;
 class Mat4;
 class Quat;
 
+/* constructor tag which leaves vectors, quaternions, and matrices
+ * uninitialized, instead of zero or identity. For temporaries and buffers
+ * which are about to be overwritten entirely, e.g.: Mat4 res(noinit);
+ */
+enum NoInit { noinit };
+
 enum EulerMode {
 	EULER_XYZ,
 	EULER_XZY,
@@ -50,13 +56,14 @@ class GPH_MATH_API Vec2 {
 public:
 	float x, y;
 
-	Vec2() : x(0), y(0) {}
-	Vec2(float x_, float y_) : x(x_), y(y_) {}
+	constexpr Vec2() : x(0), y(0) {}
+	constexpr Vec2(float x_, float y_) : x(x_), y(y_) {}
+	explicit Vec2(NoInit) {}
 	explicit Vec2(const Vec3 &v);
 
 	inline void normalize();
 	inline float &operator[] (int idx);
-	inline const float &operator[] (int idx) const;
+	constexpr const float &operator[] (int idx) const;
 
 	GPH_VEC2_SWIZZLE
 };
@@ -65,13 +72,14 @@ class GPH_MATH_API Vec3 {
 public:
 	float x, y, z;
 
-	Vec3() : x(0), y(0), z(0) {}
-	Vec3(float x_, float y_, float z_) : x(x_), y(y_), z(z_) {}
+	constexpr Vec3() : x(0), y(0), z(0) {}
+	constexpr Vec3(float x_, float y_, float z_) : x(x_), y(y_), z(z_) {}
+	explicit Vec3(NoInit) {}
 	explicit Vec3(const Vec4 &v);
 
 	inline void normalize();
 	inline float &operator[] (int idx);
-	inline const float &operator[] (int idx) const;
+	constexpr const float &operator[] (int idx) const;
 
 	GPH_VEC3_SWIZZLE
 };
@@ -81,27 +89,28 @@ class GPH_MATH_API Vec4 {
 public:
 	float x, y, z, w;
 
-	Vec4() : x(0), y(0), z(0), w(0) {}
-	Vec4(float x_, float y_, float z_, float w_ = 1.0f) : x(x_), y(y_), z(z_), w(w_) {}
+	constexpr Vec4() : x(0), y(0), z(0), w(0) {}
+	constexpr Vec4(float x_, float y_, float z_, float w_ = 1.0f) : x(x_), y(y_), z(z_), w(w_) {}
+	explicit Vec4(NoInit) {}
 	explicit Vec4(const Vec3 &v);
 
 	inline void normalize();
 	inline float &operator[] (int idx);
-	inline const float &operator[] (int idx) const;
+	constexpr const float &operator[] (int idx) const;
 
 	GPH_VEC4_SWIZZLE
 };
 
 // ---- Vec2 functions ----
-inline GPH_MATH_API Vec2 operator -(const Vec2 &v);
-inline GPH_MATH_API Vec2 operator +(const Vec2 &a, const Vec2 &b);
-inline GPH_MATH_API Vec2 operator -(const Vec2 &a, const Vec2 &b);
-inline GPH_MATH_API Vec2 operator *(const Vec2 &a, const Vec2 &b);
-inline GPH_MATH_API Vec2 operator /(const Vec2 &a, const Vec2 &b);
-inline GPH_MATH_API Vec2 operator *(const Vec2 &v, float s);
-inline GPH_MATH_API Vec2 operator *(float s, const Vec2 &v);
-inline GPH_MATH_API Vec2 operator /(const Vec2 &v, float s);
-inline GPH_MATH_API Vec2 operator /(float s, const Vec2 &v);
+constexpr GPH_MATH_API Vec2 operator -(const Vec2 &v);
+constexpr GPH_MATH_API Vec2 operator +(const Vec2 &a, const Vec2 &b);
+constexpr GPH_MATH_API Vec2 operator -(const Vec2 &a, const Vec2 &b);
+constexpr GPH_MATH_API Vec2 operator *(const Vec2 &a, const Vec2 &b);
+constexpr GPH_MATH_API Vec2 operator /(const Vec2 &a, const Vec2 &b);
+constexpr GPH_MATH_API Vec2 operator *(const Vec2 &v, float s);
+constexpr GPH_MATH_API Vec2 operator *(float s, const Vec2 &v);
+constexpr GPH_MATH_API Vec2 operator /(const Vec2 &v, float s);
+constexpr GPH_MATH_API Vec2 operator /(float s, const Vec2 &v);
 inline GPH_MATH_API Vec2 &operator +=(Vec2 &a, const Vec2 &b);
 inline GPH_MATH_API Vec2 &operator -=(Vec2 &a, const Vec2 &b);
 inline GPH_MATH_API Vec2 &operator *=(Vec2 &a, const Vec2 &b);
@@ -112,40 +121,40 @@ inline GPH_MATH_API Vec2 &operator /=(Vec2 &v, float s);
 GPH_MATH_API Vec2 operator *(const Vec2 &v, const Mat4 &m);
 GPH_MATH_API Vec2 operator *(const Mat4 &m, const Vec2 &v);
 
-inline GPH_MATH_API bool operator ==(const Vec2 &a, const Vec2 &b);
-inline GPH_MATH_API bool operator !=(const Vec2 &a, const Vec2 &b);
+constexpr GPH_MATH_API bool operator ==(const Vec2 &a, const Vec2 &b);
+constexpr GPH_MATH_API bool operator !=(const Vec2 &a, const Vec2 &b);
 
-inline GPH_MATH_API float dot(const Vec2 &a, const Vec2 &b);
+constexpr GPH_MATH_API float dot(const Vec2 &a, const Vec2 &b);
 inline GPH_MATH_API float length(const Vec2 &v);
-inline GPH_MATH_API float length_sq(const Vec2 &v);
+constexpr GPH_MATH_API float length_sq(const Vec2 &v);
 inline GPH_MATH_API Vec2 normalize(const Vec2 &v);
 
-inline GPH_MATH_API Vec2 reflect(const Vec2 &v, const Vec2 &n);
+constexpr GPH_MATH_API Vec2 reflect(const Vec2 &v, const Vec2 &n);
 inline GPH_MATH_API Vec2 refract(const Vec2 &v, const Vec2 &n, float ior);
 inline GPH_MATH_API Vec2 refract(const Vec2 &v, const Vec2 &n, float from_ior, float to_ior);
 
 inline GPH_MATH_API float distance(const Vec2 &a, const Vec2 &b);
-inline GPH_MATH_API float distance_sq(const Vec2 &a, const Vec2 &b);
-inline GPH_MATH_API Vec2 faceforward(const Vec2 &n, const Vec2 &vi, const Vec2 &ng);
+constexpr GPH_MATH_API float distance_sq(const Vec2 &a, const Vec2 &b);
+constexpr GPH_MATH_API Vec2 faceforward(const Vec2 &n, const Vec2 &vi, const Vec2 &ng);
 
 inline GPH_MATH_API Vec2 major(const Vec2 &v);
 inline GPH_MATH_API int major_idx(const Vec2 &v);
-inline GPH_MATH_API Vec2 proj_axis(const Vec2 &v, const Vec2 &axis);
+constexpr GPH_MATH_API Vec2 proj_axis(const Vec2 &v, const Vec2 &axis);
 
 inline GPH_MATH_API Vec2 rotate(const Vec2 &v, float angle);
 
-inline GPH_MATH_API Vec2 lerp(const Vec2 &a, const Vec2 &b, float t);
+constexpr GPH_MATH_API Vec2 lerp(const Vec2 &a, const Vec2 &b, float t);
 
 // ---- Vec3 functions ----
-inline GPH_MATH_API Vec3 operator -(const Vec3 &v);
-inline GPH_MATH_API Vec3 operator +(const Vec3 &a, const Vec3 &b);
-inline GPH_MATH_API Vec3 operator -(const Vec3 &a, const Vec3 &b);
-inline GPH_MATH_API Vec3 operator *(const Vec3 &a, const Vec3 &b);
-inline GPH_MATH_API Vec3 operator /(const Vec3 &a, const Vec3 &b);
-inline GPH_MATH_API Vec3 operator *(const Vec3 &v, float s);
-inline GPH_MATH_API Vec3 operator *(float s, const Vec3 &v);
-inline GPH_MATH_API Vec3 operator /(const Vec3 &v, float s);
-inline GPH_MATH_API Vec3 operator /(float s, const Vec3 &v);
+constexpr GPH_MATH_API Vec3 operator -(const Vec3 &v);
+constexpr GPH_MATH_API Vec3 operator +(const Vec3 &a, const Vec3 &b);
+constexpr GPH_MATH_API Vec3 operator -(const Vec3 &a, const Vec3 &b);
+constexpr GPH_MATH_API Vec3 operator *(const Vec3 &a, const Vec3 &b);
+constexpr GPH_MATH_API Vec3 operator /(const Vec3 &a, const Vec3 &b);
+constexpr GPH_MATH_API Vec3 operator *(const Vec3 &v, float s);
+constexpr GPH_MATH_API Vec3 operator *(float s, const Vec3 &v);
+constexpr GPH_MATH_API Vec3 operator /(const Vec3 &v, float s);
+constexpr GPH_MATH_API Vec3 operator /(float s, const Vec3 &v);
 inline GPH_MATH_API Vec3 &operator +=(Vec3 &a, const Vec3 &b);
 inline GPH_MATH_API Vec3 &operator -=(Vec3 &a, const Vec3 &b);
 inline GPH_MATH_API Vec3 &operator *=(Vec3 &a, const Vec3 &b);
@@ -156,46 +165,46 @@ inline GPH_MATH_API Vec3 &operator /=(Vec3 &v, float s);
 GPH_MATH_API Vec3 operator *(const Vec3 &v, const Mat4 &m);
 GPH_MATH_API Vec3 operator *(const Mat4 &m, const Vec3 &v);
 
-inline GPH_MATH_API bool operator ==(const Vec3 &a, const Vec3 &b);
-inline GPH_MATH_API bool operator !=(const Vec3 &a, const Vec3 &b);
+constexpr GPH_MATH_API bool operator ==(const Vec3 &a, const Vec3 &b);
+constexpr GPH_MATH_API bool operator !=(const Vec3 &a, const Vec3 &b);
 
-inline GPH_MATH_API float dot(const Vec3 &a, const Vec3 &b);
-inline GPH_MATH_API Vec3 cross(const Vec3 &a, const Vec3 &b);
+constexpr GPH_MATH_API float dot(const Vec3 &a, const Vec3 &b);
+constexpr GPH_MATH_API Vec3 cross(const Vec3 &a, const Vec3 &b);
 inline GPH_MATH_API float length(const Vec3 &v);
-inline GPH_MATH_API float length_sq(const Vec3 &v);
+constexpr GPH_MATH_API float length_sq(const Vec3 &v);
 inline GPH_MATH_API Vec3 normalize(const Vec3 &v);
 
-inline GPH_MATH_API Vec3 reflect(const Vec3 &v, const Vec3 &n);
+constexpr GPH_MATH_API Vec3 reflect(const Vec3 &v, const Vec3 &n);
 inline GPH_MATH_API Vec3 refract(const Vec3 &v, const Vec3 &n, float ior);
 inline GPH_MATH_API Vec3 refract(const Vec3 &v, const Vec3 &n, float from_ior, float to_ior);
 
 inline GPH_MATH_API float distance(const Vec3 &a, const Vec3 &b);
-inline GPH_MATH_API float distance_sq(const Vec3 &a, const Vec3 &b);
-inline GPH_MATH_API Vec3 faceforward(const Vec3 &n, const Vec3 &vi, const Vec3 &ng);
+constexpr GPH_MATH_API float distance_sq(const Vec3 &a, const Vec3 &b);
+constexpr GPH_MATH_API Vec3 faceforward(const Vec3 &n, const Vec3 &vi, const Vec3 &ng);
 
 inline GPH_MATH_API Vec3 major(const Vec3 &v);
 inline GPH_MATH_API int major_idx(const Vec3 &v);
-inline GPH_MATH_API Vec3 proj_axis(const Vec3 &v, const Vec3 &axis);
+constexpr GPH_MATH_API Vec3 proj_axis(const Vec3 &v, const Vec3 &axis);
 
 GPH_MATH_API Vec3 rotate(const Vec3 &v, const Quat &q);
 GPH_MATH_API Vec3 rotate(const Vec3 &v, const Vec3 &axis, float angle);
 GPH_MATH_API Vec3 rotate(const Vec3 &v, const Vec3 &euler, EulerMode mode = EULER_XYZ);
 
-inline GPH_MATH_API Vec3 lerp(const Vec3 &a, const Vec3 &b, float t);
+constexpr GPH_MATH_API Vec3 lerp(const Vec3 &a, const Vec3 &b, float t);
 GPH_MATH_API Vec3 bezier(const Vec3 &a, const Vec3 &b, const Vec3 &c, const Vec3 &d, float t);
 GPH_MATH_API Vec3 bspline(const Vec3 &a, const Vec3 &b, const Vec3 &c, const Vec3 &d, float t);
 GPH_MATH_API Vec3 spline(const Vec3 &a, const Vec3 &b, const Vec3 &c, const Vec3 &d, float t);
 
 // ---- Vec4 functions ----
-inline GPH_MATH_API Vec4 operator -(const Vec4 &v);
-inline GPH_MATH_API Vec4 operator +(const Vec4 &a, const Vec4 &b);
-inline GPH_MATH_API Vec4 operator -(const Vec4 &a, const Vec4 &b);
-inline GPH_MATH_API Vec4 operator *(const Vec4 &a, const Vec4 &b);
-inline GPH_MATH_API Vec4 operator /(const Vec4 &a, const Vec4 &b);
-inline GPH_MATH_API Vec4 operator *(const Vec4 &v, float s);
-inline GPH_MATH_API Vec4 operator *(float s, const Vec4 &v);
-inline GPH_MATH_API Vec4 operator /(const Vec4 &v, float s);
-inline GPH_MATH_API Vec4 operator /(float s, const Vec4 &v);
+constexpr GPH_MATH_API Vec4 operator -(const Vec4 &v);
+constexpr GPH_MATH_API Vec4 operator +(const Vec4 &a, const Vec4 &b);
+constexpr GPH_MATH_API Vec4 operator -(const Vec4 &a, const Vec4 &b);
+constexpr GPH_MATH_API Vec4 operator *(const Vec4 &a, const Vec4 &b);
+constexpr GPH_MATH_API Vec4 operator /(const Vec4 &a, const Vec4 &b);
+constexpr GPH_MATH_API Vec4 operator *(const Vec4 &v, float s);
+constexpr GPH_MATH_API Vec4 operator *(float s, const Vec4 &v);
+constexpr GPH_MATH_API Vec4 operator /(const Vec4 &v, float s);
+constexpr GPH_MATH_API Vec4 operator /(float s, const Vec4 &v);
 inline GPH_MATH_API Vec4 &operator +=(Vec4 &a, const Vec4 &b);
 inline GPH_MATH_API Vec4 &operator -=(Vec4 &a, const Vec4 &b);
 inline GPH_MATH_API Vec4 &operator *=(Vec4 &a, const Vec4 &b);
@@ -206,32 +215,32 @@ inline GPH_MATH_API Vec4 &operator /=(Vec4 &v, float s);
 GPH_MATH_API Vec4 operator *(const Vec4 &v, const Mat4 &m);
 GPH_MATH_API Vec4 operator *(const Mat4 &m, const Vec4 &v);
 
-inline GPH_MATH_API bool operator ==(const Vec4 &a, const Vec4 &b);
-inline GPH_MATH_API bool operator !=(const Vec4 &a, const Vec4 &b);
+constexpr GPH_MATH_API bool operator ==(const Vec4 &a, const Vec4 &b);
+constexpr GPH_MATH_API bool operator !=(const Vec4 &a, const Vec4 &b);
 
-inline GPH_MATH_API float dot(const Vec4 &a, const Vec4 &b);
+constexpr GPH_MATH_API float dot(const Vec4 &a, const Vec4 &b);
 inline GPH_MATH_API Vec4 cross(const Vec4 &a, const Vec4 &b, const Vec4 &c);
 inline GPH_MATH_API float length(const Vec4 &v);
-inline GPH_MATH_API float length_sq(const Vec4 &v);
+constexpr GPH_MATH_API float length_sq(const Vec4 &v);
 inline GPH_MATH_API Vec4 normalize(const Vec4 &v);
 
-inline GPH_MATH_API Vec4 reflect(const Vec4 &v, const Vec4 &n);
+constexpr GPH_MATH_API Vec4 reflect(const Vec4 &v, const Vec4 &n);
 inline GPH_MATH_API Vec4 refract(const Vec4 &v, const Vec4 &n, float ior);
 inline GPH_MATH_API Vec4 refract(const Vec4 &v, const Vec4 &n, float from_ior, float to_ior);
 
 inline GPH_MATH_API float distance(const Vec4 &a, const Vec4 &b);
-inline GPH_MATH_API float distance_sq(const Vec4 &a, const Vec4 &b);
-inline GPH_MATH_API Vec4 faceforward(const Vec4 &n, const Vec4 &vi, const Vec4 &ng);
+constexpr GPH_MATH_API float distance_sq(const Vec4 &a, const Vec4 &b);
+constexpr GPH_MATH_API Vec4 faceforward(const Vec4 &n, const Vec4 &vi, const Vec4 &ng);
 
 inline GPH_MATH_API Vec4 major(const Vec4 &v);
 inline GPH_MATH_API int major_idx(const Vec4 &v);
-inline GPH_MATH_API Vec4 proj_axis(const Vec4 &v, const Vec4 &axis);
+constexpr GPH_MATH_API Vec4 proj_axis(const Vec4 &v, const Vec4 &axis);
 
 GPH_MATH_API Vec4 rotate(const Vec4 &v, const Quat &q);
 inline GPH_MATH_API Vec4 rotate(const Vec4 &v, const Vec3 &axis, float angle);
 inline GPH_MATH_API Vec4 rotate(const Vec4 &v, const Vec3 &euler, EulerMode mode = EULER_XYZ);
 
-inline GPH_MATH_API Vec4 lerp(const Vec4 &a, const Vec4 &b, float t);
+constexpr GPH_MATH_API Vec4 lerp(const Vec4 &a, const Vec4 &b, float t);
 
 // include definitions of all the inline GPH_MATH_API functions above
 #include "vector2.inl"
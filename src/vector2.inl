@@ -21,52 +21,52 @@ inline float &Vec2::operator[] (int idx)
 	return idx == 0 ? x : y;
 }
 
-inline const float &Vec2::operator[] (int idx) const
+constexpr const float &Vec2::operator[] (int idx) const
 {
 	return idx == 0 ? x : y;
 }
 
-inline Vec2 operator -(const Vec2 &v)
+constexpr Vec2 operator -(const Vec2 &v)
 {
 	return Vec2(-v.x, -v.y);
 }
 
-inline Vec2 operator +(const Vec2 &a, const Vec2 &b)
+constexpr Vec2 operator +(const Vec2 &a, const Vec2 &b)
 {
 	return Vec2(a.x + b.x, a.y + b.y);
 }
 
-inline Vec2 operator -(const Vec2 &a, const Vec2 &b)
+constexpr Vec2 operator -(const Vec2 &a, const Vec2 &b)
 {
 	return Vec2(a.x - b.x, a.y - b.y);
 }
 
-inline Vec2 operator *(const Vec2 &a, const Vec2 &b)
+constexpr Vec2 operator *(const Vec2 &a, const Vec2 &b)
 {
 	return Vec2(a.x * b.x, a.y * b.y);
 }
 
-inline Vec2 operator /(const Vec2 &a, const Vec2 &b)
+constexpr Vec2 operator /(const Vec2 &a, const Vec2 &b)
 {
 	return Vec2(a.x / b.x, a.y / b.y);
 }
 
-inline Vec2 operator *(const Vec2 &v, float s)
+constexpr Vec2 operator *(const Vec2 &v, float s)
 {
 	return Vec2(v.x * s, v.y * s);
 }
 
-inline Vec2 operator *(float s, const Vec2 &v)
+constexpr Vec2 operator *(float s, const Vec2 &v)
 {
 	return Vec2(s * v.x, s * v.y);
 }
 
-inline Vec2 operator /(const Vec2 &v, float s)
+constexpr Vec2 operator /(const Vec2 &v, float s)
 {
 	return Vec2(v.x / s, v.y / s);
 }
 
-inline Vec2 operator /(float s, const Vec2 &v)
+constexpr Vec2 operator /(float s, const Vec2 &v)
 {
 	return Vec2(s / v.x, s / v.y);
 }
@@ -114,18 +114,18 @@ inline Vec2 &operator /=(Vec2 &v, float s)
 }
 
 
-inline bool operator ==(const Vec2 &a, const Vec2 &b)
+constexpr bool operator ==(const Vec2 &a, const Vec2 &b)
 {
 	return a.x == b.x && a.y == b.y;
 }
 
-inline bool operator !=(const Vec2 &a, const Vec2 &b)
+constexpr bool operator !=(const Vec2 &a, const Vec2 &b)
 {
 	return !(a == b);
 }
 
 
-inline float dot(const Vec2 &a, const Vec2 &b)
+constexpr float dot(const Vec2 &a, const Vec2 &b)
 {
 	return a.x * b.x + a.y * b.y;
 }
@@ -135,7 +135,7 @@ inline float length(const Vec2 &v)
 	return (float)sqrt(v.x * v.x + v.y * v.y);
 }
 
-inline float length_sq(const Vec2 &v)
+constexpr float length_sq(const Vec2 &v)
 {
 	return v.x * v.x + v.y * v.y;
 }
@@ -151,7 +151,7 @@ inline Vec2 normalize(const Vec2 &v)
 }
 
 
-inline Vec2 reflect(const Vec2 &v, const Vec2 &n)
+constexpr Vec2 reflect(const Vec2 &v, const Vec2 &n)
 {
 	return v - n * dot(n, v) * 2.0;
 }
@@ -178,17 +178,17 @@ inline float distance(const Vec2 &a, const Vec2 &b)
 	return length(a - b);
 }
 
-inline float distance_sq(const Vec2 &a, const Vec2 &b)
+constexpr float distance_sq(const Vec2 &a, const Vec2 &b)
 {
 	return length_sq(a - b);
 }
 
-inline Vec2 faceforward(const Vec2 &n, const Vec2 &vi, const Vec2 &ng)
+constexpr Vec2 faceforward(const Vec2 &n, const Vec2 &vi, const Vec2 &ng)
 {
 	return dot(ng, vi) < 0.0f ? n : -n;
 }
 
-inline Vec2 faceforward(const Vec2 &n, const Vec2 &vi)
+constexpr Vec2 faceforward(const Vec2 &n, const Vec2 &vi)
 {
 	return dot(n, vi) < 0.0f ? n : -n;
 }
@@ -206,7 +206,7 @@ inline int major_idx(const Vec2 &v)
 	return fabs(v.x) >= fabs(v.y) ? 0 : 1;
 }
 
-inline Vec2 proj_axis(const Vec2 &v, const Vec2 &axis)
+constexpr Vec2 proj_axis(const Vec2 &v, const Vec2 &axis)
 {
 	return axis * dot(v, axis);
 }
@@ -221,7 +221,7 @@ inline Vec2 rotate(const Vec2 &v, float angle)
 	return Vec2(x, y);
 }
 
-inline Vec2 lerp(const Vec2 &a, const Vec2 &b, float t)
+constexpr Vec2 lerp(const Vec2 &a, const Vec2 &b, float t)
 {
 	return a + (b - a) * t;
 }
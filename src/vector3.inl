@@ -22,52 +22,52 @@ inline float &Vec3::operator[] (int idx)
 	return idx == 0 ? x : (idx == 1 ? y : z);
 }
 
-inline const float &Vec3::operator[] (int idx) const
+constexpr const float &Vec3::operator[] (int idx) const
 {
 	return idx == 0 ? x : (idx == 1 ? y : z);
 }
 
-inline Vec3 operator -(const Vec3 &v)
+constexpr Vec3 operator -(const Vec3 &v)
 {
 	return Vec3(-v.x, -v.y, -v.z);
 }
 
-inline Vec3 operator +(const Vec3 &a, const Vec3 &b)
+constexpr Vec3 operator +(const Vec3 &a, const Vec3 &b)
 {
 	return Vec3(a.x + b.x, a.y + b.y, a.z + b.z);
 }
 
-inline Vec3 operator -(const Vec3 &a, const Vec3 &b)
+constexpr Vec3 operator -(const Vec3 &a, const Vec3 &b)
 {
 	return Vec3(a.x - b.x, a.y - b.y, a.z - b.z);
 }
 
-inline Vec3 operator *(const Vec3 &a, const Vec3 &b)
+constexpr Vec3 operator *(const Vec3 &a, const Vec3 &b)
 {
 	return Vec3(a.x * b.x, a.y * b.y, a.z * b.z);
 }
 
-inline Vec3 operator /(const Vec3 &a, const Vec3 &b)
+constexpr Vec3 operator /(const Vec3 &a, const Vec3 &b)
 {
 	return Vec3(a.x / b.x, a.y / b.y, a.z / b.z);
 }
 
-inline Vec3 operator *(const Vec3 &v, float s)
+constexpr Vec3 operator *(const Vec3 &v, float s)
 {
 	return Vec3(v.x * s, v.y * s, v.z * s);
 }
 
-inline Vec3 operator *(float s, const Vec3 &v)
+constexpr Vec3 operator *(float s, const Vec3 &v)
 {
 	return Vec3(s * v.x, s * v.y, s * v.z);
 }
 
-inline Vec3 operator /(const Vec3 &v, float s)
+constexpr Vec3 operator /(const Vec3 &v, float s)
 {
 	return Vec3(v.x / s, v.y / s, v.z / s);
 }
 
-inline Vec3 operator /(float s, const Vec3 &v)
+constexpr Vec3 operator /(float s, const Vec3 &v)
 {
 	return Vec3(s / v.x, s / v.y, s / v.z);
 }
@@ -120,22 +120,22 @@ inline Vec3 &operator /=(Vec3 &v, float s)
 	return v;
 }
 
-inline bool operator ==(const Vec3 &a, const Vec3 &b)
+constexpr bool operator ==(const Vec3 &a, const Vec3 &b)
 {
 	return a.x == b.x && a.y == b.y && a.z == b.z;
 }
 
-inline bool operator !=(const Vec3 &a, const Vec3 &b)
+constexpr bool operator !=(const Vec3 &a, const Vec3 &b)
 {
 	return !(a == b);
 }
 
-inline float dot(const Vec3 &a, const Vec3 &b)
+constexpr float dot(const Vec3 &a, const Vec3 &b)
 {
 	return a.x * b.x + a.y * b.y + a.z * b.z;
 }
 
-inline Vec3 cross(const Vec3 &a, const Vec3 &b)
+constexpr Vec3 cross(const Vec3 &a, const Vec3 &b)
 {
 	return Vec3(a.y * b.z - a.z * b.y,
 			a.z * b.x - a.x * b.z,
@@ -147,7 +147,7 @@ inline float length(const Vec3 &v)
 	return (float)sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
 }
 
-inline float length_sq(const Vec3 &v)
+constexpr float length_sq(const Vec3 &v)
 {
 	return v.x * v.x + v.y * v.y + v.z * v.z;
 }
@@ -162,7 +162,7 @@ inline Vec3 normalize(const Vec3 &v)
 	return Vec3(v.x / len, v.y / len, v.z / len);
 }
 
-inline Vec3 reflect(const Vec3 &v, const Vec3 &n)
+constexpr Vec3 reflect(const Vec3 &v, const Vec3 &n)
 {
 	return v - n * dot(n, v) * 2.0;
 }
@@ -188,17 +188,17 @@ inline float distance(const Vec3 &a, const Vec3 &b)
 	return length(a - b);
 }
 
-inline float distance_sq(const Vec3 &a, const Vec3 &b)
+constexpr float distance_sq(const Vec3 &a, const Vec3 &b)
 {
 	return length_sq(a - b);
 }
 
-inline Vec3 faceforward(const Vec3 &n, const Vec3 &vi, const Vec3 &ng)
+constexpr Vec3 faceforward(const Vec3 &n, const Vec3 &vi, const Vec3 &ng)
 {
 	return dot(ng, vi) < 0.0f ? n : -n;
 }
 
-inline Vec3 faceforward(const Vec3 &n, const Vec3 &vi)
+constexpr Vec3 faceforward(const Vec3 &n, const Vec3 &vi)
 {
 	return dot(n, vi) < 0.0f ? n : -n;
 }
@@ -217,12 +217,12 @@ inline int major_idx(const Vec3 &v)
 		(fabs(v.y) >= fabs(v.z) ? 1 : 2);
 }
 
-inline Vec3 proj_axis(const Vec3 &v, const Vec3 &axis)
+constexpr Vec3 proj_axis(const Vec3 &v, const Vec3 &axis)
 {
 	return axis * dot(v, axis);
 }
 
-inline Vec3 lerp(const Vec3 &a, const Vec3 &b, float t)
+constexpr Vec3 lerp(const Vec3 &a, const Vec3 &b, float t)
 {
 	return a + (b - a) * t;
 }
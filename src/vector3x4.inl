@@ -0,0 +1,233 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+inline const Vec3 *next_vec3(const Vec3 *ptr, int offs)
+{
+	return (const Vec3*)((const char*)ptr + offs);
+}
+
+inline Vec3x4::Vec3x4(const Vec3 &v)
+	: x(v.x), y(v.y), z(v.z)
+{
+}
+
+inline Vec3x4::Vec3x4(const Vec3 &a, const Vec3 &b, const Vec3 &c, const Vec3 &d)
+	: x(a.x, b.x, c.x, d.x), y(a.y, b.y, c.y, d.y), z(a.z, b.z, c.z, d.z)
+{
+}
+
+inline Vec3x4::Vec3x4(const Vec3 *arr)
+	: x(arr[0].x, arr[1].x, arr[2].x, arr[3].x),
+	y(arr[0].y, arr[1].y, arr[2].y, arr[3].y),
+	z(arr[0].z, arr[1].z, arr[2].z, arr[3].z)
+{
+}
+
+inline Vec3x4::Vec3x4(const Vec3 *arr, int stride)
+	: x(arr->x, next_vec3(arr, 1 * stride)->x, next_vec3(arr, 2 * stride)->x, next_vec3(arr, 3 * stride)->x),
+	y(arr->y, next_vec3(arr, 1 * stride)->y, next_vec3(arr, 2 * stride)->y, next_vec3(arr, 3 * stride)->y),
+	z(arr->z, next_vec3(arr, 1 * stride)->z, next_vec3(arr, 2 * stride)->z, next_vec3(arr, 3 * stride)->z)
+{
+}
+
+inline void Vec3x4::store(Vec3 *arr) const
+{
+	float tx[4], ty[4], tz[4];
+	x.store(tx);
+	y.store(ty);
+	z.store(tz);
+	for(int i=0; i<4; i++) {
+		arr[i] = Vec3(tx[i], ty[i], tz[i]);
+	}
+}
+
+inline Vec3 Vec3x4::operator [](int idx) const
+{
+	return Vec3(x[idx], y[idx], z[idx]);
+}
+
+inline Vec3x4 operator -(const Vec3x4 &v)
+{
+	return Vec3x4(-v.x, -v.y, -v.z);
+}
+
+inline Vec3x4 operator +(const Vec3x4 &a, const Vec3x4 &b)
+{
+	return Vec3x4(a.x + b.x, a.y + b.y, a.z + b.z);
+}
+
+inline Vec3x4 operator -(const Vec3x4 &a, const Vec3x4 &b)
+{
+	return Vec3x4(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+inline Vec3x4 operator *(const Vec3x4 &a, const Vec3x4 &b)
+{
+	return Vec3x4(a.x * b.x, a.y * b.y, a.z * b.z);
+}
+
+inline Vec3x4 operator /(const Vec3x4 &a, const Vec3x4 &b)
+{
+	return Vec3x4(a.x / b.x, a.y / b.y, a.z / b.z);
+}
+
+inline Vec3x4 operator *(const Vec3x4 &v, const Float4 &s)
+{
+	return Vec3x4(v.x * s, v.y * s, v.z * s);
+}
+
+inline Vec3x4 operator *(const Float4 &s, const Vec3x4 &v)
+{
+	return Vec3x4(s * v.x, s * v.y, s * v.z);
+}
+
+inline Vec3x4 operator /(const Vec3x4 &v, const Float4 &s)
+{
+	return Vec3x4(v.x / s, v.y / s, v.z / s);
+}
+
+inline Vec3x4 &operator +=(Vec3x4 &a, const Vec3x4 &b)
+{
+	a.x += b.x;
+	a.y += b.y;
+	a.z += b.z;
+	return a;
+}
+
+inline Vec3x4 &operator -=(Vec3x4 &a, const Vec3x4 &b)
+{
+	a.x -= b.x;
+	a.y -= b.y;
+	a.z -= b.z;
+	return a;
+}
+
+inline Vec3x4 &operator *=(Vec3x4 &a, const Vec3x4 &b)
+{
+	a.x *= b.x;
+	a.y *= b.y;
+	a.z *= b.z;
+	return a;
+}
+
+inline Vec3x4 &operator /=(Vec3x4 &a, const Vec3x4 &b)
+{
+	a.x /= b.x;
+	a.y /= b.y;
+	a.z /= b.z;
+	return a;
+}
+
+inline Vec3x4 &operator *=(Vec3x4 &v, const Float4 &s)
+{
+	v.x *= s;
+	v.y *= s;
+	v.z *= s;
+	return v;
+}
+
+inline Vec3x4 &operator /=(Vec3x4 &v, const Float4 &s)
+{
+	v.x /= s;
+	v.y /= s;
+	v.z /= s;
+	return v;
+}
+
+inline Vec3x4 select(const Float4 &mask, const Vec3x4 &a, const Vec3x4 &b)
+{
+	return Vec3x4(select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z));
+}
+
+inline Float4 dot(const Vec3x4 &a, const Vec3x4 &b)
+{
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline Vec3x4 cross(const Vec3x4 &a, const Vec3x4 &b)
+{
+	return Vec3x4(a.y * b.z - a.z * b.y,
+			a.z * b.x - a.x * b.z,
+			a.x * b.y - a.y * b.x);
+}
+
+inline Float4 length(const Vec3x4 &v)
+{
+	return vsqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+}
+
+inline Float4 length_sq(const Vec3x4 &v)
+{
+	return v.x * v.x + v.y * v.y + v.z * v.z;
+}
+
+/* like normalize(Vec3), zero-length vectors are left as they are */
+inline Vec3x4 normalize(const Vec3x4 &v)
+{
+	Float4 len = length(v);
+	Float4 nonzero = len != Float4(0.0f);
+	len = select(nonzero, len, Float4(1.0f));
+	return Vec3x4(v.x / len, v.y / len, v.z / len);
+}
+
+inline Vec3x4 reflect(const Vec3x4 &v, const Vec3x4 &n)
+{
+	return v - n * (dot(n, v) * Float4(2.0f));
+}
+
+/* lanes with total internal reflection produce zero vectors, like refract(Vec3) */
+inline Vec3x4 refract(const Vec3x4 &v, const Vec3x4 &n, const Float4 &ior)
+{
+	Float4 zero = Float4(0.0f);
+	Float4 ndotv = dot(n, v);
+	Float4 k = Float4(1.0f) - ior * ior * (Float4(1.0f) - ndotv * ndotv);
+	Float4 valid = k >= zero;
+	Vec3x4 res = ior * v - (ior * ndotv + vsqrt(max(k, zero))) * n;
+	return select(valid, res, Vec3x4(zero, zero, zero));
+}
+
+inline Vec3x4 refract(const Vec3x4 &v, const Vec3x4 &n, const Float4 &from_ior, const Float4 &to_ior)
+{
+	Float4 to = select(to_ior == Float4(0.0f), Float4(1.0f), to_ior);
+	return refract(v, n, from_ior / to);
+}
+
+inline Float4 distance(const Vec3x4 &a, const Vec3x4 &b)
+{
+	return length(a - b);
+}
+
+inline Float4 distance_sq(const Vec3x4 &a, const Vec3x4 &b)
+{
+	return length_sq(a - b);
+}
+
+inline Vec3x4 faceforward(const Vec3x4 &n, const Vec3x4 &vi, const Vec3x4 &ng)
+{
+	return select(dot(ng, vi) < Float4(0.0f), n, -n);
+}
+
+inline Vec3x4 lerp(const Vec3x4 &a, const Vec3x4 &b, const Float4 &t)
+{
+	return a + (b - a) * t;
+}
+
+inline Vec3x4 operator *(const Mat4 &m, const Vec3x4 &v)
+{
+	return Vec3x4(Float4(m[0][0]) * v.x + Float4(m[1][0]) * v.y + Float4(m[2][0]) * v.z + Float4(m[3][0]),
+			Float4(m[0][1]) * v.x + Float4(m[1][1]) * v.y + Float4(m[2][1]) * v.z + Float4(m[3][1]),
+			Float4(m[0][2]) * v.x + Float4(m[1][2]) * v.y + Float4(m[2][2]) * v.z + Float4(m[3][2]));
+}
+
+inline Vec3x4 transform_vector(const Mat4 &m, const Vec3x4 &v)
+{
+	return Vec3x4(Float4(m[0][0]) * v.x + Float4(m[1][0]) * v.y + Float4(m[2][0]) * v.z,
+			Float4(m[0][1]) * v.x + Float4(m[1][1]) * v.y + Float4(m[2][1]) * v.z,
+			Float4(m[0][2]) * v.x + Float4(m[1][2]) * v.y + Float4(m[2][2]) * v.z);
+}
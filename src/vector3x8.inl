@@ -0,0 +1,223 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+inline Vec3x8::Vec3x8(const Vec3 &v)
+	: x(v.x), y(v.y), z(v.z)
+{
+}
+
+inline Vec3x8::Vec3x8(const Vec3 *arr)
+	: x(arr[0].x, arr[1].x, arr[2].x, arr[3].x, arr[4].x, arr[5].x, arr[6].x, arr[7].x),
+	y(arr[0].y, arr[1].y, arr[2].y, arr[3].y, arr[4].y, arr[5].y, arr[6].y, arr[7].y),
+	z(arr[0].z, arr[1].z, arr[2].z, arr[3].z, arr[4].z, arr[5].z, arr[6].z, arr[7].z)
+{
+}
+
+inline Vec3x8::Vec3x8(const Vec3 *arr, int stride)
+	: x(arr->x, next_vec3(arr, 1 * stride)->x, next_vec3(arr, 2 * stride)->x, next_vec3(arr, 3 * stride)->x, next_vec3(arr, 4 * stride)->x, next_vec3(arr, 5 * stride)->x, next_vec3(arr, 6 * stride)->x, next_vec3(arr, 7 * stride)->x),
+	y(arr->y, next_vec3(arr, 1 * stride)->y, next_vec3(arr, 2 * stride)->y, next_vec3(arr, 3 * stride)->y, next_vec3(arr, 4 * stride)->y, next_vec3(arr, 5 * stride)->y, next_vec3(arr, 6 * stride)->y, next_vec3(arr, 7 * stride)->y),
+	z(arr->z, next_vec3(arr, 1 * stride)->z, next_vec3(arr, 2 * stride)->z, next_vec3(arr, 3 * stride)->z, next_vec3(arr, 4 * stride)->z, next_vec3(arr, 5 * stride)->z, next_vec3(arr, 6 * stride)->z, next_vec3(arr, 7 * stride)->z)
+{
+}
+
+inline void Vec3x8::store(Vec3 *arr) const
+{
+	float tx[8], ty[8], tz[8];
+	x.store(tx);
+	y.store(ty);
+	z.store(tz);
+	for(int i=0; i<8; i++) {
+		arr[i] = Vec3(tx[i], ty[i], tz[i]);
+	}
+}
+
+inline Vec3 Vec3x8::operator [](int idx) const
+{
+	return Vec3(x[idx], y[idx], z[idx]);
+}
+
+inline Vec3x8 operator -(const Vec3x8 &v)
+{
+	return Vec3x8(-v.x, -v.y, -v.z);
+}
+
+inline Vec3x8 operator +(const Vec3x8 &a, const Vec3x8 &b)
+{
+	return Vec3x8(a.x + b.x, a.y + b.y, a.z + b.z);
+}
+
+inline Vec3x8 operator -(const Vec3x8 &a, const Vec3x8 &b)
+{
+	return Vec3x8(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+inline Vec3x8 operator *(const Vec3x8 &a, const Vec3x8 &b)
+{
+	return Vec3x8(a.x * b.x, a.y * b.y, a.z * b.z);
+}
+
+inline Vec3x8 operator /(const Vec3x8 &a, const Vec3x8 &b)
+{
+	return Vec3x8(a.x / b.x, a.y / b.y, a.z / b.z);
+}
+
+inline Vec3x8 operator *(const Vec3x8 &v, const Float8 &s)
+{
+	return Vec3x8(v.x * s, v.y * s, v.z * s);
+}
+
+inline Vec3x8 operator *(const Float8 &s, const Vec3x8 &v)
+{
+	return Vec3x8(s * v.x, s * v.y, s * v.z);
+}
+
+inline Vec3x8 operator /(const Vec3x8 &v, const Float8 &s)
+{
+	return Vec3x8(v.x / s, v.y / s, v.z / s);
+}
+
+inline Vec3x8 &operator +=(Vec3x8 &a, const Vec3x8 &b)
+{
+	a.x += b.x;
+	a.y += b.y;
+	a.z += b.z;
+	return a;
+}
+
+inline Vec3x8 &operator -=(Vec3x8 &a, const Vec3x8 &b)
+{
+	a.x -= b.x;
+	a.y -= b.y;
+	a.z -= b.z;
+	return a;
+}
+
+inline Vec3x8 &operator *=(Vec3x8 &a, const Vec3x8 &b)
+{
+	a.x *= b.x;
+	a.y *= b.y;
+	a.z *= b.z;
+	return a;
+}
+
+inline Vec3x8 &operator /=(Vec3x8 &a, const Vec3x8 &b)
+{
+	a.x /= b.x;
+	a.y /= b.y;
+	a.z /= b.z;
+	return a;
+}
+
+inline Vec3x8 &operator *=(Vec3x8 &v, const Float8 &s)
+{
+	v.x *= s;
+	v.y *= s;
+	v.z *= s;
+	return v;
+}
+
+inline Vec3x8 &operator /=(Vec3x8 &v, const Float8 &s)
+{
+	v.x /= s;
+	v.y /= s;
+	v.z /= s;
+	return v;
+}
+
+inline Vec3x8 select(const Float8 &mask, const Vec3x8 &a, const Vec3x8 &b)
+{
+	return Vec3x8(select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z));
+}
+
+inline Float8 dot(const Vec3x8 &a, const Vec3x8 &b)
+{
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline Vec3x8 cross(const Vec3x8 &a, const Vec3x8 &b)
+{
+	return Vec3x8(a.y * b.z - a.z * b.y,
+			a.z * b.x - a.x * b.z,
+			a.x * b.y - a.y * b.x);
+}
+
+inline Float8 length(const Vec3x8 &v)
+{
+	return vsqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+}
+
+inline Float8 length_sq(const Vec3x8 &v)
+{
+	return v.x * v.x + v.y * v.y + v.z * v.z;
+}
+
+/* like normalize(Vec3), zero-length vectors are left as they are */
+inline Vec3x8 normalize(const Vec3x8 &v)
+{
+	Float8 len = length(v);
+	Float8 nonzero = len != Float8(0.0f);
+	len = select(nonzero, len, Float8(1.0f));
+	return Vec3x8(v.x / len, v.y / len, v.z / len);
+}
+
+inline Vec3x8 reflect(const Vec3x8 &v, const Vec3x8 &n)
+{
+	return v - n * (dot(n, v) * Float8(2.0f));
+}
+
+/* lanes with total internal reflection produce zero vectors, like refract(Vec3) */
+inline Vec3x8 refract(const Vec3x8 &v, const Vec3x8 &n, const Float8 &ior)
+{
+	Float8 zero = Float8(0.0f);
+	Float8 ndotv = dot(n, v);
+	Float8 k = Float8(1.0f) - ior * ior * (Float8(1.0f) - ndotv * ndotv);
+	Float8 valid = k >= zero;
+	Vec3x8 res = ior * v - (ior * ndotv + vsqrt(max(k, zero))) * n;
+	return select(valid, res, Vec3x8(zero, zero, zero));
+}
+
+inline Vec3x8 refract(const Vec3x8 &v, const Vec3x8 &n, const Float8 &from_ior, const Float8 &to_ior)
+{
+	Float8 to = select(to_ior == Float8(0.0f), Float8(1.0f), to_ior);
+	return refract(v, n, from_ior / to);
+}
+
+inline Float8 distance(const Vec3x8 &a, const Vec3x8 &b)
+{
+	return length(a - b);
+}
+
+inline Float8 distance_sq(const Vec3x8 &a, const Vec3x8 &b)
+{
+	return length_sq(a - b);
+}
+
+inline Vec3x8 faceforward(const Vec3x8 &n, const Vec3x8 &vi, const Vec3x8 &ng)
+{
+	return select(dot(ng, vi) < Float8(0.0f), n, -n);
+}
+
+inline Vec3x8 lerp(const Vec3x8 &a, const Vec3x8 &b, const Float8 &t)
+{
+	return a + (b - a) * t;
+}
+
+inline Vec3x8 operator *(const Mat4 &m, const Vec3x8 &v)
+{
+	return Vec3x8(Float8(m[0][0]) * v.x + Float8(m[1][0]) * v.y + Float8(m[2][0]) * v.z + Float8(m[3][0]),
+			Float8(m[0][1]) * v.x + Float8(m[1][1]) * v.y + Float8(m[2][1]) * v.z + Float8(m[3][1]),
+			Float8(m[0][2]) * v.x + Float8(m[1][2]) * v.y + Float8(m[2][2]) * v.z + Float8(m[3][2]));
+}
+
+inline Vec3x8 transform_vector(const Mat4 &m, const Vec3x8 &v)
+{
+	return Vec3x8(Float8(m[0][0]) * v.x + Float8(m[1][0]) * v.y + Float8(m[2][0]) * v.z,
+			Float8(m[0][1]) * v.x + Float8(m[1][1]) * v.y + Float8(m[2][1]) * v.z,
+			Float8(m[0][2]) * v.x + Float8(m[1][2]) * v.y + Float8(m[2][2]) * v.z);
+}
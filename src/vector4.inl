@@ -23,52 +23,52 @@ inline float &Vec4::operator[] (int idx)
 	return idx == 0 ? x : (idx == 1 ? y : (idx == 2 ? z : w));
 }
 
-inline const float &Vec4::operator[] (int idx) const
+constexpr const float &Vec4::operator[] (int idx) const
 {
 	return idx == 0 ? x : (idx == 1 ? y : (idx == 2 ? z : w));
 }
 
-inline Vec4 operator -(const Vec4 &v)
+constexpr Vec4 operator -(const Vec4 &v)
 {
 	return Vec4(-v.x, -v.y, -v.z, -v.w);
 }
 
-inline Vec4 operator +(const Vec4 &a, const Vec4 &b)
+constexpr Vec4 operator +(const Vec4 &a, const Vec4 &b)
 {
 	return Vec4(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
 }
 
-inline Vec4 operator -(const Vec4 &a, const Vec4 &b)
+constexpr Vec4 operator -(const Vec4 &a, const Vec4 &b)
 {
 	return Vec4(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w);
 }
 
-inline Vec4 operator *(const Vec4 &a, const Vec4 &b)
+constexpr Vec4 operator *(const Vec4 &a, const Vec4 &b)
 {
 	return Vec4(a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w);
 }
 
-inline Vec4 operator /(const Vec4 &a, const Vec4 &b)
+constexpr Vec4 operator /(const Vec4 &a, const Vec4 &b)
 {
 	return Vec4(a.x / b.x, a.y / b.y, a.z / b.z, a.w / b.w);
 }
 
-inline Vec4 operator *(const Vec4 &v, float s)
+constexpr Vec4 operator *(const Vec4 &v, float s)
 {
 	return Vec4(v.x * s, v.y * s, v.z * s, v.w * s);
 }
 
-inline Vec4 operator *(float s, const Vec4 &v)
+constexpr Vec4 operator *(float s, const Vec4 &v)
 {
 	return Vec4(s * v.x, s * v.y, s * v.z, s * v.w);
 }
 
-inline Vec4 operator /(const Vec4 &v, float s)
+constexpr Vec4 operator /(const Vec4 &v, float s)
 {
 	return Vec4(v.x / s, v.y / s, v.z / s, v.w / s);
 }
 
-inline Vec4 operator /(float s, const Vec4 &v)
+constexpr Vec4 operator /(float s, const Vec4 &v)
 {
 	return Vec4(s / v.x, s / v.y, s / v.z, s / v.w);
 }
@@ -127,17 +127,17 @@ inline Vec4 &operator /=(Vec4 &v, float s)
 	return v;
 }
 
-inline bool operator ==(const Vec4 &a, const Vec4 &b)
+constexpr bool operator ==(const Vec4 &a, const Vec4 &b)
 {
 	return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
 }
 
-inline bool operator !=(const Vec4 &a, const Vec4 &b)
+constexpr bool operator !=(const Vec4 &a, const Vec4 &b)
 {
 	return !(a == b);
 }
 
-inline float dot(const Vec4 &a, const Vec4 &b)
+constexpr float dot(const Vec4 &a, const Vec4 &b)
 {
 	return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
 }
@@ -166,7 +166,7 @@ inline float length(const Vec4 &v)
 	return (float)sqrt(v.x * v.x + v.y * v.y + v.z * v.z + v.w * v.w);
 }
 
-inline float length_sq(const Vec4 &v)
+constexpr float length_sq(const Vec4 &v)
 {
 	return v.x * v.x + v.y * v.y + v.z * v.z + v.w * v.w;
 }
@@ -181,7 +181,7 @@ inline Vec4 normalize(const Vec4 &v)
 	return Vec4(v.x / len, v.y / len, v.z / len, v.w / len);
 }
 
-inline Vec4 reflect(const Vec4 &v, const Vec4 &n)
+constexpr Vec4 reflect(const Vec4 &v, const Vec4 &n)
 {
 	return v - n * dot(n, v) * 2.0;
 }
@@ -207,17 +207,17 @@ inline float distance(const Vec4 &a, const Vec4 &b)
 	return length(a - b);
 }
 
-inline float distance_sq(const Vec4 &a, const Vec4 &b)
+constexpr float distance_sq(const Vec4 &a, const Vec4 &b)
 {
 	return length_sq(a - b);
 }
 
-inline Vec4 faceforward(const Vec4 &n, const Vec4 &vi, const Vec4 &ng)
+constexpr Vec4 faceforward(const Vec4 &n, const Vec4 &vi, const Vec4 &ng)
 {
 	return dot(ng, vi) < 0.0f ? n : -n;
 }
 
-inline Vec4 faceforward(const Vec4 &n, const Vec4 &vi)
+constexpr Vec4 faceforward(const Vec4 &n, const Vec4 &vi)
 {
 	return dot(n, vi) < 0.0f ? n : -n;
 }
@@ -244,12 +244,12 @@ inline int major_idx(const Vec4 &v)
 	return 3;
 }
 
-inline Vec4 proj_axis(const Vec4 &v, const Vec4 &axis)
+constexpr Vec4 proj_axis(const Vec4 &v, const Vec4 &axis)
 {
 	return axis * dot(v, axis);
 }
 
-inline Vec4 lerp(const Vec4 &a, const Vec4 &b, float t)
+constexpr Vec4 lerp(const Vec4 &a, const Vec4 &b, float t)
 {
 	return a + (b - a) * t;
 }
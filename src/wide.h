@@ -0,0 +1,312 @@
+/*
+gph-math - math library for graphics programs
+Copyright (C) 2016-2018 John Tsiombikas <nuclear@member.fsf.org>
+
+This program is free software. Feel free to use, modify, and/or redistribute
+it under the terms of the MIT/X11 license. See LICENSE for details.
+If you intend to redistribute parts of the code without the LICENSE file
+replace this paragraph with the full contents of the LICENSE file.
+*/
+#ifndef GMATH_WIDE_H_
+#define GMATH_WIDE_H_
+
+#include "config.h"
+
+#include "simd.h"
+#include "vector.h"
+#include "quat.h"
+
+/* "Wide" structure-of-arrays types, holding 4 or 8 independent values per
+ * element, and operating on all of them at once. Float4 and Float8 map
+ * directly to SIMD registers where available (see simd.h), and Vec3x4,
+ * Vec3x8 and Quatx4 are built out of them, providing the same free function
+ * vocabulary as Vec3 and Quat.
+ *
+ * Comparison operators return masks: lanes with all bits set where the
+ * comparison is true, and all bits cleared where it's false. Masks can be
+ * combined with the bitwise operators, and used with select/movemask/any/all.
+ *
+ * The lane-wise math functions are called vsqrt/vabs instead of sqrt/fabs, to
+ * avoid hiding the C math library functions inside the gph namespace.
+ */
+
+namespace gph {
+
+class GPH_MATH_API Float4 {
+public:
+#if defined(GPH_SIMD_SSE)
+	__m128 v;
+#elif defined(GPH_SIMD_NEON)
+	float32x4_t v;
+#else
+	float v[4];
+#endif
+
+	inline Float4();
+	inline Float4(float s);
+	inline Float4(float a, float b, float c, float d);
+	inline explicit Float4(const float *ptr);
+#if defined(GPH_SIMD_SSE)
+	Float4(__m128 v_) : v(v_) {}
+#elif defined(GPH_SIMD_NEON)
+	Float4(float32x4_t v_) : v(v_) {}
+#endif
+
+	inline void store(float *ptr) const;
+	inline float operator [](int idx) const;
+};
+
+class GPH_MATH_API Float8 {
+public:
+#if defined(GPH_SIMD_AVX)
+	__m256 v;
+#else
+	Float4 lo, hi;
+#endif
+
+	inline Float8();
+	inline Float8(float s);
+	inline Float8(float a, float b, float c, float d, float e, float f, float g, float h);
+	inline explicit Float8(const float *ptr);
+#if defined(GPH_SIMD_AVX)
+	Float8(__m256 v_) : v(v_) {}
+#else
+	Float8(const Float4 &lo_, const Float4 &hi_) : lo(lo_), hi(hi_) {}
+#endif
+
+	inline void store(float *ptr) const;
+	inline float operator [](int idx) const;
+};
+
+class GPH_MATH_API Vec3x4 {
+public:
+	Float4 x, y, z;
+
+	Vec3x4() {}
+	Vec3x4(const Float4 &x_, const Float4 &y_, const Float4 &z_) : x(x_), y(y_), z(z_) {}
+	// replicate v in all lanes
+	inline explicit Vec3x4(const Vec3 &v);
+	inline Vec3x4(const Vec3 &a, const Vec3 &b, const Vec3 &c, const Vec3 &d);
+	// load 4 consecutive vectors from an array
+	inline explicit Vec3x4(const Vec3 *arr);
+	// load 4 vectors spaced stride bytes apart
+	inline Vec3x4(const Vec3 *arr, int stride);
+
+	// store all lanes to 4 consecutive elements of an array
+	inline void store(Vec3 *arr) const;
+	inline Vec3 operator [](int idx) const;
+};
+
+class GPH_MATH_API Vec3x8 {
+public:
+	Float8 x, y, z;
+
+	Vec3x8() {}
+	Vec3x8(const Float8 &x_, const Float8 &y_, const Float8 &z_) : x(x_), y(y_), z(z_) {}
+	// replicate v in all lanes
+	inline explicit Vec3x8(const Vec3 &v);
+	// load 8 consecutive vectors from an array
+	inline explicit Vec3x8(const Vec3 *arr);
+	// load 8 vectors spaced stride bytes apart
+	inline Vec3x8(const Vec3 *arr, int stride);
+
+	// store all lanes to 8 consecutive elements of an array
+	inline void store(Vec3 *arr) const;
+	inline Vec3 operator [](int idx) const;
+};
+
+class GPH_MATH_API Quatx4 {
+public:
+	Float4 x, y, z, w;
+
+	Quatx4() : w(1.0f) {}
+	Quatx4(const Float4 &x_, const Float4 &y_, const Float4 &z_, const Float4 &w_)
+		: x(x_), y(y_), z(z_), w(w_) {}
+	// replicate q in all lanes
+	inline explicit Quatx4(const Quat &q);
+	// load 4 consecutive quaternions from an array
+	inline explicit Quatx4(const Quat *arr);
+
+	// store all lanes to 4 consecutive elements of an array
+	inline void store(Quat *arr) const;
+	inline Quat operator [](int idx) const;
+};
+
+// ---- Float4 functions ----
+inline GPH_MATH_API Float4 operator -(const Float4 &a);
+inline GPH_MATH_API Float4 operator +(const Float4 &a, const Float4 &b);
+inline GPH_MATH_API Float4 operator -(const Float4 &a, const Float4 &b);
+inline GPH_MATH_API Float4 operator *(const Float4 &a, const Float4 &b);
+inline GPH_MATH_API Float4 operator /(const Float4 &a, const Float4 &b);
+inline GPH_MATH_API Float4 &operator +=(Float4 &a, const Float4 &b);
+inline GPH_MATH_API Float4 &operator -=(Float4 &a, const Float4 &b);
+inline GPH_MATH_API Float4 &operator *=(Float4 &a, const Float4 &b);
+inline GPH_MATH_API Float4 &operator /=(Float4 &a, const Float4 &b);
+
+inline GPH_MATH_API Float4 operator <(const Float4 &a, const Float4 &b);
+inline GPH_MATH_API Float4 operator <=(const Float4 &a, const Float4 &b);
+inline GPH_MATH_API Float4 operator >(const Float4 &a, const Float4 &b);
+inline GPH_MATH_API Float4 operator >=(const Float4 &a, const Float4 &b);
+inline GPH_MATH_API Float4 operator ==(const Float4 &a, const Float4 &b);
+inline GPH_MATH_API Float4 operator !=(const Float4 &a, const Float4 &b);
+
+inline GPH_MATH_API Float4 operator &(const Float4 &a, const Float4 &b);
+inline GPH_MATH_API Float4 operator |(const Float4 &a, const Float4 &b);
+inline GPH_MATH_API Float4 operator ^(const Float4 &a, const Float4 &b);
+// a & ~b
+inline GPH_MATH_API Float4 andnot(const Float4 &a, const Float4 &b);
+// for each lane: mask ? a : b
+inline GPH_MATH_API Float4 select(const Float4 &mask, const Float4 &a, const Float4 &b);
+// one bit per lane, set for lanes which are set in the mask
+inline GPH_MATH_API int movemask(const Float4 &mask);
+inline GPH_MATH_API bool any(const Float4 &mask);
+inline GPH_MATH_API bool all(const Float4 &mask);
+
+inline GPH_MATH_API Float4 min(const Float4 &a, const Float4 &b);
+inline GPH_MATH_API Float4 max(const Float4 &a, const Float4 &b);
+inline GPH_MATH_API Float4 vsqrt(const Float4 &a);
+inline GPH_MATH_API Float4 vabs(const Float4 &a);
+inline GPH_MATH_API Float4 lerp(const Float4 &a, const Float4 &b, const Float4 &t);
+
+// ---- Float8 functions ----
+inline GPH_MATH_API Float8 operator -(const Float8 &a);
+inline GPH_MATH_API Float8 operator +(const Float8 &a, const Float8 &b);
+inline GPH_MATH_API Float8 operator -(const Float8 &a, const Float8 &b);
+inline GPH_MATH_API Float8 operator *(const Float8 &a, const Float8 &b);
+inline GPH_MATH_API Float8 operator /(const Float8 &a, const Float8 &b);
+inline GPH_MATH_API Float8 &operator +=(Float8 &a, const Float8 &b);
+inline GPH_MATH_API Float8 &operator -=(Float8 &a, const Float8 &b);
+inline GPH_MATH_API Float8 &operator *=(Float8 &a, const Float8 &b);
+inline GPH_MATH_API Float8 &operator /=(Float8 &a, const Float8 &b);
+
+inline GPH_MATH_API Float8 operator <(const Float8 &a, const Float8 &b);
+inline GPH_MATH_API Float8 operator <=(const Float8 &a, const Float8 &b);
+inline GPH_MATH_API Float8 operator >(const Float8 &a, const Float8 &b);
+inline GPH_MATH_API Float8 operator >=(const Float8 &a, const Float8 &b);
+inline GPH_MATH_API Float8 operator ==(const Float8 &a, const Float8 &b);
+inline GPH_MATH_API Float8 operator !=(const Float8 &a, const Float8 &b);
+
+inline GPH_MATH_API Float8 operator &(const Float8 &a, const Float8 &b);
+inline GPH_MATH_API Float8 operator |(const Float8 &a, const Float8 &b);
+inline GPH_MATH_API Float8 operator ^(const Float8 &a, const Float8 &b);
+inline GPH_MATH_API Float8 andnot(const Float8 &a, const Float8 &b);
+inline GPH_MATH_API Float8 select(const Float8 &mask, const Float8 &a, const Float8 &b);
+inline GPH_MATH_API int movemask(const Float8 &mask);
+inline GPH_MATH_API bool any(const Float8 &mask);
+inline GPH_MATH_API bool all(const Float8 &mask);
+
+inline GPH_MATH_API Float8 min(const Float8 &a, const Float8 &b);
+inline GPH_MATH_API Float8 max(const Float8 &a, const Float8 &b);
+inline GPH_MATH_API Float8 vsqrt(const Float8 &a);
+inline GPH_MATH_API Float8 vabs(const Float8 &a);
+inline GPH_MATH_API Float8 lerp(const Float8 &a, const Float8 &b, const Float8 &t);
+
+// ---- Vec3x4 functions ----
+inline GPH_MATH_API Vec3x4 operator -(const Vec3x4 &v);
+inline GPH_MATH_API Vec3x4 operator +(const Vec3x4 &a, const Vec3x4 &b);
+inline GPH_MATH_API Vec3x4 operator -(const Vec3x4 &a, const Vec3x4 &b);
+inline GPH_MATH_API Vec3x4 operator *(const Vec3x4 &a, const Vec3x4 &b);
+inline GPH_MATH_API Vec3x4 operator /(const Vec3x4 &a, const Vec3x4 &b);
+inline GPH_MATH_API Vec3x4 operator *(const Vec3x4 &v, const Float4 &s);
+inline GPH_MATH_API Vec3x4 operator *(const Float4 &s, const Vec3x4 &v);
+inline GPH_MATH_API Vec3x4 operator /(const Vec3x4 &v, const Float4 &s);
+inline GPH_MATH_API Vec3x4 &operator +=(Vec3x4 &a, const Vec3x4 &b);
+inline GPH_MATH_API Vec3x4 &operator -=(Vec3x4 &a, const Vec3x4 &b);
+inline GPH_MATH_API Vec3x4 &operator *=(Vec3x4 &a, const Vec3x4 &b);
+inline GPH_MATH_API Vec3x4 &operator /=(Vec3x4 &a, const Vec3x4 &b);
+inline GPH_MATH_API Vec3x4 &operator *=(Vec3x4 &v, const Float4 &s);
+inline GPH_MATH_API Vec3x4 &operator /=(Vec3x4 &v, const Float4 &s);
+
+inline GPH_MATH_API Vec3x4 select(const Float4 &mask, const Vec3x4 &a, const Vec3x4 &b);
+
+inline GPH_MATH_API Float4 dot(const Vec3x4 &a, const Vec3x4 &b);
+inline GPH_MATH_API Vec3x4 cross(const Vec3x4 &a, const Vec3x4 &b);
+inline GPH_MATH_API Float4 length(const Vec3x4 &v);
+inline GPH_MATH_API Float4 length_sq(const Vec3x4 &v);
+inline GPH_MATH_API Vec3x4 normalize(const Vec3x4 &v);
+
+inline GPH_MATH_API Vec3x4 reflect(const Vec3x4 &v, const Vec3x4 &n);
+inline GPH_MATH_API Vec3x4 refract(const Vec3x4 &v, const Vec3x4 &n, const Float4 &ior);
+inline GPH_MATH_API Vec3x4 refract(const Vec3x4 &v, const Vec3x4 &n, const Float4 &from_ior, const Float4 &to_ior);
+
+inline GPH_MATH_API Float4 distance(const Vec3x4 &a, const Vec3x4 &b);
+inline GPH_MATH_API Float4 distance_sq(const Vec3x4 &a, const Vec3x4 &b);
+inline GPH_MATH_API Vec3x4 faceforward(const Vec3x4 &n, const Vec3x4 &vi, const Vec3x4 &ng);
+
+inline GPH_MATH_API Vec3x4 lerp(const Vec3x4 &a, const Vec3x4 &b, const Float4 &t);
+
+// transform all lanes as points (w = 1), same as m * Vec3
+inline GPH_MATH_API Vec3x4 operator *(const Mat4 &m, const Vec3x4 &v);
+// transform all lanes as vectors (w = 0), by the upper 3x3 part of m
+inline GPH_MATH_API Vec3x4 transform_vector(const Mat4 &m, const Vec3x4 &v);
+
+// ---- Vec3x8 functions ----
+inline GPH_MATH_API Vec3x8 operator -(const Vec3x8 &v);
+inline GPH_MATH_API Vec3x8 operator +(const Vec3x8 &a, const Vec3x8 &b);
+inline GPH_MATH_API Vec3x8 operator -(const Vec3x8 &a, const Vec3x8 &b);
+inline GPH_MATH_API Vec3x8 operator *(const Vec3x8 &a, const Vec3x8 &b);
+inline GPH_MATH_API Vec3x8 operator /(const Vec3x8 &a, const Vec3x8 &b);
+inline GPH_MATH_API Vec3x8 operator *(const Vec3x8 &v, const Float8 &s);
+inline GPH_MATH_API Vec3x8 operator *(const Float8 &s, const Vec3x8 &v);
+inline GPH_MATH_API Vec3x8 operator /(const Vec3x8 &v, const Float8 &s);
+inline GPH_MATH_API Vec3x8 &operator +=(Vec3x8 &a, const Vec3x8 &b);
+inline GPH_MATH_API Vec3x8 &operator -=(Vec3x8 &a, const Vec3x8 &b);
+inline GPH_MATH_API Vec3x8 &operator *=(Vec3x8 &a, const Vec3x8 &b);
+inline GPH_MATH_API Vec3x8 &operator /=(Vec3x8 &a, const Vec3x8 &b);
+inline GPH_MATH_API Vec3x8 &operator *=(Vec3x8 &v, const Float8 &s);
+inline GPH_MATH_API Vec3x8 &operator /=(Vec3x8 &v, const Float8 &s);
+
+inline GPH_MATH_API Vec3x8 select(const Float8 &mask, const Vec3x8 &a, const Vec3x8 &b);
+
+inline GPH_MATH_API Float8 dot(const Vec3x8 &a, const Vec3x8 &b);
+inline GPH_MATH_API Vec3x8 cross(const Vec3x8 &a, const Vec3x8 &b);
+inline GPH_MATH_API Float8 length(const Vec3x8 &v);
+inline GPH_MATH_API Float8 length_sq(const Vec3x8 &v);
+inline GPH_MATH_API Vec3x8 normalize(const Vec3x8 &v);
+
+inline GPH_MATH_API Vec3x8 reflect(const Vec3x8 &v, const Vec3x8 &n);
+inline GPH_MATH_API Vec3x8 refract(const Vec3x8 &v, const Vec3x8 &n, const Float8 &ior);
+inline GPH_MATH_API Vec3x8 refract(const Vec3x8 &v, const Vec3x8 &n, const Float8 &from_ior, const Float8 &to_ior);
+
+inline GPH_MATH_API Float8 distance(const Vec3x8 &a, const Vec3x8 &b);
+inline GPH_MATH_API Float8 distance_sq(const Vec3x8 &a, const Vec3x8 &b);
+inline GPH_MATH_API Vec3x8 faceforward(const Vec3x8 &n, const Vec3x8 &vi, const Vec3x8 &ng);
+
+inline GPH_MATH_API Vec3x8 lerp(const Vec3x8 &a, const Vec3x8 &b, const Float8 &t);
+
+// transform all lanes as points (w = 1), same as m * Vec3
+inline GPH_MATH_API Vec3x8 operator *(const Mat4 &m, const Vec3x8 &v);
+// transform all lanes as vectors (w = 0), by the upper 3x3 part of m
+inline GPH_MATH_API Vec3x8 transform_vector(const Mat4 &m, const Vec3x8 &v);
+
+// ---- Quatx4 functions ----
+inline GPH_MATH_API Quatx4 operator -(const Quatx4 &q);
+inline GPH_MATH_API Quatx4 operator +(const Quatx4 &a, const Quatx4 &b);
+inline GPH_MATH_API Quatx4 operator -(const Quatx4 &a, const Quatx4 &b);
+inline GPH_MATH_API Quatx4 operator *(const Quatx4 &a, const Quatx4 &b);
+inline GPH_MATH_API Quatx4 &operator +=(Quatx4 &a, const Quatx4 &b);
+inline GPH_MATH_API Quatx4 &operator -=(Quatx4 &a, const Quatx4 &b);
+inline GPH_MATH_API Quatx4 &operator *=(Quatx4 &a, const Quatx4 &b);
+
+inline GPH_MATH_API Quatx4 select(const Float4 &mask, const Quatx4 &a, const Quatx4 &b);
+
+inline GPH_MATH_API Float4 length(const Quatx4 &q);
+inline GPH_MATH_API Float4 length_sq(const Quatx4 &q);
+inline GPH_MATH_API Quatx4 normalize(const Quatx4 &q);
+inline GPH_MATH_API Quatx4 conjugate(const Quatx4 &q);
+
+// same as the Quat versions, for each lane
+inline GPH_MATH_API Quatx4 slerp_approx(const Quatx4 &a, const Quatx4 &b, const Float4 &t);
+inline GPH_MATH_API Quatx4 nlerp(const Quatx4 &a, const Quatx4 &b, const Float4 &t);
+
+// rotate each lane of v by the corresponding unit quaternion, same as rotate_unit
+inline GPH_MATH_API Vec3x4 rotate_unit(const Vec3x4 &v, const Quatx4 &q);
+
+#include "float4.inl"
+#include "vector3x4.inl"
+#include "vector3x8.inl"
+#include "quatx4.inl"
+
+}	// namespace gph
+
+#endif	// GMATH_WIDE_H_